@@ -103,6 +103,10 @@ namespace ngcomp
     SetStoreInner (flags.GetDefineFlag ("store_inner"));
     precompute = flags.GetDefineFlag ("precompute");
     checksum = flags.GetDefineFlag ("checksum");
+    matrix_free = flags.GetDefineFlag ("matrixfree");
+    batch_assembly = flags.GetDefineFlag ("batchassembly");
+    block_assembly = flags.GetDefineFlag ("blockassembly");
+    block_sparse = flags.GetDefineFlag ("blocksparse");
     spd = flags.GetDefineFlag ("spd");
     if (spd) symmetric = true;
     SetCheckUnused (!flags.GetDefineFlagX("check_unused").IsFalse());
@@ -269,6 +273,11 @@ namespace ngcomp
   BilinearForm :: ~BilinearForm ()
   { ; }
 
+  size_t BilinearForm :: NumMatrixFreeElements () const
+  {
+    return matrixfree ? matrixfree->NumHandled() : 0;
+  }
+
   void BilinearForm :: SetPrint (bool ap)
   { 
     print = ap; 
@@ -297,6 +306,45 @@ namespace ngcomp
       low_order_bilinear_form -> SetCheckUnused (b);
   }
 
+  int BilinearForm :: BSRBlockSize () const
+  {
+    auto compound = dynamic_pointer_cast<CompoundFESpace> (fespace);
+    if (!block_sparse || fespace2 || !compound) return 1;
+
+    int bs = compound->GetNSpaces();
+    if (bs != 2 && bs != 3) return 1;
+    const FESpace & space0 = *(*compound)[0];
+    size_t n = space0.GetNDof();
+    for (int k = 1; k < bs; k++)
+      if (typeid(*(*compound)[k]) != typeid(space0) || (*compound)[k]->GetNDof() != n)
+        return 1;
+
+    // element dofs of component k must be those of component 0, shifted by k*n
+    atomic<bool> equal(true);
+    for (VorB vb : { VOL, BND })
+      ParallelForRange (ma->GetNE(vb), [&] (IntRange r)
+                        {
+                          Array<DofId> dnums, dnums0;
+                          for (auto nr : r)
+                            {
+                              ElementId ei(vb, nr);
+                              if (!fespace->DefinedOn(ei)) continue;
+                              fespace->GetDofNrs (ei, dnums);
+                              space0.GetDofNrs (ei, dnums0);
+                              if (dnums.Size() != bs*dnums0.Size())
+                                { equal = false; return; }
+                              for (int k = 0; k < bs; k++)
+                                for (size_t j = 0; j < dnums0.Size(); j++)
+                                  {
+                                    DofId d0 = dnums0[j], d = dnums[k*dnums0.Size()+j];
+                                    if (IsRegularDof(d0) ? (d != d0 + DofId(k*n)) : IsRegularDof(d))
+                                      { equal = false; return; }
+                                  }
+                            }
+                        });
+    return equal ? bs : 1;
+  }
+
   void BilinearForm :: SetPreconditioner (Preconditioner * pre)
   {
     // cout << "SetPreconditioner, type fes = " << typeid(*fespace).name() << ", type pre = " << typeid(*pre).name() << endl;
@@ -544,6 +592,9 @@ namespace ngcomp
     if (nonassemble)
       {
         mats.Append (make_shared<BilinearFormApplication> (shared_ptr<BilinearForm>(this, NOOP_Deleter))); 
+
+        if (matrix_free && !MixedSpaces())
+          matrixfree = make_shared<MatrixFreeOperator> (fespace, VB_parts[VOL], lh);
       
         if (precompute)
           {
@@ -687,6 +738,9 @@ namespace ngcomp
   {
     if (nonassemble)
       {
+        // coefficients may have changed
+        if (matrixfree && mats.Size() == ma->GetNLevels())
+          matrixfree = make_shared<MatrixFreeOperator> (fespace, VB_parts[VOL], lh);
         Assemble(lh);
         return;
       }
@@ -848,6 +902,7 @@ namespace ngcomp
     RegionTimer reg (mattimer);
 
     timestamp = ++global_timestamp;
+    block_interface = nullptr;
     
     mattimer_checkintegrators.Start();
     // check if integrators fit to space
@@ -1015,13 +1070,27 @@ namespace ngcomp
                           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
                       }
                     */
-                    IterateElements
+                    BitArray batched;
+                    if (vb == VOL && batch_assembly && !printelmat && !elmat_ev &&
+                        !eliminate_internal && !eliminate_hidden)
+                      AssembleBatched (batched, useddof, clh);
+                    if (vb == VOL)
+                      num_batched = batched.Size() ? batched.NumSet() : 0;
+
+                    // preconditioners and the condensed rhs rely on the coloring
+                    bool blocked = block_assembly && !preconditioners.Size() && !printelmat && !elmat_ev &&
+                      !(linearform && eliminate_internal && !keep_internal);
+                    if (blocked)
+                      block_interface = &fespace->BlockInterfaceElements(vb);
+                    
+                    (blocked ? IterateElementsBlocked : IterateElements)
                       (*fespace, vb, clh,  [&] (FESpace::Element el, LocalHeap & lh)
                        {
                          if (elmat_ev && vb == VOL) 
                            *testout << " Assemble Element " << el.Nr() << endl;  
                          
                          progress.Update ();
+                         if (batched.Size() && batched.Test(el.Nr())) return;
 			 
                          const FiniteElement & fel = fespace->GetFE (el, lh);
                          const ElementTransformation & eltrans = ma->GetTrafo (el, lh);
@@ -1473,6 +1542,7 @@ namespace ngcomp
                            }
                          // timer3_VB[vb].Stop();
                        });
+                    block_interface = nullptr;
                     progress.Done();
                     
                     /*
@@ -2396,6 +2466,159 @@ namespace ngcomp
     
   }
 
+
+  template <class SCAL>
+  void S_BilinearForm<SCAL> ::
+  AssembleBatched (BitArray & batched, FlatArray<bool> useddof, LocalHeap & clh)
+  {
+    static Timer t("Matrix assembling batched");
+    RegionTimer reg(t);
+
+    // low order elements have few integration points, so instead of the points
+    // the SIMD lanes run over elements with the same reference element
+    constexpr size_t simdw = SIMD<double>::Size();
+
+    size_t ne = ma->GetNE(VOL);
+    batched.SetSize (ne);
+    batched.Clear();
+
+    Array<SymbolicBilinearFormIntegrator*> bfis;
+    for (auto & bfi : VB_parts[VOL])
+      {
+        auto sbfi = dynamic_cast<SymbolicBilinearFormIntegrator*> (bfi.get());
+        if (!sbfi || !sbfi->SupportsBatch() || !sbfi->SimdEvaluate() || sbfi->GetDeformation())
+          return;
+        bfis.Append (sbfi);
+      }
+    // elements with equal order, dof count and vertex ordering must share their shape functions
+    if (fespace->VarOrder() || dynamic_pointer_cast<CompoundFESpace> (fespace))
+      return;
+
+    // (index, element type, vertex ordering), (ndof, order)
+    Array<INT<2,size_t>> keys(ne);
+    ParallelForRange
+      (ne, [&] (IntRange r)
+       {
+         LocalHeap lh = clh.Split();
+         for (auto i : r)
+           {
+             HeapReset hr(lh);
+             ElementId ei(VOL, i);
+             keys[i] = INT<2,size_t> (size_t(-1));
+
+             int index = ma->GetElIndex (ei);
+             if (!fespace->DefinedOn (VOL, index)) continue;
+             auto & fel = fespace->GetFE (ei, lh);
+
+             // with more integration points the element-wise SIMD evaluation is as good
+             bool has_integrator = false, batchable = true;
+             for (auto bfi : bfis)
+               if (bfi->DefinedOn (index))
+                 {
+                   has_integrator = true;
+                   if (!bfi->DefinedOnElement (i) ||
+                       bfi->GetIntegrationRule (fel, lh).Size() > 2*simdw)
+                     batchable = false;
+                 }
+             if (!has_integrator || !batchable) continue;
+
+             auto vnums = ma->GetElVertices (ei);
+             size_t vkey = 0;
+             for (size_t j = vnums.Size(); j-- > 0; )
+               {
+                 int rank = 0;
+                 for (size_t k = 0; k < vnums.Size(); k++)
+                   if (vnums[k] < vnums[j]) rank++;
+                 vkey = 8*vkey + rank;
+               }
+             keys[i][0] = (size_t(index) << 32) + (size_t(fel.ElementType()) << 24) + vkey;
+             keys[i][1] = (size_t(fel.GetNDof()) << 16) + fel.Order();
+           }
+       });
+
+    atomic<bool> nosimd(false);
+    for (FlatArray<int> els_of_col : fespace->ElementColoring(VOL))
+      {
+        Array<int> els;
+        for (int el : els_of_col)
+          if (keys[el][0] != size_t(-1))
+            els.Append (el);
+        QuickSort (els, [&] (int a, int b)
+                   {
+                     return keys[a][0] < keys[b][0] ||
+                       (keys[a][0] == keys[b][0] && keys[a][1] < keys[b][1]);
+                   });
+
+        Array<size_t> first_batch;
+        for (size_t i = 0; i < els.Size(); )
+          {
+            first_batch.Append (i);
+            size_t j = i+1;
+            while (j < els.Size() && j-i < simdw && keys[els[j]] == keys[els[i]]) j++;
+            i = j;
+          }
+        first_batch.Append (els.Size());
+
+        // elements of one colour share no dofs, batches run in parallel
+        ParallelForRange
+          (first_batch.Size()-1, [&] (IntRange r)
+           {
+             LocalHeap lh = clh.Split();
+             Array<DofId> dnums;
+             for (auto b : r)
+               {
+                 auto bels = els.Range (first_batch[b], first_batch[b+1]);
+                 if (bels.Size() < 2 || nosimd) continue;
+                 HeapReset hr(lh);
+
+                 ElementId ei0(VOL, bels[0]);
+                 int index = ma->GetElIndex (ei0);
+                 auto & fel = fespace->GetFE (ei0, lh);
+                 FlatArray<const ElementTransformation*> trafos(bels.Size(), lh);
+                 for (size_t l = 0; l < bels.Size(); l++)
+                   trafos[l] = &ma->GetTrafo (ElementId(VOL, bels[l]), lh);
+
+                 size_t nd = fel.GetNDof();
+                 FlatMatrix<SIMD<double>> elmats(nd, nd, lh);
+                 elmats = SIMD<double>(0.0);
+                 try
+                   {
+                     for (auto bfi : bfis)
+                       if (bfi->DefinedOn (index))
+                         bfi->CalcElementMatrixAddBatch (fel, trafos, elmats, lh);
+                   }
+                 catch (ExceptionNOSIMD & e)
+                   {
+                     // the element loop takes over
+                     nosimd = true;
+                     continue;
+                   }
+
+                 FlatMatrix<SCAL> elmat(nd, lh);
+                 for (size_t l = 0; l < bels.Size(); l++)
+                   {
+                     ElementId ei(VOL, bels[l]);
+                     fespace->GetDofNrs (ei, dnums);
+                     for (size_t i = 0; i < nd; i++)
+                       for (size_t j = 0; j < nd; j++)
+                         elmat(i,j) = elmats(i,j)[l];
+
+                     fespace->TransformMat (ei, elmat, TRANSFORM_MAT_LEFT_RIGHT);
+                     AddElementMatrix (dnums, dnums, elmat, ei, lh);
+                     for (auto pre : preconditioners)
+                       pre -> AddElementMatrix (dnums, elmat, ei, lh);
+
+                     if (check_unused)
+                       for (auto d : dnums)
+                         if (IsRegularDof(d)) useddof[d] = true;
+                     batched.Set (bels[l]);
+                   }
+               }
+           });
+      }
+  }
+
+
   
   template <class SCAL>
   void S_BilinearForm<SCAL> :: 
@@ -3597,12 +3820,17 @@ namespace ngcomp
           if (VB_parts[vb].Size())
             {
               RegionTimer reg (timervb[vb]);
+
+              auto sumfact = (vb == VOL) ? matrixfree : nullptr;
+              if (sumfact)
+                sumfact->MultAdd (val, x, y, clh);
               
               IterateElements 
                 (*fespace, vb, clh, 
                  [&] (FESpace::Element el, LocalHeap & lh)
                  {
                    // ThreadRegionTimer reg (timer_loop, TaskManager::GetThreadId());                   
+                   if (sumfact && sumfact->Handles (el.Nr())) return;
                    auto & fel = el.GetFE();
                    auto & trafo = el.GetTrafo();
                    auto dnums = el.GetDofs();
@@ -4508,11 +4736,24 @@ namespace ngcomp
 
     MatrixGraph * graph = this->GetGraph (this->ma->GetNLevels()-1, false);
 
-    auto spmat = make_shared<SparseMatrix<TM,TV,TV>> (*graph, 1);
-    mymatrix = spmat.get();
-    
-    if (this->spd) spmat->SetSPD();
-    shared_ptr<BaseMatrix> mat = spmat;
+    shared_ptr<BaseMatrix> mat;
+    this->bsrmatrix = nullptr;
+    int bs = (is_same<TM,double>::value && is_same<TV,double>::value) ? this->BSRBlockSize() : 1;
+    auto bsr = (bs > 1) ? BaseBSRMatrix::Create (*graph, bs, false) : nullptr;
+    if (bsr)
+      {
+        this->bsrmatrix = bsr.get();
+        mymatrix = nullptr;
+        if (this->spd) bsr->SetSPD();
+        mat = bsr;
+      }
+    else
+      {
+        auto spmat = make_shared<SparseMatrix<TM,TV,TV>> (*graph, 1);
+        mymatrix = spmat.get();
+        if (this->spd) spmat->SetSPD();
+        mat = spmat;
+      }
 
 
 #ifdef PARALLEL
@@ -4588,6 +4829,23 @@ namespace ngcomp
   {
     dest += source(start1, start2);
   }
+
+  // block storage is only created for real forms
+  template <typename TSCAL>
+  inline void AddBSRElementMatrix (BaseBSRMatrix & mat,
+                                   FlatArray<int> dnums1, FlatArray<int> dnums2,
+                                   BareSliceMatrix<TSCAL> elmat, bool use_atomic)
+  {
+    throw Exception ("BSRMatrix supports real forms only");
+  }
+
+  template <>
+  inline void AddBSRElementMatrix (BaseBSRMatrix & mat,
+                                   FlatArray<int> dnums1, FlatArray<int> dnums2,
+                                   BareSliceMatrix<double> elmat, bool use_atomic)
+  {
+    mat.AddElementMatrix (dnums1, dnums2, elmat, use_atomic);
+  }
     
   
   template <class TM, class TV>
@@ -4598,7 +4856,10 @@ namespace ngcomp
                     ElementId id,
                     LocalHeap & lh) 
   {
-    mymatrix -> TMATRIX::AddElementMatrix (dnums1, dnums2, elmat, this->fespace->HasAtomicDofs());
+    if (this->bsrmatrix)
+      AddBSRElementMatrix (*this->bsrmatrix, dnums1, dnums2, elmat, this->AtomicScatter(id));
+    else
+      mymatrix -> TMATRIX::AddElementMatrix (dnums1, dnums2, elmat, this->AtomicScatter(id));
   }
 
 
@@ -4644,13 +4905,32 @@ namespace ngcomp
     if (this->mats.Size() == this->ma->GetNLevels())
       return;
 
-    MatrixGraph * graph = this->GetGraph (this->ma->GetNLevels()-1, true);
+    // block storage keeps the full pattern
+    this->bsrmatrix = nullptr;
+    int bs = (is_same<TM,double>::value && is_same<TV,double>::value) ? this->BSRBlockSize() : 1;
+    MatrixGraph * graph = this->GetGraph (this->ma->GetNLevels()-1, bs == 1);
 
-    auto spmat = make_shared<SparseMatrixSymmetric<TM,TV>> (*graph, 1);
-    mymatrix = spmat.get();
-    
-    if (this->spd) spmat->SetSPD();
-    shared_ptr<BaseMatrix> mat = spmat;
+    shared_ptr<BaseMatrix> mat;
+    auto bsr = (bs > 1) ? BaseBSRMatrix::Create (*graph, bs, true) : nullptr;
+    if (bsr)
+      {
+        this->bsrmatrix = bsr.get();
+        mymatrix = nullptr;
+        if (this->spd) bsr->SetSPD();
+        mat = bsr;
+      }
+    else
+      {
+        if (bs > 1)
+          {
+            delete graph;
+            graph = this->GetGraph (this->ma->GetNLevels()-1, true);
+          }
+        auto spmat = make_shared<SparseMatrixSymmetric<TM,TV>> (*graph, 1);
+        mymatrix = spmat.get();
+        if (this->spd) spmat->SetSPD();
+        mat = spmat;
+      }
 
 #ifdef PARALLEL
     if ( this->GetFESpace()->IsParallel() )
@@ -4708,7 +4988,10 @@ namespace ngcomp
                     ElementId id, 
                     LocalHeap & lh) 
   {
-    mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->fespace->HasAtomicDofs());
+    if (this->bsrmatrix)
+      AddBSRElementMatrix (*this->bsrmatrix, dnums1, dnums1, elmat, this->AtomicScatter(id));
+    else
+      mymatrix -> TMATRIX::AddElementMatrixSymmetric (dnums1, elmat, this->AtomicScatter(id));
   }
 
 
@@ -12,6 +12,7 @@ namespace ngcomp
 
   class LinearForm;
   class Preconditioner;
+  class MatrixFreeOperator;
 
   /** 
       A bilinear-form.
@@ -103,6 +104,29 @@ namespace ngcomp
     Array<void*> precomputed_data;
     /// output of norm of matrix entries
     bool checksum;
+    /// sum-factorized application of volume terms (with nonassemble)
+    bool matrix_free = false;
+    /// geometry and coefficients at integration points, set up in Assemble
+    shared_ptr<MatrixFreeOperator> matrixfree;
+    /// computes element matrices of several volume elements at once, one per SIMD lane
+    bool batch_assembly = false;
+    /// number of volume elements assembled in batches by the last Assemble
+    size_t num_batched = 0;
+    /// element loop over spatial blocks without coloring, with atomic scatter at block interfaces
+    bool block_assembly = false;
+    /// interface elements of the block loop currently running
+    const BitArray * block_interface = nullptr;
+    /// block sparse storage for compound spaces of equal components
+    bool block_sparse = false;
+    /// the block matrix of the finest level, if block storage is used
+    BaseBSRMatrix * bsrmatrix = nullptr;
+
+    /// number of equal components to be stored in blocks, 1 if not possible
+    int BSRBlockSize () const;
+
+    /// element matrix may meet concurrent writes to the same rows
+    bool AtomicScatter (ElementId ei) const
+    { return fespace->HasAtomicDofs() || (block_interface && block_interface->Test(ei.Nr())); }
 
   public:
     /// generate a bilinear-form
@@ -270,6 +294,12 @@ namespace ngcomp
     }
 
 
+    /// number of volume elements applied by the sum-factorized kernel (matrixfree)
+    size_t NumMatrixFreeElements () const;
+
+    /// number of volume elements assembled in batches (batchassembly)
+    size_t NumBatchedElements () const { return num_batched; }
+
     /// use static condensation ?
     bool UsesEliminateInternal () const { return eliminate_internal; }
 
@@ -509,6 +539,8 @@ namespace ngcomp
 
     ///
     virtual void DoAssemble (LocalHeap & lh);
+    /// volume element matrices by batches of elements, marks the elements done
+    void AssembleBatched (BitArray & batched, FlatArray<bool> useddof, LocalHeap & lh);
     ///
     // virtual void DoAssembleIndependent (BitArray & useddof, LocalHeap & lh);
     ///
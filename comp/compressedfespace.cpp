@@ -112,4 +112,177 @@ namespace ngcomp
 
 
 
+  ReorderedFESpace::ReorderedFESpace (shared_ptr<FESpace> bfes, string amethod)
+    : CompressedFESpace(bfes), method(amethod)
+  {
+    if (method != "rcm" && method != "sfc")
+      throw Exception ("ReorderedFESpace: unknown method '" + method + "', use 'rcm' or 'sfc'");
+    type = "reordered-" + space->type;
+  }
+
+  void ReorderedFESpace::Update(LocalHeap & lh)
+  {
+    // identity until FinalizeUpdate, base space may still change its dofs
+    size_t ndof = space->GetNDof();
+    all2comp.SetSize(ndof);
+    comp2all.SetSize(ndof);
+    ctofdof.SetSize(ndof);
+    for (size_t i : Range(ndof))
+      {
+        all2comp[i] = comp2all[i] = i;
+        ctofdof[i] = space->GetDofCouplingType(i);
+      }
+    SetNDof(ndof);
+  }
+
+  
+  // reverse Cuthill-McKee ordering of the dofs, returns dofs in new order
+  static Array<DofId> ReverseCuthillMcKee (const FESpace & fes)
+  {
+    size_t ndof = fes.GetNDof();
+    auto ma = fes.GetMeshAccess();
+    size_t nel = ma->GetNE(VOL) + ma->GetNE(BND);
+    auto elid = [&] (size_t i)
+      { return (i < ma->GetNE(VOL)) ? ElementId(VOL, i) : ElementId(BND, i-ma->GetNE(VOL)); };
+
+    Array<DofId> dnums;
+    TableCreator<int> creator(nel), creatorT(ndof);
+    for ( ; !creator.Done(); creator++, creatorT++)
+      for (size_t i : Range(nel))
+        {
+          fes.GetDofNrs (elid(i), dnums);
+          for (auto d : dnums)
+            if (IsRegularDof(d))
+              {
+                creator.Add (i, d);
+                creatorT.Add (d, i);
+              }
+        }
+    Table<int> el2dof = creator.MoveTable();
+    Table<int> dof2el = creatorT.MoveTable();
+
+    // neighbours are visited once per call, using a stamp per dof
+    Array<size_t> stamp(ndof);
+    stamp = 0;
+    size_t curstamp = 0;
+    auto IterateNeighbours = [&] (DofId d, auto func)
+      {
+        curstamp++;
+        stamp[d] = curstamp;
+        for (auto el : dof2el[d])
+          for (auto d2 : el2dof[el])
+            if (stamp[d2] != curstamp)
+              {
+                stamp[d2] = curstamp;
+                func (d2);
+              }
+      };
+    
+    Array<int> degree(ndof);
+    for (size_t d : Range(ndof))
+      {
+        degree[d] = 0;
+        IterateNeighbours (d, [&] (DofId) { degree[d]++; });
+      }
+    
+    // start from the last dof found by a breadth-first search
+    Array<size_t> seen(ndof);
+    seen = 0;
+    size_t curseen = 0;
+    Array<DofId> queue;
+    auto Farthest = [&] (DofId start)
+      {
+        curseen++;
+        queue.SetSize0();
+        queue.Append (start);
+        seen[start] = curseen;
+        for (size_t i = 0; i < queue.Size(); i++)
+          IterateNeighbours (queue[i], [&] (DofId d2)
+                             {
+                               if (seen[d2] == curseen) return;
+                               seen[d2] = curseen;
+                               queue.Append (d2);
+                             });
+        return queue.Last();
+      };
+
+    Array<DofId> order;
+    order.SetAllocSize (ndof);
+    Array<bool> numbered(ndof);
+    numbered = false;
+    Array<DofId> nb;
+    for (size_t d : Range(ndof))
+      {
+        if (numbered[d]) continue;
+        DofId start = Farthest (Farthest (d));
+        
+        size_t first = order.Size();
+        order.Append (start);
+        numbered[start] = true;
+        for (size_t i = first; i < order.Size(); i++)
+          {
+            nb.SetSize0();
+            IterateNeighbours (order[i], [&] (DofId d2)
+                               {
+                                 if (numbered[d2]) return;
+                                 numbered[d2] = true;
+                                 nb.Append (d2);
+                               });
+            QuickSort (nb, [&] (DofId a, DofId b) { return degree[a] < degree[b]; });
+            order += nb;
+          }
+      }
+
+    for (size_t i = 0; i < ndof/2; i++)
+      swap (order[i], order[ndof-1-i]);
+    return order;
+  }
+
+
+  // dofs in order of appearance along the space-filling curve
+  static Array<DofId> SpaceFillingCurveOrder (const FESpace & fes)
+  {
+    size_t ndof = fes.GetNDof();
+    Array<DofId> order;
+    order.SetAllocSize (ndof);
+    Array<bool> numbered(ndof);
+    numbered = false;
+    Array<DofId> dnums;
+    for (VorB vb : { VOL, BND })
+      for (auto block : fes.ElementBlocks(vb))
+        for (auto elnr : block)
+          {
+            fes.GetDofNrs (ElementId(vb, elnr), dnums);
+            for (auto d : dnums)
+              if (IsRegularDof(d) && !numbered[d])
+                {
+                  numbered[d] = true;
+                  order.Append (d);
+                }
+          }
+    for (size_t d : Range(ndof))
+      if (!numbered[d])
+        order.Append (d);
+    return order;
+  }
+
+  
+  void ReorderedFESpace::FinalizeUpdate(LocalHeap & lh)
+  {
+    static Timer t("ReorderedFESpace::FinalizeUpdate - renumbering");
+    space->FinalizeUpdate (lh);
+
+    {
+      RegionTimer reg(t);
+      comp2all = (method == "sfc") ? SpaceFillingCurveOrder (*space) : ReverseCuthillMcKee (*space);
+      for (size_t i : Range(comp2all))
+        {
+          all2comp[comp2all[i]] = i;
+          ctofdof[i] = space->GetDofCouplingType(comp2all[i]);
+        }
+    }
+    
+    FESpace::FinalizeUpdate (lh);
+  }
+
 }
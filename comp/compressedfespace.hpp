@@ -100,4 +100,29 @@ namespace ngcomp
 
   };
 
+
+  /**
+     Wrapper space with the dofs of the base space renumbered for locality.
+     The renumbering is computed in FinalizeUpdate:
+       "rcm" ... reverse Cuthill-McKee on the graph of dofs coupled by elements
+       "sfc" ... dofs numbered as they appear along the space-filling curve
+                 of FESpace::ElementBlocks
+  */
+  class ReorderedFESpace : public CompressedFESpace
+  {
+    string method;
+  public:
+    ReorderedFESpace (shared_ptr<FESpace> bfes, string amethod = "rcm");
+
+    virtual void Update(LocalHeap & lh) override;
+    virtual void FinalizeUpdate(LocalHeap & lh) override;
+
+    const string & GetMethod() const { return method; }
+
+    virtual string GetClassName () const override
+    {
+      return "ReorderedFESpace(" + space->GetClassName() + ")";
+    }
+  };
+
 }
@@ -707,8 +707,13 @@ lot of new non-zero entries in the matrix!\n" << endl;
       }
       }
     
-    // invalidate facet_coloring
+    // invalidate facet_coloring and element blocks
     facet_coloring = Table<int>();
+    for (auto vb : { VOL, BND, BBND, BBBND })
+      {
+        element_blocks[vb] = Table<int>();
+        block_interface[vb].SetSize(0);
+      }
        
     level_updated = ma->GetNLevels();
     if (timing) Timing();
@@ -806,6 +811,120 @@ lot of new non-zero entries in the matrix!\n" << endl;
 
     return facet_coloring;
   }
+
+
+  const Table<int> & FESpace :: ElementBlocks (VorB vb) const
+  {
+    if (element_blocks[vb].Size()) return element_blocks[vb];
+
+    static Timer t("FESpace::ElementBlocks"); RegionTimer reg(t);
+    
+    // element centers, and number of dofs as estimate for the memory touched
+    Array<int> els;
+    Array<Vec<3>> centers;
+    Array<int> eldofs;
+    Vec<3> pmin(1e99), pmax(-1e99);
+    for (auto el : Elements(vb))
+      {
+        Vec<3> center = 0.0;
+        auto vnums = el.Vertices();
+        for (auto v : vnums)
+          center += ma->GetPoint<3>(v);
+        center *= 1.0/vnums.Size();
+        for (int j = 0; j < 3; j++)
+          {
+            pmin(j) = min(pmin(j), center(j));
+            pmax(j) = max(pmax(j), center(j));
+          }
+        els.Append (el.Nr());
+        centers.Append (center);
+        eldofs.Append (el.GetDofs().Size());
+      }
+
+    // sort along Morton curve
+    auto spread = [] (uint64_t x)   // 21 bits, two zero bits between each
+      {
+        x &= 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffffull;
+        x = (x | x << 16) & 0x1f0000ff0000ffull;
+        x = (x | x << 8)  & 0x100f00f00f00f00full;
+        x = (x | x << 4)  & 0x10c30c30c30c30c3ull;
+        x = (x | x << 2)  & 0x1249249249249249ull;
+        return x;
+      };
+    
+    Array<uint64_t> keys(els.Size());
+    Array<int> index(els.Size());
+    for (auto i : Range(els))
+      {
+        uint64_t key = 0;
+        for (int j = 0; j < 3; j++)
+          {
+            double rel = (pmax(j) > pmin(j)) ? (centers[i](j)-pmin(j)) / (pmax(j)-pmin(j)) : 0;
+            key |= spread (uint64_t(rel * 0x1fffff)) << j;
+          }
+        keys[i] = key;
+        index[i] = i;
+      }
+    QuickSortI (keys, index);
+
+    // cut blocks touching about 1000 dofs, at least 4 blocks per thread
+    size_t maxels = max (size_t(1), els.Size() / (4*TaskManager::GetNumThreads()));
+    Array<int> cnt;
+    for (size_t i = 0; i < els.Size(); )
+      {
+        size_t first = i, ndofs = 0;
+        while (i < els.Size() && i-first < maxels && ndofs < 1024)
+          ndofs += eldofs[index[i++]];
+        cnt.Append (i-first);
+      }
+
+    Table<int> blocks(cnt);
+    for (size_t b = 0, i = 0; b < blocks.Size(); b++)
+      for (auto & elnr : blocks[b])
+        elnr = els[index[i++]];
+
+    // dofs used by more than one block need atomic scatter
+    Array<int> dofblock(GetNDof());
+    dofblock = -1;
+    BitArray shared(GetNDof());
+    shared.Clear();
+    Array<DofId> dofs;
+    for (auto b : Range(blocks))
+      for (auto elnr : blocks[b])
+        {
+          GetDofNrs (ElementId(vb, elnr), dofs);
+          for (auto d : dofs)
+            if (IsRegularDof(d))
+              {
+                if (dofblock[d] == -1)
+                  dofblock[d] = b;
+                else if (dofblock[d] != b)
+                  shared.Set(d);
+              }
+        }
+
+    BitArray & ifels = const_cast<BitArray&> (block_interface[vb]);
+    ifels.SetSize (ma->GetNE(vb));
+    ifels.Clear();
+    for (auto elnr : els)
+      {
+        GetDofNrs (ElementId(vb, elnr), dofs);
+        for (auto d : dofs)
+          if (IsRegularDof(d) && shared.Test(d))
+            {
+              ifels.Set(elnr);
+              break;
+            }
+      }
+
+    if (print)
+      *testout << blocks.Size() << " element blocks for " << ToString(vb) 
+               << ", " << ifels.NumSet() << " interface elements" << endl;
+
+    const_cast<Table<int>&> (element_blocks[vb]) = move(blocks);
+    return element_blocks[vb];
+  }
   
 
   // FiniteElement & FESpace :: GetFE (ElementId ei, Allocator & alloc) const
@@ -1549,6 +1668,33 @@ lot of new non-zero entries in the matrix!\n" << endl;
         throw Exception (*ex);
       }
   }
+
+
+  void IterateElementsBlocked (const FESpace & fes, 
+                               VorB vb, 
+                               LocalHeap & clh, 
+                               const function<void(FESpace::Element,LocalHeap&)> & func)
+  {
+    const Table<int> & blocks = fes.ElementBlocks(vb);
+    SharedLoop2 sl(Range(blocks));
+
+    ParallelJob
+      ( [&] (const TaskInfo & ti) 
+        {
+          LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+          ArrayMem<int,100> temp_dnums;
+          
+          for (int mynr : sl)
+            for (int elnr : blocks[mynr])
+              {
+                HeapReset hr(lh);
+                FESpace::Element el(fes, ElementId (vb, elnr), temp_dnums, lh);
+                func (move(el), lh);
+              }
+
+          ProgressOutput::SumUpLocal();
+        } );
+  }
   
   /*
   // Aendern, Bremse!!!
@@ -183,6 +183,8 @@ ANY                  1 1 1 1 | 15
     
     Table<int> element_coloring[4]; 
     Table<int> facet_coloring;  // elements on facet in own colors (DG)
+    Table<int> element_blocks[4];  // spatially compact element blocks 
+    BitArray block_interface[4];   // elements sharing dofs with other blocks
     Array<COUPLING_TYPE> ctofdof;
 
     shared_ptr<ParallelDofs> paralleldofs;
@@ -244,6 +246,12 @@ ANY                  1 1 1 1 | 15
     { return element_coloring[vb]; }
 
     const Table<int> & FacetColoring() const;
+
+    /// elements sorted along a space-filling curve, cut into cache-sized blocks
+    const Table<int> & ElementBlocks(VorB vb = VOL) const;
+    /// elements having a dof in common with an element of another block
+    const BitArray & BlockInterfaceElements(VorB vb = VOL) const
+    { ElementBlocks(vb); return block_interface[vb]; }
     
     /// print report to stream
     virtual void PrintReport (ostream & ost) const override;
@@ -839,6 +847,12 @@ ANY                  1 1 1 1 | 15
 			       VorB vb, 
 			       LocalHeap & clh, 
 			       const function<void(FESpace::Element,LocalHeap&)> & func);
+
+  /// iterates over FESpace::ElementBlocks without colors, blocks are processed by one thread
+  extern NGS_DLL_HEADER void IterateElementsBlocked (const FESpace & fes,
+                                                     VorB vb, 
+                                                     LocalHeap & clh, 
+                                                     const function<void(FESpace::Element,LocalHeap&)> & func);
   /*
   template <typename TFUNC>
   inline void IterateElements (const FESpace & fes, 
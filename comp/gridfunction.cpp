@@ -4,6 +4,13 @@
 #include <parallelngs.hpp>
 #include <stdlib.h>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace ngcomp; 
 
 
@@ -108,6 +115,18 @@ namespace ngcomp
           archive & fv(i);
 	*/
 
+        if (dynamic_cast<CheckpointArchive*> (&archive))
+          {
+            // checkpoints keep all coefficients, written as one bulk array
+            size_t n = fv.Size();
+            archive & n;
+            if (n != fv.Size())
+              throw Exception ("GridFunction::DoArchive: checkpoint has "+ToString(n)
+                               +" coefficients, but gridfunction "+ToString(fv.Size()));
+            archive.Do (fv.Data(), n);
+            continue;
+          }
+
 	if (archive.Output())
 	  {
 	    Array<DofId> dnums;
@@ -780,6 +799,380 @@ namespace ngcomp
 
 
 
+  /*
+    File format of SaveChunked:
+
+    header | node map | values (page aligned)
+
+    The node map is the global dof map: for every node the node type,
+    the sorted global vertex numbers, and the position of its values.
+    Nodes are stored by ranks, and within a rank in local order.
+  */
+  struct ChunkedGFHeader
+  {
+    char magic[8];        // "NGSGFCHK"
+    uint32_t version;
+    uint32_t scalar_size;
+    uint32_t dim;
+    uint32_t ntasks;      // number of ranks which wrote the file
+    uint64_t nnodes;
+    uint64_t nvalues;
+    uint64_t nodes_offset;
+    uint64_t values_offset;
+  };
+
+  struct ChunkedGFNode
+  {
+    int32_t type;
+    int32_t nvalues;
+    int32_t vertices[8];  // sorted, filled up with -1
+    uint64_t first;       // position of first value
+  };
+
+  static const char chunked_gf_magic[8] = { 'N','G','S','G','F','C','H','K' };
+
+  // nodes with dofs, for saving only the master nodes
+  static void CollectChunkedNodes (const MeshAccess & ma, const FESpace & fes,
+                                   bool only_master, Array<ChunkedGFNode> & nodes,
+                                   Array<NodeId> & ids)
+  {
+    static Timer t("GridFunction::CollectChunkedNodes"); RegionTimer reg(t);
+    bool global = MyMPI_GetNTasks() > 1;
+    int dim = fes.GetDimension();
+#ifdef PARALLEL
+    auto par = fes.GetParallelDofs();
+#endif
+
+    nodes.SetSize0();
+    ids.SetSize0();
+    for (NODE_TYPE nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
+      {
+        size_t nnodes = ma.GetNNodes (nt);
+        Array<int> nvalues(nnodes);
+        ParallelFor (nnodes, [&] (size_t i)
+                     {
+                       Array<DofId> dnums;
+                       fes.GetDofNrs (NodeId(nt, i), dnums);
+                       nvalues[i] = dnums.Size()*dim;
+#ifdef PARALLEL
+                       if (dnums.Size() && only_master && par && !par->IsMasterDof (dnums[0]))
+                         nvalues[i] = 0;
+#endif
+                     });
+
+        size_t first = nodes.Size();
+        for (size_t i = 0; i < nnodes; i++)
+          if (nvalues[i])
+            {
+              ids.Append (NodeId(nt, i));
+              ChunkedGFNode node;
+              node.type = nt;
+              node.nvalues = nvalues[i];
+              nodes.Append (node);
+            }
+
+        ParallelFor (IntRange(first, nodes.Size()), [&] (size_t i)
+                     {
+                       int pnums[8];
+                       int n = 0;
+                       auto add = [&] (const auto & pn)
+                         {
+                           for (auto p : pn)
+                             if (p >= 0 && n < 8) pnums[n++] = p;
+                         };
+                       size_t nr = ids[i].GetNr();
+                       switch (nt)
+                         {
+                         case NT_VERTEX: pnums[n++] = nr; break;
+                         case NT_EDGE: add (ma.GetEdgePNums (nr)); break;
+                         case NT_FACE: add (ma.GetFacePNums (nr)); break;
+                         case NT_CELL: add (ma.GetElVertices (ElementId(VOL,nr))); break;
+                         default:
+                           __assume(false);
+                         }
+                       if (global)
+                         for (int j = 0; j < n; j++)
+                           pnums[j] = ma.GetGlobalNodeNum (NodeId(NT_VERTEX, pnums[j]));
+                       std::sort (pnums, pnums+n);
+                       for (int j = 0; j < 8; j++)
+                         nodes[i].vertices[j] = j < n ? pnums[j] : -1;
+                     });
+      }
+  }
+
+  // the node map can not locate dofs which do not belong to a mesh node
+  static void CheckChunkedDofs (const MeshAccess & ma, const FESpace & fes, const string & where)
+  {
+    BitArray ondof(fes.GetNDof());
+    ondof.Clear();
+    for (NODE_TYPE nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
+      ParallelFor (ma.GetNNodes (nt), [&] (size_t i)
+                   {
+                     Array<DofId> dnums;
+                     fes.GetDofNrs (NodeId(nt, i), dnums);
+                     for (auto d : dnums)
+                       if (IsRegularDof(d))
+                         ondof.Set (d);
+                   });
+
+    uint64_t nodeless = 0;
+    for (size_t d = 0; d < ondof.Size(); d++)
+      if (!ondof.Test(d) && fes.GetDofCouplingType(d) != UNUSED_DOF)
+        nodeless++;
+#ifdef PARALLEL
+    if (MyMPI_GetNTasks() > 1)
+      MPI_Allreduce (MPI_IN_PLACE, &nodeless, 1, MPI_UINT64_T, MPI_SUM, ngs_comm);
+#endif
+    if (nodeless)
+      throw Exception ("GridFunction::" + where + ": " + ToString(nodeless) +
+                       " dofs do not belong to a mesh node (e.g. NumberSpace), use Save/Load without chunked");
+  }
+
+  static INT<9> ChunkedNodeKey (const ChunkedGFNode & node)
+  {
+    INT<9> key;
+    key[0] = node.type;
+    for (int j = 0; j < 8; j++)
+      key[j+1] = node.vertices[j];
+    return key;
+  }
+
+#ifndef WIN32
+  static void PWriteAll (int fd, const void * buf, size_t n, size_t offset)
+  {
+    const char * p = (const char*)buf;
+    while (n > 0)
+      {
+        ssize_t written = pwrite (fd, p, n, offset);
+        if (written < 0)
+          throw Exception (string("GridFunction::SaveChunked: write failed: ") + strerror(errno));
+        p += written;
+        n -= written;
+        offset += written;
+      }
+  }
+#endif
+
+
+  template <class SCAL>
+  void S_GridFunction<SCAL> :: SaveChunked (const string & filename) const
+  {
+#ifdef WIN32
+    throw Exception ("GridFunction::SaveChunked not available on Windows");
+#else
+    static Timer t("GridFunction::SaveChunked"); RegionTimer reg(t);
+    static Timer tw("GridFunction::SaveChunked - write");
+
+    int id = MyMPI_GetId();
+    int ntasks = MyMPI_GetNTasks();
+    const FESpace & fes = *GetFESpace();
+    CheckChunkedDofs (*ma, fes, "SaveChunked");
+    if (ntasks > 1)
+      GetVector().Cumulate();
+
+    Array<ChunkedGFNode> nodes;
+    Array<NodeId> ids;
+    CollectChunkedNodes (*ma, fes, ntasks > 1, nodes, ids);
+
+    uint64_t local[2] = { nodes.Size(), 0 };
+    for (auto & node : nodes)
+      {
+        node.first = local[1];
+        local[1] += node.nvalues;
+      }
+
+    // slice of this rank in the global node map and values
+    uint64_t first[2] = { 0, 0 };
+    uint64_t total[2] = { local[0], local[1] };
+#ifdef PARALLEL
+    if (ntasks > 1)
+      {
+        MPI_Exscan (local, first, 2, MPI_UINT64_T, MPI_SUM, ngs_comm);
+        if (id == 0) first[0] = first[1] = 0;
+        MPI_Allreduce (local, total, 2, MPI_UINT64_T, MPI_SUM, ngs_comm);
+      }
+#endif
+    for (auto & node : nodes)
+      node.first += first[1];
+
+    ChunkedGFHeader header = { };
+    memcpy (header.magic, chunked_gf_magic, 8);
+    header.version = 1;
+    header.scalar_size = sizeof(SCAL);
+    header.dim = fes.GetDimension();
+    header.ntasks = ntasks;
+    header.nnodes = total[0];
+    header.nvalues = total[1];
+    header.nodes_offset = sizeof(ChunkedGFHeader);
+    header.values_offset = (header.nodes_offset + total[0]*sizeof(ChunkedGFNode) + 4095) / 4096 * 4096;
+
+    // rank 0 creates the file, then all ranks write their slices
+    int fd = -1;
+    if (id == 0)
+      fd = open (filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    MyMPI_Barrier();
+    if (id != 0)
+      fd = open (filename.c_str(), O_WRONLY);
+    if (fd < 0)
+      throw Exception ("GridFunction::SaveChunked: cannot open " + filename);
+
+    RegionTimer regw(tw);
+    if (id == 0)
+      PWriteAll (fd, &header, sizeof(header), 0);
+    if (nodes.Size())
+      PWriteAll (fd, &nodes[0], nodes.Size()*sizeof(ChunkedGFNode),
+                 header.nodes_offset + first[0]*sizeof(ChunkedGFNode));
+
+    // every task serializes a range of nodes into a chunk of a few MB
+    FlatVector<SCAL> fv = GetVector().template FV<SCAL>();
+    size_t dim = fes.GetDimension();
+    size_t nchunks = max2 (size_t(TaskManager::GetNumThreads()),
+                           size_t(local[1]*sizeof(SCAL) >> 22));
+    ParallelForRange (IntRange(nodes.Size()), [&] (IntRange r)
+                      {
+                        if (r.Size() == 0) return;
+                        size_t offset = nodes[r.First()].first;
+                        auto & last = nodes[r.Next()-1];
+                        Array<SCAL> chunk(last.first + last.nvalues - offset);
+                        Array<DofId> dnums;
+                        size_t cnt = 0;
+                        for (size_t i : r)
+                          {
+                            fes.GetDofNrs (ids[i], dnums);
+                            for (auto d : dnums)
+                              for (size_t k = 0; k < dim; k++)
+                                chunk[cnt++] = IsRegularDof(d) ? fv(d*dim+k) : SCAL(0);
+                          }
+                        PWriteAll (fd, &chunk[0], chunk.Size()*sizeof(SCAL),
+                                   header.values_offset + offset*sizeof(SCAL));
+                      }, nchunks);
+
+    // extend the file to full size, also if the last rank has no values
+    if (id == 0 && total[1] == 0)
+      if (ftruncate (fd, header.values_offset) != 0)
+        throw Exception ("GridFunction::SaveChunked: cannot resize " + filename);
+    close (fd);
+    MyMPI_Barrier();
+#endif
+  }
+
+
+  template <class SCAL>
+  void S_GridFunction<SCAL> :: LoadChunked (const string & filename)
+  {
+#ifdef WIN32
+    throw Exception ("GridFunction::LoadChunked not available on Windows");
+#else
+    static Timer t("GridFunction::LoadChunked"); RegionTimer reg(t);
+    static Timer tmap("GridFunction::LoadChunked - node map");
+
+    const FESpace & fes = *GetFESpace();
+    CheckChunkedDofs (*ma, fes, "LoadChunked");
+    int fd = open (filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw Exception ("GridFunction::LoadChunked: cannot open " + filename);
+    struct stat st;
+    fstat (fd, &st);
+    size_t filesize = st.st_size;
+    if (filesize < sizeof(ChunkedGFHeader))
+      {
+        close (fd);
+        throw Exception ("GridFunction::LoadChunked: " + filename + " is not a gridfunction file");
+      }
+    void * map = mmap (nullptr, filesize, PROT_READ, MAP_SHARED, fd, 0);
+    close (fd);
+    if (map == MAP_FAILED)
+      throw Exception ("GridFunction::LoadChunked: cannot map " + filename);
+    const char * mem = (const char*)map;
+
+    ChunkedGFHeader header;
+    memcpy (&header, mem, sizeof(header));
+    string error;
+    if (memcmp (header.magic, chunked_gf_magic, 8) != 0 || header.version != 1)
+      error = filename + " is not a gridfunction file of version 1";
+    else if (header.scalar_size != sizeof(SCAL) || header.dim != size_t(fes.GetDimension()))
+      error = "scalar type or dimension of " + filename + " does not match the gridfunction";
+    else if (header.nodes_offset + header.nnodes*sizeof(ChunkedGFNode) > filesize ||
+             header.values_offset + header.nvalues*sizeof(SCAL) > filesize)
+      error = filename + " is truncated";
+    if (error.size())
+      {
+        munmap (map, filesize);
+        throw Exception ("GridFunction::LoadChunked: " + error);
+      }
+
+    FlatArray<ChunkedGFNode> filenodes (header.nnodes, (ChunkedGFNode*)(mem+header.nodes_offset));
+    const SCAL * values = (const SCAL*)(mem+header.values_offset);
+
+    // all local nodes, shared nodes read the same values on every rank
+    Array<ChunkedGFNode> nodes;
+    Array<NodeId> ids;
+    CollectChunkedNodes (*ma, fes, false, nodes, ids);
+
+    // position in the file, the identity if saved from the same mesh
+    tmap.Start();
+    Array<size_t> filenr(nodes.Size());
+    atomic<size_t> nmoved(0);
+    ParallelFor (nodes.Size(), [&] (size_t i)
+                 {
+                   if (i < filenodes.Size() && ChunkedNodeKey(filenodes[i]) == ChunkedNodeKey(nodes[i]))
+                     filenr[i] = i;
+                   else
+                     {
+                       filenr[i] = size_t(-1);
+                       nmoved++;
+                     }
+                 });
+    if (nmoved > 0)
+      {
+        ClosedHashTable<INT<9>, size_t> ht(2*filenodes.Size());
+        for (size_t i = 0; i < filenodes.Size(); i++)
+          ht.Set (ChunkedNodeKey(filenodes[i]), i);
+        ParallelFor (nodes.Size(), [&] (size_t i)
+                     {
+                       if (filenr[i] != size_t(-1)) return;
+                       size_t pos = ht.Position (ChunkedNodeKey(nodes[i]));
+                       if (pos != size_t(-1))
+                         ht.GetData (pos, filenr[i]);
+                     });
+      }
+    tmap.Stop();
+
+    FlatVector<SCAL> fv = GetVector().template FV<SCAL>();
+    size_t dim = fes.GetDimension();
+    atomic<size_t> nmissing(0);
+    ParallelForRange (IntRange(nodes.Size()), [&] (IntRange r)
+                      {
+                        Array<DofId> dnums;
+                        for (size_t i : r)
+                          {
+                            size_t nr = filenr[i];
+                            if (nr == size_t(-1) || filenodes[nr].nvalues != nodes[i].nvalues
+                                || filenodes[nr].first + filenodes[nr].nvalues > header.nvalues)
+                              {
+                                nmissing++;
+                                continue;
+                              }
+                            const SCAL * nodevalues = values + filenodes[nr].first;
+                            fes.GetDofNrs (ids[i], dnums);
+                            for (size_t j = 0; j < dnums.Size(); j++)
+                              if (IsRegularDof(dnums[j]))
+                                for (size_t k = 0; k < dim; k++)
+                                  fv(dnums[j]*dim+k) = nodevalues[j*dim+k];
+                          }
+                      }, TasksPerThread(4));
+    munmap (map, filesize);
+
+    if (MyMPI_GetNTasks() > 1)
+      GetVector().SetParallelStatus (CUMULATED);
+    if (nmissing > 0)
+      throw Exception ("GridFunction::LoadChunked: " + ToString(size_t(nmissing))
+                       + " nodes not found in " + filename);
+#endif
+  }
+
+
+
   template <class SCAL>
   S_ComponentGridFunction<SCAL> :: 
   S_ComponentGridFunction (const S_GridFunction<SCAL> & agf_parent, int acomp)
@@ -254,6 +254,15 @@ namespace ngcomp
 
     virtual void Load (istream & ist) = 0;
     virtual void Save (ostream & ost) const = 0;
+
+    /**
+       Save into a file with a node map and page aligned values.
+       Threads write disjoint node ranges with pwrite, with MPI every
+       rank writes the values of its master nodes into the same file.
+    */
+    virtual void SaveChunked (const string & filename) const = 0;
+    /// load from SaveChunked, works for a different distribution over ranks
+    virtual void LoadChunked (const string & filename) = 0;
   };
 
 
@@ -282,6 +291,8 @@ namespace ngcomp
     // parallel Load/Save by Martin Huber and Lothar Nannen 
     virtual void Load (istream & ist);
     virtual void Save (ostream & ost) const;
+    virtual void SaveChunked (const string & filename) const;
+    virtual void LoadChunked (const string & filename);
 
   private:
     template <int N, NODE_TYPE NT> void LoadNodeType (istream & ist);
@@ -3,130 +3,9 @@ using namespace ngcomp;
 
 
 
-#include "../linalg/concurrentqueue.h"
-typedef moodycamel::ConcurrentQueue<size_t> TQueue; 
-typedef moodycamel::ProducerToken TPToken; 
-typedef moodycamel::ConsumerToken TCToken; 
-
-
-
 namespace ngcomp
 {
 
-  static TQueue queue;
-
-  template <typename TFUNC>
-  void RunParallelDependency (FlatTable<int> dag,
-                              TFUNC func)
-  {
-    Array<atomic<int>> cnt_dep(dag.Size());
-
-    for (auto & d : cnt_dep) 
-      d.store (0, memory_order_relaxed);
-
-    static Timer t_cntdep("count dep");
-    t_cntdep.Start();
-    ParallelFor (Range(dag),
-                 [&] (int i)
-                 {
-                   for (int j : dag[i])
-                     cnt_dep[j]++;
-                 });
-    t_cntdep.Stop();    
-
-    atomic<size_t> num_ready(0), num_final(0);
-    ParallelForRange (cnt_dep.Size(), [&] (IntRange r)
-                      {
-                        size_t my_ready = 0, my_final = 0;
-                        for (size_t i : r)
-                          {
-                            if (cnt_dep[i] == 0) my_ready++;
-                            if (dag[i].Size() == 0) my_final++;
-                          }
-                        num_ready += my_ready;
-                        num_final += my_final;
-                      });
-
-    Array<int> ready(num_ready);
-    ready.SetSize0();
-    for (int j : Range(cnt_dep))
-      if (cnt_dep[j] == 0) ready.Append(j);
-
-    
-    if (!task_manager)
-      // if (true)
-      {
-        while (ready.Size())
-          {
-            int size = ready.Size();
-            int nr = ready[size-1];
-            ready.SetSize(size-1);
-            
-            func(nr);
-            
-            for (int j : dag[nr])
-              {
-                cnt_dep[j]--;
-                if (cnt_dep[j] == 0)
-                  ready.Append(j);
-              }
-          }
-        return;
-      }
-
-    atomic<int> cnt_final(0);
-    SharedLoop2 sl(Range(ready));
-
-    task_manager -> CreateJob 
-      ([&] (const TaskInfo & ti)
-       {
-         size_t my_final = 0;
-         TPToken ptoken(queue); 
-         TCToken ctoken(queue); 
-        
-         for (int i : sl)
-           queue.enqueue (ptoken, ready[i]);
-
-         while (1)
-           {
-             if (cnt_final >= num_final) break;
-
-             int nr;
-             if(!queue.try_dequeue_from_producer(ptoken, nr)) 
-               if(!queue.try_dequeue(ctoken, nr))
-                 {
-                   if (my_final)
-                     {
-                       cnt_final += my_final;
-                       my_final = 0;
-                     }
-                   continue;
-                 }
-
-             if (dag[nr].Size() == 0)
-               my_final++;
-             // cnt_final++;
-
-             func(nr);
-
-             for (int j : dag[nr])
-               {
-                 if (--cnt_dep[j] == 0)
-                   queue.enqueue (ptoken, j);
-               }
-           }
-       });
-  }
-
-
-
-
-
-
-
-
-  
-
   template <class SCAL>
   class H1AMG_Matrix : public BaseMatrix
   {
@@ -0,0 +1,628 @@
+/*********************************************************************/
+/* File:   matrixfree.cpp                                            */
+/* Date:   18. Oct. 2026                                             */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  /*
+    out(a,j,c) (+)= sum_l m(j,l) in(a,l,c),
+    i.e. m applied to the middle index of a 3-tensor
+  */
+  template <typename T>
+  static void Contract (FlatMatrix<> m, size_t na, size_t nc,
+                        const T * in, T * out, bool add = false)
+  {
+    size_t h = m.Height(), w = m.Width();
+    if (nc == 1)
+      {
+        for (size_t a = 0; a < na; a++)
+          for (size_t j = 0; j < h; j++)
+            {
+              T sum = add ? out[a*h+j] : T(0.0);
+              for (size_t l = 0; l < w; l++)
+                sum += m(j,l) * in[a*w+l];
+              out[a*h+j] = sum;
+            }
+        return;
+      }
+
+    for (size_t a = 0; a < na; a++)
+      for (size_t j = 0; j < h; j++)
+        {
+          T * __restrict po = out + (a*h+j)*nc;
+          if (!add)
+            for (size_t c = 0; c < nc; c++)
+              po[c] = T(0.0);
+          for (size_t l = 0; l < w; l++)
+            {
+              double mjl = m(j,l);
+              const T * __restrict pi = in + (a*w+l)*nc;
+              for (size_t c = 0; c < nc; c++)
+                po[c] += mjl * pi[c];
+            }
+        }
+  }
+
+  INLINE double & Lane (SIMD<double> & a, size_t l) { return reinterpret_cast<double*>(&a)[l]; }
+
+  /// 0 .. value, 1 .. gradient, -1 .. not supported
+  static int ProxyType (const ProxyFunction & proxy, int dim)
+  {
+    auto diffop = proxy.Evaluator().get();
+    switch (dim)
+      {
+      case 2:
+        if (dynamic_cast<T_DifferentialOperator<DiffOpId<2>>*> (diffop)) return 0;
+        if (dynamic_cast<T_DifferentialOperator<DiffOpGradient<2>>*> (diffop)) return 1;
+        break;
+      case 3:
+        if (dynamic_cast<T_DifferentialOperator<DiffOpId<3>>*> (diffop)) return 0;
+        if (dynamic_cast<T_DifferentialOperator<DiffOpGradient<3>>*> (diffop)) return 1;
+        break;
+      }
+    return -1;
+  }
+
+
+  MatrixFreeOperator ::
+  MatrixFreeOperator (shared_ptr<FESpace> afes,
+                      FlatArray<shared_ptr<BilinearFormIntegrator>> parts,
+                      LocalHeap & lh)
+    : fes(afes)
+  {
+    static Timer t("MatrixFreeOperator - setup");
+    RegionTimer reg(t);
+
+    auto ma = fes->GetMeshAccess();
+    dim = ma->GetDimension();
+    size_t ne = ma->GetNE(VOL);
+
+    if (dim < 2 || fes->GetDimension() != 1 || fes->IsComplex() ||
+        fes->NeedsTransformVec() || parts.Size() == 0)
+      return;
+    for (auto & bfi : parts)
+      if (!SupportedIntegrator (*bfi)) return;
+
+    for (int i = 0; i <= dim; i++)
+      {
+        if (i == 0 ? trial_value : trial_grad) in_comps.Append (i);
+        if (i == 0 ? test_value : test_grad) out_comps.Append (i);
+      }
+
+    size_t simdw = SIMD<double>::Size();
+    const IntegrationRule * ir = nullptr;
+    Array<DofId> dnums;
+    handled.SetSize (ne);
+    handled.Clear();
+    cfirst.Append (0);
+    first_pack.Append (0);
+
+    // elements of one colour share no dofs, packs of the same colour run in parallel
+    for (FlatArray<int> els_of_col : fes->ElementColoring(VOL))
+      {
+        for (int el : els_of_col)
+          {
+            HeapReset hr(lh);
+            ElementId ei(VOL, el);
+            if (!fes->DefinedOn (ei)) continue;
+            auto & fel = fes->GetFE (ei, lh);
+            if (!SupportedElement (fel)) continue;
+
+            if (order == -1)
+              {
+                ir = SetupRule (fel, parts, lh);
+                if (!ir)
+                  {
+                    handled.Clear();
+                    lane_el.SetSize0();
+                    return;
+                  }
+              }
+            if (fel.Order() != order || fel.GetNDof() != ndof_el) continue;
+
+            fes->GetDofNrs (ei, dnums);
+            bool regular = true;
+            for (auto d : dnums)
+              if (d < 0) regular = false;
+            if (!regular) continue;
+
+            // the tensor expansion depends only on the order of the vertex numbers
+            auto vnums = ma->GetElVertices (ei);
+            int key = 0;
+            for (size_t i = vnums.Size(); i-- > 0; )
+              {
+                int rank = 0;
+                for (size_t j = 0; j < vnums.Size(); j++)
+                  if (vnums[j] < vnums[i]) rank++;
+                key = 8*key + rank;
+              }
+            int cl = FindClass (fel, key, lh);
+            if (cl < 0) continue;
+
+            lane_el.Append (el);
+            lane_class.Append (cl);
+            lane_dofs.Append (dnums);
+            handled.SetBit (el);
+          }
+
+        while (lane_el.Size() % simdw)
+          {
+            lane_el.Append (-1);
+            lane_class.Append (0);
+            for (size_t i = 0; i < ndof_el; i++)
+              lane_dofs.Append (0);
+          }
+        first_pack.Append (lane_el.Size() / simdw);
+      }
+
+    if (!ir) return;
+
+    size_t npacks = lane_el.Size() / simdw;
+    geom.SetSize (npacks * ir->Size() * out_comps.Size() * in_comps.Size());
+    geom = SIMD<double>(0.0);
+
+    ParallelForRange (npacks, [&] (IntRange r)
+                      {
+                        LocalHeap slh = lh.Split();
+                        for (size_t pack : r)
+                          {
+                            HeapReset hr(slh);
+                            if (dim == 2)
+                              CalcGeometry<2> (pack, parts, *ir, slh);
+                            else
+                              CalcGeometry<3> (pack, parts, *ir, slh);
+                          }
+                      });
+
+    cout << IM(3) << "matrix-free application on " << NumHandled() << " of " << ne
+         << " elements, " << nclasses << " vertex orientations" << endl;
+  }
+
+
+  bool MatrixFreeOperator :: SupportedIntegrator (const BilinearFormIntegrator & bfi)
+  {
+    auto sbfi = dynamic_cast<const SymbolicBilinearFormIntegrator*> (&bfi);
+    if (!sbfi) return false;
+    if (sbfi->VB() != VOL || sbfi->ElementVB() != VOL) return false;
+    if (sbfi->GetDeformation()) return false;
+    if (sbfi->GetCoefficientFunction()->IsComplex()) return false;
+
+    for (auto proxy : sbfi->TrialProxies())
+      switch (ProxyType (*proxy, dim))
+        {
+        case 0: trial_value = true; break;
+        case 1: trial_grad = true; break;
+        default: return false;
+        }
+    for (auto proxy : sbfi->TestProxies())
+      switch (ProxyType (*proxy, dim))
+        {
+        case 0: test_value = true; break;
+        case 1: test_grad = true; break;
+        default: return false;
+        }
+    return true;
+  }
+
+  bool MatrixFreeOperator :: SupportedElement (const FiniteElement & fel) const
+  {
+    if (dim == 2)
+      return dynamic_cast<const H1HighOrderFE<ET_QUAD>*> (&fel) ||
+        dynamic_cast<const L2HighOrderFE<ET_QUAD>*> (&fel);
+    return dynamic_cast<const H1HighOrderFE<ET_HEX>*> (&fel) ||
+      dynamic_cast<const L2HighOrderFE<ET_HEX>*> (&fel);
+  }
+
+
+  const IntegrationRule * MatrixFreeOperator ::
+  SetupRule (const FiniteElement & fel,
+             FlatArray<shared_ptr<BilinearFormIntegrator>> parts,
+             LocalHeap & lh)
+  {
+    order = fel.Order();
+    ndof_el = fel.GetNDof();
+    n1 = order+1;
+    h1basis = dynamic_cast<const H1HighOrderFE<ET_QUAD>*> (&fel) ||
+      dynamic_cast<const H1HighOrderFE<ET_HEX>*> (&fel);
+
+    // all integrators have to share the rule
+    const IntegrationRule * ir = nullptr;
+    for (auto & bfi : parts)
+      {
+        auto & irbfi = static_cast<SymbolicBilinearFormIntegrator&> (*bfi).GetIntegrationRule (fel, lh);
+        if (ir && ir != &irbfi) return nullptr;
+        ir = &irbfi;
+      }
+
+    // rules on quads and hexes are tensor products of a Gauss rule, x running slowest
+    nq1 = size_t (lround (pow (ir->Size(), 1.0/dim)));
+    const IntegrationRule & irseg = SelectIntegrationRule (ET_SEGM, 2*nq1-1);
+    if (irseg.Size() != nq1) return nullptr;
+
+    for (size_t q = 0; q < ir->Size(); q++)
+      {
+        size_t rest = q;
+        double weight = 1;
+        for (int j = dim; j-- > 0; )
+          {
+            auto & ip1 = irseg[rest % nq1];
+            if (fabs ((*ir)[q](j) - ip1(0)) > 1e-12) return nullptr;
+            weight *= ip1.Weight();
+            rest /= nq1;
+          }
+        if (fabs ((*ir)[q].Weight() - weight) > 1e-12) return nullptr;
+      }
+
+    shape1d.SetSize (nq1, n1);
+    dshape1d.SetSize (nq1, n1);
+    for (size_t q = 0; q < nq1; q++)
+      CalcShape1D (irseg[q](0), shape1d.Row(q), dshape1d.Row(q));
+    shape1dt.SetSize (n1, nq1);
+    dshape1dt.SetSize (n1, nq1);
+    shape1dt = Trans (shape1d);
+    dshape1dt = Trans (dshape1d);
+    return ir;
+  }
+
+
+  /*
+    1D basis on [0,1] the element shape functions are expanded in.
+    H1: the two vertex functions and Chebyshev bubbles, like the
+    hierarchical H1 basis, so that vertex, face and cell functions are
+    single tensor products; L2: Legendre polynomials in 2x-1.
+  */
+  void MatrixFreeOperator :: CalcShape1D (double x, FlatVector<> shape, FlatVector<> dshape) const
+  {
+    ArrayMem<AutoDiff<1>,20> pol(n1);
+    AutoDiff<1> adx(x, 0);
+    if (h1basis)
+      {
+        pol[0] = 1.0-adx;
+        pol[1] = adx;
+        if (order >= 2)
+          ChebyPolynomial::EvalMult (order-2, 2.0*adx-1.0, adx*(1.0-adx), pol.Range(2, n1));
+      }
+    else
+      LegendrePolynomial::Eval (order, 2.0*adx-1.0, pol);
+
+    for (size_t i = 0; i < n1; i++)
+      {
+        shape(i) = pol[i].Value();
+        dshape(i) = pol[i].DValue(0);
+      }
+  }
+
+
+  int MatrixFreeOperator :: FindClass (const FiniteElement & fel, int key, LocalHeap & lh)
+  {
+    for (size_t i = 0; i < class_keys.Size(); i++)
+      if (class_keys[i] == key) return class_nrs[i];
+
+    HeapReset hr(lh);
+    size_t nt = n1*n1*(dim == 3 ? n1 : 1);
+    auto & sfel = static_cast<const BaseScalarFiniteElement&> (fel);
+    const IntegrationRule & irseg = SelectIntegrationRule (ET_SEGM, 2*order);
+
+    // shape functions at the tensor product points ...
+    FlatMatrix<> c(ndof_el, nt, lh), tmp(ndof_el, nt, lh);
+    for (size_t q = 0; q < nt; q++)
+      {
+        size_t q0 = dim == 3 ? q / (n1*n1) : q / n1;
+        size_t q1 = dim == 3 ? (q / n1) % n1 : q % n1;
+        size_t q2 = q % n1;
+        IntegrationPoint ip(irseg[q0](0), irseg[q1](0), dim == 3 ? irseg[q2](0) : 0.0, 0);
+        sfel.CalcShape (ip, c.Col(q));
+      }
+
+    // ... interpolated by the 1D basis in every direction
+    Matrix<> vinv(n1, n1), dummy(n1, n1);
+    for (size_t q = 0; q < n1; q++)
+      CalcShape1D (irseg[q](0), vinv.Row(q), dummy.Row(q));
+    CalcInverse (vinv);
+    for (int j = 0; j < dim; j++)
+      {
+        size_t na = 1, nc = 1;
+        for (int k = 0; k < j; k++) na *= n1;
+        for (int k = j+1; k < dim; k++) nc *= n1;
+        for (size_t i = 0; i < ndof_el; i++)
+          Contract (vinv, na, nc, &c(i,0), &tmp(i,0));
+        c = tmp;
+      }
+
+    // the shape functions have to be exactly in the tensor space
+    IntegrationPoint ipcheck(0.31, 0.73, dim == 3 ? 0.17 : 0.0, 0);
+    FlatVector<> shape(ndof_el, lh), tshape(nt, lh);
+    Vector<> s0(n1), s1(n1), s2(n1), ds(n1);
+    sfel.CalcShape (ipcheck, shape);
+    CalcShape1D (ipcheck(0), s0, ds);
+    CalcShape1D (ipcheck(1), s1, ds);
+    CalcShape1D (ipcheck(2), s2, ds);
+    for (size_t t = 0; t < nt; t++)
+      tshape(t) = dim == 3 ?
+        s0(t/(n1*n1)) * s1((t/n1)%n1) * s2(t%n1) : s0(t/n1) * s1(t%n1);
+
+    int nr = -1;
+    if (L2Norm (shape - c * tshape) < 1e-8 * (1+L2Norm(shape)))
+      {
+        nr = nclasses++;
+        for (size_t i = 0; i < ndof_el; i++)
+          {
+            double eps = 1e-12 * max2 (1.0, MaxNorm (c.Row(i)));
+            for (size_t t = 0; t < nt; t++)
+              if (fabs (c(i,t)) > eps)
+                {
+                  cindex.Append (t);
+                  cval.Append (c(i,t));
+                }
+            cfirst.Append (cindex.Size());
+          }
+      }
+
+    class_keys.Append (key);
+    class_nrs.Append (nr);
+    return nr;
+  }
+
+
+  template <int D>
+  void MatrixFreeOperator ::
+  CalcGeometry (size_t pack, FlatArray<shared_ptr<BilinearFormIntegrator>> parts,
+                const IntegrationRule & ir, LocalHeap & lh)
+  {
+    auto ma = fes->GetMeshAccess();
+    size_t simdw = SIMD<double>::Size();
+    size_t nq = ir.Size();
+    size_t nin = in_comps.Size(), nout = out_comps.Size();
+    SIMD<double> * pgeom = &geom[pack*nq*nout*nin];
+
+    for (size_t l = 0; l < simdw; l++)
+      {
+        int el = lane_el[pack*simdw+l];
+        if (el < 0) continue;
+
+        HeapReset hr(lh);
+        ElementId ei(VOL, el);
+        auto & trafo = ma->GetTrafo (ei, lh);
+        auto & mir = static_cast<MappedIntegrationRule<D,D>&> (trafo(ir, lh));
+
+        FlatArray<Mat<D+1,D+1>> g(nq, lh);
+        for (auto & gq : g) gq = 0.0;
+
+        for (auto & bfi : parts)
+          {
+            if (!bfi->DefinedOn (trafo.GetElementIndex())) continue;
+            if (!bfi->DefinedOnElement (el)) continue;
+            auto & sbfi = static_cast<const SymbolicBilinearFormIntegrator&> (*bfi);
+
+            int ntrial = 0, ntest = 0;
+            for (auto proxy : sbfi.TrialProxies()) ntrial += proxy->Dimension();
+            for (auto proxy : sbfi.TestProxies()) ntest += proxy->Dimension();
+
+            FlatTensor<3,double> coupling(lh, nq, ntrial, ntest);
+            sbfi.CalcProxyCoupling (mir, coupling, lh);
+
+            // physical proxy components from reference value and gradient
+            FlatMatrix<> ttrial(ntrial, D+1, lh), ttest(ntest, D+1, lh);
+            auto reftrafo = [&] (FlatArray<ProxyFunction*> proxies,
+                                 Mat<D,D> jacinv, FlatMatrix<> tm)
+              {
+                tm = 0.0;
+                int k = 0;
+                for (auto proxy : proxies)
+                  {
+                    if (ProxyType (*proxy, D) == 1)
+                      for (int j = 0; j < D; j++)
+                        for (int m = 0; m < D; m++)
+                          tm(k+j, 1+m) = jacinv(m,j);
+                    else
+                      tm(k,0) = 1;
+                    k += proxy->Dimension();
+                  }
+              };
+
+            for (size_t q = 0; q < nq; q++)
+              {
+                Mat<D,D> jacinv = mir[q].GetJacobianInverse();
+                reftrafo (sbfi.TrialProxies(), jacinv, ttrial);
+                reftrafo (sbfi.TestProxies(), jacinv, ttest);
+                double w = mir[q].GetWeight();
+                for (int k = 0; k < ntrial; k++)
+                  for (int m = 0; m < ntest; m++)
+                    {
+                      double ckm = w * coupling(q,k,m);
+                      if (ckm == 0) continue;
+                      for (int o = 0; o <= D; o++)
+                        for (int i = 0; i <= D; i++)
+                          g[q](o,i) += ttest(m,o) * ckm * ttrial(k,i);
+                    }
+              }
+          }
+
+        for (size_t q = 0; q < nq; q++)
+          for (size_t o = 0; o < nout; o++)
+            for (size_t i = 0; i < nin; i++)
+              Lane (pgeom[(q*nout+o)*nin+i], l) = g[q](out_comps[o], in_comps[i]);
+      }
+  }
+
+
+  /*
+    values (row 0) and reference gradients (rows 1..D) at the
+    integration points, from the coefficients of the tensor basis.
+    Contractions go from the fastest (last) index to the slowest one,
+    and share the partial sums of the value and the derivatives.
+  */
+  template <int D>
+  void MatrixFreeOperator ::
+  Evaluate (FlatVector<SIMD<double>> coefs, FlatMatrix<SIMD<double>> vals, LocalHeap & lh) const
+  {
+    size_t n = n1, nq = nq1;
+    if (D == 2)
+      {
+        FlatVector<SIMD<double>> tb(n*nq, lh), td(n*nq, lh);
+        Contract (shape1d, n, 1, &coefs(0), &tb(0));
+        if (trial_value)
+          Contract (shape1d, 1, nq, &tb(0), &vals(0,0));
+        if (trial_grad)
+          {
+            Contract (dshape1d, n, 1, &coefs(0), &td(0));
+            Contract (dshape1d, 1, nq, &tb(0), &vals(1,0));
+            Contract (shape1d, 1, nq, &td(0), &vals(2,0));
+          }
+        return;
+      }
+
+    FlatVector<SIMD<double>> tb(n*n*nq, lh), td(n*n*nq, lh);
+    FlatVector<SIMD<double>> tbb(n*nq*nq, lh), tdb(n*nq*nq, lh), tbd(n*nq*nq, lh);
+    Contract (shape1d, n*n, 1, &coefs(0), &tb(0));
+    Contract (shape1d, n, nq, &tb(0), &tbb(0));
+    if (trial_value)
+      Contract (shape1d, 1, nq*nq, &tbb(0), &vals(0,0));
+    if (trial_grad)
+      {
+        Contract (dshape1d, n*n, 1, &coefs(0), &td(0));
+        Contract (dshape1d, n, nq, &tb(0), &tdb(0));
+        Contract (shape1d, n, nq, &td(0), &tbd(0));
+        Contract (dshape1d, 1, nq*nq, &tbb(0), &vals(1,0));
+        Contract (shape1d, 1, nq*nq, &tdb(0), &vals(2,0));
+        Contract (shape1d, 1, nq*nq, &tbd(0), &vals(3,0));
+      }
+  }
+
+  /// transpose of Evaluate, test function rows of vals
+  template <int D>
+  void MatrixFreeOperator ::
+  EvaluateTrans (FlatMatrix<SIMD<double>> vals, FlatVector<SIMD<double>> coefs, LocalHeap & lh) const
+  {
+    size_t n = n1, nq = nq1;
+    if (D == 2)
+      {
+        FlatVector<SIMD<double>> tb(n*nq, lh), td(n*nq, lh);
+        if (test_value)
+          Contract (shape1dt, 1, nq, &vals(0,0), &tb(0));
+        if (test_grad)
+          {
+            Contract (dshape1dt, 1, nq, &vals(1,0), &tb(0), test_value);
+            Contract (shape1dt, 1, nq, &vals(2,0), &td(0));
+          }
+        Contract (shape1dt, n, 1, &tb(0), &coefs(0));
+        if (test_grad)
+          Contract (dshape1dt, n, 1, &td(0), &coefs(0), true);
+        return;
+      }
+
+    FlatVector<SIMD<double>> tb(n*n*nq, lh), td(n*n*nq, lh);
+    FlatVector<SIMD<double>> tbb(n*nq*nq, lh), tdb(n*nq*nq, lh), tbd(n*nq*nq, lh);
+    if (test_value)
+      Contract (shape1dt, 1, nq*nq, &vals(0,0), &tbb(0));
+    if (test_grad)
+      {
+        Contract (dshape1dt, 1, nq*nq, &vals(1,0), &tbb(0), test_value);
+        Contract (shape1dt, 1, nq*nq, &vals(2,0), &tdb(0));
+        Contract (shape1dt, 1, nq*nq, &vals(3,0), &tbd(0));
+      }
+    Contract (shape1dt, n, nq, &tbb(0), &tb(0));
+    if (test_grad)
+      {
+        Contract (dshape1dt, n, nq, &tdb(0), &tb(0), true);
+        Contract (shape1dt, n, nq, &tbd(0), &td(0));
+      }
+    Contract (shape1dt, n*n, 1, &tb(0), &coefs(0));
+    if (test_grad)
+      Contract (dshape1dt, n*n, 1, &td(0), &coefs(0), true);
+  }
+
+
+  template <int D>
+  void MatrixFreeOperator ::
+  ApplyPack (size_t pack, double val, FlatVector<double> fx, FlatVector<double> fy, LocalHeap & lh) const
+  {
+    size_t simdw = SIMD<double>::Size();
+    size_t nt = n1*n1*(D == 3 ? n1 : 1);
+    size_t nq = nq1*nq1*(D == 3 ? nq1 : 1);
+    size_t nin = in_comps.Size(), nout = out_comps.Size();
+
+    // gather: element vectors to coefficients of the tensor basis, one element per lane
+    FlatVector<SIMD<double>> coefs(nt, lh);
+    coefs = SIMD<double>(0.0);
+    for (size_t l = 0; l < simdw; l++)
+      {
+        size_t slot = pack*simdw+l;
+        if (lane_el[slot] < 0) continue;
+        const int * dofs = &lane_dofs[slot*ndof_el];
+        size_t row = lane_class[slot]*ndof_el;
+        for (size_t i = 0; i < ndof_el; i++, row++)
+          {
+            double ui = fx(dofs[i]);
+            for (size_t j = cfirst[row]; j < cfirst[row+1]; j++)
+              Lane (coefs(cindex[j]), l) += cval[j] * ui;
+          }
+      }
+
+    FlatMatrix<SIMD<double>> vals(D+1, nq, lh), res(D+1, nq, lh);
+    Evaluate<D> (coefs, vals, lh);
+
+    const SIMD<double> * pgeom = &geom[pack*nq*nout*nin];
+    for (size_t q = 0; q < nq; q++, pgeom += nout*nin)
+      for (size_t o = 0; o < nout; o++)
+        {
+          SIMD<double> sum(0.0);
+          for (size_t i = 0; i < nin; i++)
+            sum += pgeom[o*nin+i] * vals(in_comps[i], q);
+          res(out_comps[o], q) = sum;
+        }
+
+    EvaluateTrans<D> (res, coefs, lh);
+
+    // scatter
+    for (size_t l = 0; l < simdw; l++)
+      {
+        size_t slot = pack*simdw+l;
+        if (lane_el[slot] < 0) continue;
+        const int * dofs = &lane_dofs[slot*ndof_el];
+        size_t row = lane_class[slot]*ndof_el;
+        for (size_t i = 0; i < ndof_el; i++, row++)
+          {
+            double sum = 0;
+            for (size_t j = cfirst[row]; j < cfirst[row+1]; j++)
+              sum += cval[j] * Lane (coefs(cindex[j]), l);
+            fy(dofs[i]) += val * sum;
+          }
+      }
+  }
+
+
+  void MatrixFreeOperator ::
+  MultAdd (double val, const BaseVector & x, BaseVector & y, LocalHeap & clh) const
+  {
+    static Timer t("MatrixFreeOperator::MultAdd");
+    RegionTimer reg(t);
+    if (!NumHandled()) return;
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+
+    for (size_t col = 0; col+1 < first_pack.Size(); col++)
+      {
+        SharedLoop2 sl(IntRange (first_pack[col], first_pack[col+1]));
+        ParallelJob
+          ( [&] (const TaskInfo & ti)
+            {
+              LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+              for (size_t pack : sl)
+                {
+                  HeapReset hr(lh);
+                  if (dim == 2)
+                    ApplyPack<2> (pack, val, fx, fy, lh);
+                  else
+                    ApplyPack<3> (pack, val, fx, fy, lh);
+                }
+            } );
+      }
+  }
+
+}
@@ -0,0 +1,99 @@
+#ifndef FILE_MATRIXFREE
+#define FILE_MATRIXFREE
+
+/*********************************************************************/
+/* File:   matrixfree.hpp                                            */
+/* Date:   18. Oct. 2026                                             */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Sum-factorized application of the volume integrators of a
+     bilinear form, without element matrices.
+
+     Used for quadrilateral and hexahedral H1HighOrderFE and
+     L2HighOrderFE elements of uniform order, and for symbolic
+     integrators formed by u, grad(u), v and grad(v) of a scalar space.
+     Each element shape function is expanded in a tensor product basis
+     of 1D polynomials, once per vertex orientation of the element.
+     Values and gradients at the tensor integration points then cost
+     O(p^{d+1}) per element instead of O(p^{2d}).
+
+     Coefficients, integration weights and inverse Jacobians are
+     combined at setup to one small matrix per integration point.
+     Elements of the same colour are processed in packs of
+     SIMD<double>::Size(), one element per SIMD lane.
+     All other elements are left to the element-by-element application.
+  */
+  class NGS_DLL_HEADER MatrixFreeOperator
+  {
+    shared_ptr<FESpace> fes;
+    int dim = 0;
+    int order = -1;
+    bool h1basis = true;
+    size_t ndof_el = 0;
+    /// 1D basis functions and integration points
+    size_t n1 = 0, nq1 = 0;
+    /// values and derivatives of 1D basis functions at 1D integration points
+    Matrix<> shape1d, dshape1d, shape1dt, dshape1dt;
+
+    /// reference components (0 .. value, 1+j .. derivative in x_j) used by trial and test functions
+    Array<int> in_comps, out_comps;
+    bool trial_value = false, trial_grad = false, test_value = false, test_grad = false;
+
+    /// element shape functions in the tensor basis, ndof_el rows per vertex orientation
+    Array<int> class_keys, class_nrs;
+    int nclasses = 0;
+    Array<size_t> cfirst;
+    Array<int> cindex;
+    Array<double> cval;
+
+    /// packs of elements of one colour, one element per SIMD lane, -1 for empty lanes
+    Array<size_t> first_pack;
+    Array<int> lane_el;
+    Array<int> lane_class;
+    Array<int> lane_dofs;
+    /// per pack and integration point, nout x nin matrix of combined geometry and coefficients
+    Array<SIMD<double>> geom;
+
+    BitArray handled;
+
+  public:
+    MatrixFreeOperator (shared_ptr<FESpace> afes,
+                        FlatArray<shared_ptr<BilinearFormIntegrator>> parts,
+                        LocalHeap & lh);
+
+    /// is the element applied by the sum-factorized kernel ?
+    bool Handles (size_t elnr) const { return elnr < handled.Size() && handled.Test(elnr); }
+    size_t NumHandled () const { return handled.Size() ? handled.NumSet() : 0; }
+
+    /// y += val * A x  on the handled elements
+    void MultAdd (double val, const BaseVector & x, BaseVector & y, LocalHeap & lh) const;
+    void MultAdd (Complex val, const BaseVector & x, BaseVector & y, LocalHeap & lh) const
+    { if (NumHandled()) throw Exception ("MatrixFreeOperator: only real forms supported"); }
+
+  private:
+    bool SupportedIntegrator (const BilinearFormIntegrator & bfi);
+    bool SupportedElement (const FiniteElement & fel) const;
+    const IntegrationRule * SetupRule (const FiniteElement & fel,
+                                       FlatArray<shared_ptr<BilinearFormIntegrator>> parts,
+                                       LocalHeap & lh);
+    void CalcShape1D (double x, FlatVector<> shape, FlatVector<> dshape) const;
+    int FindClass (const FiniteElement & fel, int key, LocalHeap & lh);
+
+    template <int D>
+    void CalcGeometry (size_t pack, FlatArray<shared_ptr<BilinearFormIntegrator>> parts,
+                       const IntegrationRule & ir, LocalHeap & lh);
+    template <int D>
+    void Evaluate (FlatVector<SIMD<double>> coefs, FlatMatrix<SIMD<double>> vals, LocalHeap & lh) const;
+    template <int D>
+    void EvaluateTrans (FlatMatrix<SIMD<double>> vals, FlatVector<SIMD<double>> coefs, LocalHeap & lh) const;
+    template <int D>
+    void ApplyPack (size_t pack, double val, FlatVector<double> fx, FlatVector<double> fy, LocalHeap & lh) const;
+  };
+
+}
+
+#endif
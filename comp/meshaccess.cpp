@@ -139,6 +139,10 @@ namespace ngcomp
     virtual void CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const override;
 
+    // without geometry cache
+    void CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
+                                        SIMD_BaseMappedIntegrationRule & bmir) const;
+
     virtual const ElementTransformation & VAddDeformation (const GridFunction * gf, LocalHeap & lh) const override
     {
       return * new (lh) ALE_ElementTransformation<DIMS,DIMR,Ng_ElementTransformation<DIMS,DIMR>>
@@ -530,7 +534,7 @@ namespace ngcomp
 ////////////////////////////
 
 template<>
- void  Ng_ElementTransformation<3,3> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<3,3> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -556,7 +560,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<2,2> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<2,2> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -582,7 +586,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<2,3> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<2,3> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -608,7 +612,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<1,3> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<1,3> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -634,7 +638,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<0,3> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<0,3> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -660,7 +664,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<1,2> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<1,2> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -686,7 +690,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<1,1> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<1,1> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -712,7 +716,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<0,2> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<0,2> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -738,7 +742,7 @@ template<>
     }
 
 template<>
- void  Ng_ElementTransformation<0,1> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+ void  Ng_ElementTransformation<0,1> :: CalcMultiPointJacobianNoCache (const SIMD_IntegrationRule & ir,
 					 SIMD_BaseMappedIntegrationRule & bmir) const 
     {
       // static Timer t("eltrafo - nonconst, calcmultipoint"); RegionTimer reg(t);
@@ -764,6 +768,203 @@ template<>
     }
 
 
+  template <int DIMS, int DIMR>
+  void Ng_ElementTransformation<DIMS,DIMR> :: CalcMultiPointJacobian (const SIMD_IntegrationRule & ir,
+                                                                      SIMD_BaseMappedIntegrationRule & bmir) const
+  {
+    GeometryCache * cache = mesh->GetGeometryCache();
+    if (!cache || ir.Size() == 0)
+      {
+        CalcMultiPointJacobianNoCache (ir, bmir);
+        return;
+      }
+
+    auto & mir = static_cast<SIMD_MappedIntegrationRule<DIMS,DIMR> &> (bmir);
+    size_t n = ir.Size();
+    // component-wise: points, then Jacobians
+    size_t size = (DIMR + DIMR*DIMS) * n;
+    int rulenr = cache->RuleNr (ir);
+    if (rulenr < 0)
+      {
+        CalcMultiPointJacobianNoCache (ir, bmir);
+        return;
+      }
+
+    auto values = cache->Find (GetElementId(), rulenr);
+    if (values.Size() == size)
+      {
+        for (size_t i = 0; i < n; i++)
+          {
+            auto & mip = mir[i];
+            for (int k = 0; k < DIMR; k++)
+              mip.Point()(k) = values[k*n+i];
+            for (int k = 0; k < DIMR; k++)
+              for (int l = 0; l < DIMS; l++)
+                mip.Jacobian()(k,l) = values[(DIMR+k*DIMS+l)*n+i];
+            mip.Compute();
+          }
+        return;
+      }
+
+    CalcMultiPointJacobianNoCache (ir, bmir);
+
+    STACK_ARRAY(SIMD<double>, mem, size);
+    FlatArray<SIMD<double>> store(size, &mem[0]);
+    for (size_t i = 0; i < n; i++)
+      {
+        auto & mip = mir[i];
+        for (int k = 0; k < DIMR; k++)
+          store[k*n+i] = mip.Point()(k);
+        for (int k = 0; k < DIMR; k++)
+          for (int l = 0; l < DIMS; l++)
+            store[(DIMR+k*DIMS+l)*n+i] = mip.Jacobian()(k,l);
+      }
+    cache->Insert (GetElementId(), rulenr, store);
+  }
+
+
+  bool GeometryCache::Rule :: Matches (const SIMD_IntegrationRule & ir) const
+  {
+    if (size_t(coords.Size()) != 3*ir.Size()) return false;
+    for (size_t i = 0; i < ir.Size(); i++)
+      for (int j = 0; j < 3; j++)
+        {
+          SIMD<double> x = ir[i](j);
+          if (memcmp (&coords[3*i+j], &x, sizeof(x)) != 0) return false;
+        }
+    return true;
+  }
+
+  int GeometryCache :: RuleNr (const SIMD_IntegrationRule & ir)
+  {
+    // rules are mostly shared (SIMD_SelectIntegrationRule), so the
+    // address of the points finds the rule without hashing and locking
+    auto & memo = rule_memo[(size_t(&ir[0]) / sizeof(SIMD<IntegrationPoint>)) % NMEMO];
+    Rule * last = memo.load (std::memory_order_acquire);
+    if (last && last->Matches (ir))
+      return last->nr;
+
+    // only the coordinates, SIMD<IntegrationPoint> has padding bytes
+    STACK_ARRAY(SIMD<double>, coords, 3*ir.Size());
+    for (size_t i = 0; i < ir.Size(); i++)
+      for (int j = 0; j < 3; j++)
+        coords[3*i+j] = ir[i](j);
+    const char * data = reinterpret_cast<const char*> (&coords[0]);
+    size_t bytes = 3 * ir.Size() * sizeof(SIMD<double>);
+    // FNV-1a on 64-bit words
+    size_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i+8 <= bytes; i += 8)
+      {
+        uint64_t word;
+        memcpy (&word, data+i, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+      }
+    hash ^= bytes;
+
+    auto find = [&] () -> Rule*
+      {
+        auto range = rule_numbers.equal_range (hash);
+        for (auto it = range.first; it != range.second; ++it)
+          {
+            auto & rule = *rules[it->second];
+            if (size_t(rule.coords.Size()) == 3*ir.Size() &&
+                memcmp (&rule.coords[0], data, bytes) == 0)
+              return &rule;
+          }
+        return nullptr;
+      };
+
+    Rule * rule = nullptr;
+    {
+      std::shared_lock<std::shared_mutex> lock(rules_mutex);
+      rule = find();
+    }
+
+    if (!rule)
+      {
+        std::unique_lock<std::shared_mutex> lock(rules_mutex);
+        rule = find();
+        if (!rule)
+          {
+            // registered rules count against the budget, and must fit into the keys
+            size_t rulebytes = sizeof(Rule) + bytes;
+            if (rules.Size() >= MAX_RULES || used + rulebytes > budget) return -1;
+            used += rulebytes;
+
+            auto newrule = make_unique<Rule>();
+            newrule->nr = rules.Size();
+            newrule->coords.SetSize (3*ir.Size());
+            memcpy (&newrule->coords[0], data, bytes);
+            rule = newrule.get();
+            rules.Append (move(newrule));
+            rule_numbers.emplace (hash, rule->nr);
+          }
+      }
+
+    // rules stay until the cache is cleared
+    memo.store (rule, std::memory_order_release);
+    return rule->nr;
+  }
+
+  FlatArray<SIMD<double>> GeometryCache :: Find (ElementId ei, int rulenr)
+  {
+    size_t key = Key (ei, rulenr);
+    Shard & shard = GetShard (ei, rulenr);
+    lock_guard<mutex> guard(shard.mutex);
+    auto pos = shard.entries.find (key);
+    if (pos == shard.entries.end())
+      {
+        misses++;
+        return FlatArray<SIMD<double>> (0, nullptr);
+      }
+    hits++;
+    // arena blocks stay until the cache is cleared
+    return pos->second;
+  }
+
+  void GeometryCache :: Insert (ElementId ei, int rulenr, FlatArray<SIMD<double>> values)
+  {
+    size_t key = Key (ei, rulenr);
+    Shard & shard = GetShard (ei, rulenr);
+    lock_guard<mutex> guard(shard.mutex);
+    if (shard.entries.count (key)) return;
+
+    size_t n = values.Size();
+    if (shard.block_used + n > shard.block_size)
+      {
+        size_t blocksize = max2 (size_t(BLOCK_SIZE), n);
+        size_t bytes = blocksize * sizeof(SIMD<double>);
+        if (used + bytes > budget) return;
+        used += bytes;
+        shard.blocks.Append (unique_ptr<SIMD<double>[]> (new SIMD<double>[blocksize]));
+        shard.block_size = blocksize;
+        shard.block_used = 0;
+      }
+    SIMD<double> * mem = shard.blocks.Last().get() + shard.block_used;
+    shard.block_used += n;
+    for (size_t i = 0; i < n; i++)
+      mem[i] = values[i];
+    shard.entries[key] = FlatArray<SIMD<double>> (n, mem);
+  }
+
+  void GeometryCache :: Clear ()
+  {
+    for (auto & shard : shards)
+      {
+        lock_guard<mutex> guard(shard.mutex);
+        shard.entries.clear();
+        shard.blocks.SetSize0();
+        shard.block_size = shard.block_used = 0;
+      }
+    std::unique_lock<std::shared_mutex> lock(rules_mutex);
+    for (auto & memo : rule_memo) memo = nullptr;
+    rules.SetSize0();
+    rule_numbers.clear();
+    used = 0;
+  }
+
+
+
   template <int DIMS, int DIMR, typename BASE>
   class ALE_ElementTransformation : public BASE
   {
@@ -1444,6 +1645,8 @@ template<>
     mesh_timestamp = netgen_mesh_timestamp;
     
     timestamp = NGS_Object::GetNextTimeStamp();
+    if (geometry_cache)
+      geometry_cache->Clear();
     
 
     dim = mesh->GetDimension();
@@ -2657,7 +2860,17 @@ template<>
   void MeshAccess :: Curve (int order)
   {
     mesh->Curve(order);
+    if (geometry_cache)
+      geometry_cache->Clear();
   } 
+
+  void MeshAccess :: SetGeometryCache (size_t budget)
+  {
+    if (budget)
+      geometry_cache = make_shared<GeometryCache> (budget);
+    else
+      geometry_cache = nullptr;
+  }
   
   int MeshAccess :: GetNPairsPeriodicVertices () const 
   {
@@ -10,6 +10,8 @@
 
 #include <nginterface.h>
 #include <nginterface_v2.hpp>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace ngfem
 {
@@ -191,6 +193,78 @@ namespace ngcomp
 
   class GridFunction;
 
+
+  /**
+     Cache for points and Jacobians of curved elements, mapped with
+     SIMD integration rules. Values are stored component-wise per
+     element and integration rule in arena blocks, up to a memory
+     budget which also covers the registered integration rules. The
+     cache is cleared when the mesh changes, deformations (ALE) are
+     applied on top of the cached geometry.
+  */
+  class NGS_DLL_HEADER GeometryCache
+  {
+    size_t budget;
+    atomic<size_t> used{0};
+    atomic<size_t> hits{0}, misses{0};
+
+    // integration rules, identified by their points
+    struct Rule
+    {
+      int nr;
+      Array<SIMD<double>> coords;   // 3 per SIMD point
+      bool Matches (const SIMD_IntegrationRule & ir) const;
+    };
+    Array<unique_ptr<Rule>> rules;
+    std::unordered_multimap<size_t, int> rule_numbers;   // by hash
+    std::shared_mutex rules_mutex;
+    // last rule seen at an address of integration points, checked by its points
+    enum { NMEMO = 256 };
+    std::atomic<Rule*> rule_memo[NMEMO];
+
+    struct Shard
+    {
+      std::mutex mutex;
+      std::unordered_map<size_t, FlatArray<SIMD<double>>> entries;
+      Array<unique_ptr<SIMD<double>[]>> blocks;
+      size_t block_size = 0, block_used = 0;
+    };
+    enum { NSHARDS = 64 };
+    enum { BLOCK_SIZE = 1 << 15 };   // SIMD<double>s per arena block
+    Shard shards[NSHARDS];
+
+  public:
+    GeometryCache (size_t abudget) : budget(abudget)
+    {
+      for (auto & memo : rule_memo) memo = nullptr;
+    }
+
+    /// number of the integration rule in the cache, -1 if the budget is exhausted
+    int RuleNr (const SIMD_IntegrationRule & ir);
+    /// cached values of element and rule, empty if not available
+    FlatArray<SIMD<double>> Find (ElementId ei, int rulenr);
+    /// stores a copy of the values, if the budget allows
+    void Insert (ElementId ei, int rulenr, FlatArray<SIMD<double>> values);
+    void Clear ();
+
+    size_t Budget () const { return budget; }
+    size_t MemoryUsage () const { return used; }
+    size_t Hits () const { return hits; }
+    size_t Misses () const { return misses; }
+
+  private:
+    enum { MAX_RULES = 1 << 24 };   // rule numbers in the lower bits of a key
+    static size_t Key (ElementId ei, int rulenr)
+    {
+      assert (rulenr >= 0 && rulenr < MAX_RULES);
+      return (((size_t(ei.Nr()) << 24) + rulenr) << 2) + size_t(ei.VB());
+    }
+    // neighbouring elements go to different shards
+    Shard & GetShard (ElementId ei, int rulenr)
+    { return shards[(size_t(ei.Nr()) ^ size_t(rulenr)) % NSHARDS]; }
+  };
+
+
   class NGS_DLL_HEADER MeshAccess : public BaseStatusHandler
   {
     std::shared_ptr<netgen::Ngx_Mesh> mesh;
@@ -232,6 +306,9 @@ namespace ngcomp
     /// for ALE
     shared_ptr<GridFunction> deformation;  
 
+    /// optional cache of mapped integration rules
+    shared_ptr<GeometryCache> geometry_cache;
+
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
     
@@ -680,6 +757,10 @@ namespace ngcomp
       return deformation;
     }
 
+    /// cache geometry of curved elements, using at most budget bytes (0 disables)
+    void SetGeometryCache (size_t budget);
+    GeometryCache * GetGeometryCache () const { return geometry_cache.get(); }
+
     void SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr);
     /*
     {
@@ -1365,6 +1365,45 @@ active_dofs : BitArray or None
     ;
 
 
+  py::class_<ReorderedFESpace, shared_ptr<ReorderedFESpace>, CompressedFESpace>(m, "Reorder",
+	docu_string(R"delimiter(Wrapper Finite Element Spaces.
+The reordered fespace is a wrapper around a standard fespace which renumbers
+the dofs for memory locality of matrices and vectors. The renumbering is
+recomputed whenever the space is updated.
+
+Parameters:
+
+fespace : ngsolve.comp.FESpace
+    finite element space
+
+method : string
+    "rcm": reverse Cuthill-McKee ordering of the dof graph,
+    "sfc": dofs in order of the elements along a space-filling curve
+)delimiter"))
+    .def(py::init([] (shared_ptr<FESpace> & fes, string method)
+                  {
+                    if (dynamic_pointer_cast<CompoundFESpace> (fes))
+                      throw py::type_error("cannot reorder CompoundFESpace");
+                    auto ret = make_shared<ReorderedFESpace> (fes, method);
+                    ret->Update(glh);
+                    ret->FinalizeUpdate(glh);
+                    return ret;
+                  }), py::arg("fespace"), py::arg("method")="rcm")
+    .def(py::pickle([](const ReorderedFESpace* fes)
+                    {
+                      return py::make_tuple(fes->GetBaseSpace(),fes->GetMethod());
+                    },
+                    [] (py::tuple state) -> shared_ptr<ReorderedFESpace>
+                    {
+                      auto fes = make_shared<ReorderedFESpace>(state[0].cast<shared_ptr<FESpace>>(),
+                                                               state[1].cast<string>());
+                      fes->Update(glh);
+                      fes->FinalizeUpdate(glh);
+                      return fes;
+                    }))
+    ;
+
+
    m.def("CompressCompound", [](shared_ptr<FESpace> & fes, py::object active_dofs) -> shared_ptr<FESpace>
             {
               shared_ptr<CompoundFESpace> compspace = dynamic_pointer_cast<CompoundFESpace> (fes);
@@ -1481,8 +1520,13 @@ active_dofs : BitArray or None
     .def("Update", [](GF& self) { self.Update(); },
          "update vector size to finite element space dimension after mesh refinement")
     
-    .def("Save", [](GF& self, string filename, bool parallel)
+    .def("Save", [](GF& self, string filename, bool parallel, bool chunked)
          {
+           if (chunked)
+             {
+               self.SaveChunked(filename);
+               return;
+             }
            ofstream out(filename, ios::binary);
            if (parallel)
              self.Save(out);
@@ -1490,7 +1534,8 @@ active_dofs : BitArray or None
              for (auto d : self.GetVector().FVDouble())
                SaveBin(out, d);
          },
-         py::arg("filename"), py::arg("parallel")=false, docu_string(R"raw_string(
+         py::arg("filename"), py::arg("parallel")=false, py::arg("chunked")=false,
+         docu_string(R"raw_string(
 Saves the gridfunction into a file.
 
 Parameters:
@@ -1501,9 +1546,19 @@ filename : string
 parallel : bool
   input parallel
 
+chunked : bool
+  threads write node ranges in parallel, with MPI all ranks write
+  into the same file. Load with chunked=True. All dofs must belong
+  to mesh nodes, spaces with global dofs (e.g. NumberSpace) throw.
+
 )raw_string"))
-    .def("Load", [](GF& self, string filename, bool parallel)
+    .def("Load", [](GF& self, string filename, bool parallel, bool chunked)
          {
+           if (chunked)
+             {
+               self.LoadChunked(filename);
+               return;
+             }
            ifstream in(filename, ios::binary);
            if (parallel)
              self.Load(in);
@@ -1511,7 +1566,8 @@ parallel : bool
              for (auto & d : self.GetVector().FVDouble())
                LoadBin(in, d);
          },
-         py::arg("filename"), py::arg("parallel")=false, docu_string(R"raw_string(       
+         py::arg("filename"), py::arg("parallel")=false, py::arg("chunked")=false,
+         docu_string(R"raw_string(       
 Loads a gridfunction from a file.
 
 Parameters:
@@ -1522,6 +1578,10 @@ filename : string
 parallel : bool
   input parallel
 
+chunked : bool
+  file written with chunked=True, the mesh may be distributed
+  differently than when saving
+
 )raw_string"))
     .def("Set", 
          [](shared_ptr<GF> self, spCF cf,
@@ -1848,6 +1908,23 @@ space : ngsolve.FESpace
                      "  BilinearForm will not allocate memory for assembling.\n"
                      "  optimization feature for (nonlinear) problems where the\n"
                      "  form is only applied but never assembled.",
+                     py::arg("matrixfree") = "bool = False\n"
+                     "  Together with nonassemble: apply volume terms on quads and\n"
+                     "  hexes by sum factorization, with geometry and coefficients\n"
+                     "  stored at integration points. Set up by Assemble.",
+                     py::arg("batchassembly") = "bool = False\n"
+                     "  Compute the element matrices of low order volume elements\n"
+                     "  with the same reference element in batches, one element per\n"
+                     "  SIMD lane. For symbolic integrators on spaces of uniform order.",
+                     py::arg("blockassembly") = "bool = False\n"
+                     "  Assemble elements in spatially compact blocks instead of\n"
+                     "  colors, without barriers between colors. Element matrices\n"
+                     "  at block interfaces are added with atomic operations.",
+                     py::arg("blocksparse") = "bool = False\n"
+                     "  Store the matrix of a compound space of 2 or 3 equal\n"
+                     "  components (e.g. VectorH1) in dense blocks coupling the\n"
+                     "  components, with one column index per block. Falls back\n"
+                     "  to the scalar sparse matrix if no block structure is found.",
                      py::arg("project") = "bool = False\n"
                      "  When calling bf.Assemble, all saved coarse matrices from\n"
                      "  mesh refinements are updated as well using a Galerkin projection\n"
@@ -1902,6 +1979,11 @@ reallocate : bool
                                            return mat;
                                          }, "matrix of the assembled bilinear form")
 
+    .def_property_readonly("matrixfree_elements", &BF::NumMatrixFreeElements,
+                           "number of volume elements applied by the sum-factorized kernel, see matrixfree")
+    .def_property_readonly("batched_elements", &BF::NumBatchedElements,
+                           "number of volume elements assembled in batches, see batchassembly")
+
     .def_property_readonly("components", [](shared_ptr<BilinearForm> self)-> py::list
                    { 
                      py::list bfs;
@@ -3171,6 +3253,11 @@ element_vb : ngsolve.fem.VorB
               return;
              });
 
+   m.def("DoArchive", [](shared_ptr<Archive> & arch, GF & gf)
+         { gf.DoArchive(*arch); return arch; }, py::arg("archive"), py::arg("gf"));
+   m.def("DoArchive", [](shared_ptr<Archive> & arch, MeshAccess & ma)
+         { ma.ArchiveMesh(*arch); return arch; }, py::arg("archive"), py::arg("mesh"));
+
    py::class_<BaseVTKOutput, shared_ptr<BaseVTKOutput>>(m, "VTKOutput")
     .def(py::init([] (shared_ptr<MeshAccess> ma, py::list coefs_list,
                       py::list names_list, string filename, int subdivision, int only_element)
@@ -480,6 +480,36 @@ mesh (netgen.Mesh): a mesh generated from Netgen
 
     .def("UnsetDeformation", [](MeshAccess & ma){ ma.SetDeformation(nullptr);}, "Unset the deformation")
 
+    .def("SetGeometryCache",
+         [](MeshAccess & ma, double memory)
+         { ma.SetGeometryCache(size_t(memory*1024*1024)); }, py::arg("memory")=256,
+         docu_string(R"raw_string(
+Cache points and Jacobians of curved elements for SIMD integration rules,
+such that repeated assembly and operator application on a fixed mesh
+do not recompute the geometry. The cache is cleared when the mesh is
+refined or curved.
+
+Parameters:
+
+memory : float
+  memory budget in MB, 0 disables the cache
+
+)raw_string"))
+
+    .def("GetGeometryCacheStatistics",
+         [](MeshAccess & ma)
+         {
+           py::dict stats;
+           if (auto cache = ma.GetGeometryCache())
+             {
+               stats["memory"] = cache->MemoryUsage();
+               stats["budget"] = cache->Budget();
+               stats["hits"] = cache->Hits();
+               stats["misses"] = cache->Misses();
+             }
+           return stats;
+         }, "Memory usage, hits and misses of the geometry cache")
+
     .def("SetPML", 
 	 [](MeshAccess & ma,  shared_ptr<PML> apml, py::object definedon)
           {
@@ -3,6 +3,17 @@
 #include<l2hofe_impl.hpp>
 #include<l2hofefo.hpp>
 #include<regex>
+#include<thread>
+
+#ifndef WIN32
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <dlfcn.h>
+#endif
 
 namespace ngfem
 {
@@ -18,41 +29,66 @@ namespace ngfem
     {
         string name = "compiled_code_pointer" + ToString(id_counter++); 
         top += "extern \"C\" void* " + name + ";\n";
-        stringstream s_ptr;
 #ifdef WIN32
-        s_ptr << "0x";
+        pointer += "__declspec(dllexport) ";
 #endif
-        s_ptr << std::hex << p;
-        pointer += "void *" + name + " = reinterpret_cast<void*>(" + s_ptr.str() + ");\n";
+        pointer += "void *" + name + " = nullptr;\n";
+        pointers.push_back( {name, p} );
         return name;
     }
 
-    unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags )
+    // compiles the codes into the library prefix.so (prefix.dll)
+    static void CompileLibrary(const std::vector<string> &codes, const std::vector<string> &link_flags,
+                               string prefix)
     {
-      static int counter = 0;
       static ngstd::Timer tcompile("CompiledCF::Compile");
       static ngstd::Timer tlink("CompiledCF::Link");
+      // translation units are compiled in parallel, each by its own compiler process
+      size_t ntasks = codes.size();
+      size_t nthreads = min2(ntasks, size_t(max2(1u, std::thread::hardware_concurrency())));
+      if (const char * env = getenv("NGSOLVE_COMPILE_THREADS"))
+        nthreads = min2(ntasks, size_t(max2(1, atoi(env))));
+
+      std::vector<string> file_prefixes(ntasks);
+      std::vector<int> errors(ntasks, 0);
+      std::atomic<size_t> next(0);
+      auto compile = [&] ()
+        {
+          for (size_t i; (i = next++) < ntasks; )
+            {
+              string file_prefix = prefix+"_"+ToString(i);
+              file_prefixes[i] = file_prefix;
+              ofstream codefile(file_prefix+".cpp");
+              codefile << codes[i];
+              codefile.close();
+#ifdef WIN32
+              string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
+#else
+              string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
+#endif
+              errors[i] = system(scompile.c_str());
+            }
+        };
+
+      cout << IM(3) << "compiling " << ntasks << " files using " << nthreads << " threads..." << endl;
+      tcompile.Start();
+      std::vector<std::thread> threads;
+      for (size_t i = 1; i < nthreads; i++)
+        threads.emplace_back(compile);
+      compile();
+      for (auto & t : threads)
+        t.join();
+      tcompile.Stop();
+      for (int err : errors)
+        if (err) throw Exception ("problem calling compiler");
+
       string object_files;
-      int i = 0;
-      string prefix = "code" + ToString(counter++);
-      for(string code : codes) {
-        string file_prefix = prefix+"_"+ToString(i++);
-        ofstream codefile(file_prefix+".cpp");
-        codefile << code;
-        codefile.close();
-        cout << IM(3) << "compiling..." << endl;
-        tcompile.Start();
+      for (auto & file_prefix : file_prefixes)
 #ifdef WIN32
-        string scompile = "cmd /C \"ngscxx.bat " + file_prefix + ".cpp\"";
         object_files += file_prefix+".obj ";
 #else
-        string scompile = "ngscxx -c " + file_prefix + ".cpp -o " + file_prefix + ".o";
         object_files += file_prefix+".o ";
 #endif
-        int err = system(scompile.c_str());
-        if (err) throw Exception ("problem calling compiler");
-        tcompile.Stop();
-      }
 
       cout << IM(3) << "linking..." << endl;
       tlink.Start();
@@ -67,7 +103,210 @@ namespace ngfem
       if (err) throw Exception ("problem calling linker");      
       tlink.Stop();
       cout << IM(3) << "done" << endl;
+    }
+
+#ifndef WIN32
+    namespace code_cache
+    {
+      // directory of the cache, empty if disabled
+      static string Directory()
+      {
+        if (const char * env = getenv("NGSOLVE_CODE_CACHE"))
+          {
+            string dir = env;
+            if (dir == "" || dir == "0" || dir == "off")
+              return "";
+            return dir;
+          }
+        if (const char * xdg = getenv("XDG_CACHE_HOME"))
+          return string(xdg) + "/ngsolve/compiled";
+        if (const char * home = getenv("HOME"))
+          return string(home) + "/.cache/ngsolve/compiled";
+        return "";
+      }
+
+      static size_t MaxSize()
+      {
+        size_t mb = 1024;
+        if (const char * env = getenv("NGSOLVE_CODE_CACHE_SIZE"))
+          mb = atol(env);
+        return mb << 20;
+      }
+
+      static bool CreateDirectories(string dir)
+      {
+        for (size_t pos = 1; pos != string::npos; )
+          {
+            pos = dir.find('/', pos+1);
+            string sub = dir.substr(0, pos);
+            if (mkdir(sub.c_str(), 0755) != 0 && errno != EEXIST)
+              return false;
+          }
+        return true;
+      }
+
+      static string ReadFile(string filename)
+      {
+        ifstream in(filename, ios::binary);
+        stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+      }
+
+      // the scripts in the PATH, they contain compiler and flags
+      static string FindScript(string name)
+      {
+        const char * path = getenv("PATH");
+        if (!path) return name;
+        stringstream dirs(path);
+        string dir;
+        while (std::getline(dirs, dir, ':'))
+          if (access((dir+"/"+name).c_str(), X_OK) == 0)
+            return ReadFile(dir+"/"+name);
+        return name;
+      }
+
+      // changes with every build of this library: headers changed since
+      // the last build recompile this file, reinstalling changes the file time
+      static string BuildId()
+      {
+        string id = string(__DATE__) + " " + __TIME__;
+        Dl_info info;
+        struct stat st;
+        if (dladdr((void*)&BuildId, &info) && info.dli_fname &&
+            stat(info.dli_fname, &st) == 0)
+          id += string(" ") + info.dli_fname + " " + ToString(st.st_mtime);
+        return id;
+      }
+
+      // FNV-1a
+      static uint64_t Hash(const string & s)
+      {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char c : s)
+          {
+            h ^= c;
+            h *= 1099511628211ull;
+          }
+        return h;
+      }
+
+      class FileLock
+      {
+        int fd;
+      public:
+        FileLock(string filename, bool wait = true)
+        {
+          fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+          if (fd >= 0 && flock(fd, wait ? LOCK_EX : LOCK_EX | LOCK_NB) != 0)
+            {
+              close(fd);
+              fd = -1;
+            }
+        }
+        ~FileLock() { if (fd >= 0) close(fd); }
+        bool Locked() const { return fd >= 0; }
+      };
+
+      // removes least recently used libraries, if the cache is too large
+      static void Evict(string dir, string keep)
+      {
+        struct Entry { time_t time; size_t size; string name; };
+        std::vector<Entry> entries;
+        size_t total = 0;
+        DIR * d = opendir(dir.c_str());
+        if (!d) return;
+        while (auto e = readdir(d))
+          {
+            string name = e->d_name;
+            if (name.size() < 4 || name.substr(name.size()-3) != ".so") continue;
+            struct stat st;
+            if (stat((dir+"/"+name).c_str(), &st) != 0) continue;
+            entries.push_back( { st.st_mtime, size_t(st.st_size), name.substr(0, name.size()-3) } );
+            total += st.st_size;
+          }
+        closedir(d);
+
+        size_t maxsize = MaxSize();
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry & a, const Entry & b) { return a.time < b.time; });
+        for (auto & e : entries)
+          {
+            if (total <= maxsize) break;
+            if (e.name == keep) continue;
+            // skip entries being compiled right now. Libraries already loaded
+            // by other processes may be removed, their mappings stay valid
+            string base = dir+"/"+e.name;
+            FileLock lock(base+".lock", false);
+            if (!lock.Locked()) continue;
+            unlink((base+".so").c_str());
+            unlink((base+".key").c_str());
+            unlink((base+".lock").c_str());
+            total -= e.size;
+          }
+      }
+    }
+#endif
+
+    unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &link_flags )
+    {
+      static int counter = 0;
       auto library = make_unique<SharedLibrary>();
+
+#ifndef WIN32
+      string dir = code_cache::Directory();
+      if (dir != "" && code_cache::CreateDirectories(dir))
+        {
+          static ngstd::Timer tcache("CompiledCF::Cache");
+          RegionTimer reg(tcache);
+
+          // everything the library depends on
+          static string compiler = code_cache::FindScript("ngscxx") + code_cache::FindScript("ngsld");
+          static string build_id = code_cache::BuildId();
+          string key = ngsolve_version + "\n" + build_id + "\n" + compiler + "\n";
+          for (auto & flag : link_flags)
+            key += flag + "\n";
+          for (auto & code : codes)
+            key += ToString(code.size()) + "\n" + code;
+
+          stringstream shash;
+          shash << std::hex << std::setw(16) << std::setfill('0') << code_cache::Hash(key);
+          string base = dir + "/" + shash.str();
+
+          {
+            // only one process compiles, the others wait and use its library
+            code_cache::FileLock lock(base+".lock");
+            struct stat st;
+            if (stat((base+".so").c_str(), &st) == 0 && code_cache::ReadFile(base+".key") == key)
+              {
+                cout << IM(3) << "using cached library " << base << ".so" << endl;
+                utime((base+".so").c_str(), nullptr);
+              }
+            else
+              {
+                string tmp = base + "_" + ToString(getpid()) + "_" + ToString(counter++);
+                CompileLibrary(codes, link_flags, tmp);
+                ofstream(tmp+".key", ios::binary) << key;
+                // other processes see complete files only
+                if (rename((tmp+".key").c_str(), (base+".key").c_str()) != 0 ||
+                    rename((tmp+".so").c_str(), (base+".so").c_str()) != 0)
+                  throw Exception ("cannot store compiled code in cache " + dir);
+                for (size_t i = 0; i < codes.size(); i++)
+                  {
+                    string file_prefix = tmp+"_"+ToString(i);
+                    unlink((file_prefix+".cpp").c_str());
+                    unlink((file_prefix+".o").c_str());
+                  }
+              }
+            library->Load(base+".so");
+          }
+          code_cache::Evict(dir, shash.str());
+          return library;
+        }
+#endif
+
+      string prefix = "code" + ToString(counter++);
+      CompileLibrary(codes, link_flags, prefix);
 #ifdef WIN32
       library->Load(prefix+".dll");
 #else
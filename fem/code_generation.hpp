@@ -46,6 +46,9 @@ namespace ngfem
     std::vector<string> link_flags;
 
     string pointer;
+    // addresses are set after loading the library, such that the
+    // code does not depend on them and can be cached
+    std::vector<std::pair<string, const void*>> pointers;
 
     string AddPointer(const void *p );
 
@@ -174,6 +177,13 @@ namespace ngfem
     }
   }
 
+  /**
+     Compiles and links the codes into a shared library. The codes are
+     compiled in parallel ($NGSOLVE_COMPILE_THREADS). Libraries are
+     cached by a hash of code, compiler, flags and NGSolve build in
+     $NGSOLVE_CODE_CACHE (default ~/.cache/ngsolve/compiled, "off"
+     disables the cache), limited to $NGSOLVE_CODE_CACHE_SIZE MB.
+  */
   unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries );
   namespace detail {
       string GenerateL2ElementCode(int order);
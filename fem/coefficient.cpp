@@ -11,6 +11,7 @@
 #include <fem.hpp>
 #include <../ngstd/evalfunc.hpp>
 #include <algorithm>
+#include <condition_variable>
 
 namespace ngstd
 {
@@ -3656,16 +3657,71 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     int totdim;
     Array<bool> is_complex;
     // Array<Timer*> timers;
-    unique_ptr<SharedLibrary> library;
-    lib_function compiled_function = nullptr;
-    lib_function_simd compiled_function_simd = nullptr;
-    lib_function_deriv compiled_function_deriv = nullptr;
-    lib_function_simd_deriv compiled_function_simd_deriv = nullptr;
-    lib_function_dderiv compiled_function_dderiv = nullptr;
-    lib_function_simd_dderiv compiled_function_simd_dderiv = nullptr;
 
-    lib_function_complex compiled_function_complex = nullptr;
-    lib_function_simd_complex compiled_function_simd_complex = nullptr;
+    /*
+      Tape for the interpreter: constants are folded, equal operations
+      on equal inputs are merged, and unused steps are dropped.
+      Arithmetic operations are evaluated in registers holding blocks of
+      points, other steps by their Evaluate. Only values needed by these
+      steps, or by the next block of arithmetic operations, go to memory.
+    */
+    enum TAPE_OP : char { TAPE_STEP, TAPE_LOAD, TAPE_ADD, TAPE_SUB, TAPE_MULT, TAPE_DIV };
+    struct TapeInstruction
+    {
+      TAPE_OP op;
+      int step;          // step computed (or loaded) by the instruction
+      int reg = -1;      // first register of the result
+      int a = -1, b = -1;   // registers of operands
+      bool store = false;   // write result to memory
+    };
+    struct TapeConstant
+    {
+      int step;
+      int reg;
+      double value;
+    };
+    Array<TapeInstruction> tape;
+    Array<TapeConstant> tape_constants;
+    Array<int> alias;       // steps are replaced by an equal earlier step
+    Array<bool> stored;     // steps needing memory
+    int num_regs = 0;
+    enum { REG_BLOCK = 16 };
+
+    struct CompiledFunctions
+    {
+      unique_ptr<SharedLibrary> library;
+      lib_function compiled_function = nullptr;
+      lib_function_simd compiled_function_simd = nullptr;
+      lib_function_deriv compiled_function_deriv = nullptr;
+      lib_function_simd_deriv compiled_function_simd_deriv = nullptr;
+      lib_function_dderiv compiled_function_dderiv = nullptr;
+      lib_function_simd_dderiv compiled_function_simd_dderiv = nullptr;
+
+      lib_function_complex compiled_function_complex = nullptr;
+      lib_function_simd_complex compiled_function_simd_complex = nullptr;
+    };
+    // the interpreted steps are used until the library is loaded,
+    // then all functions are published at once. A published library is
+    // never replaced, evaluations may still run in its code.
+    unique_ptr<CompiledFunctions> compiled_functions;
+    std::atomic<const CompiledFunctions*> compiled{nullptr};
+    const CompiledFunctions * Compiled() const { return compiled.load(std::memory_order_acquire); }
+
+    enum COMPILE_STATE { NOT_COMPILED, COMPILING, COMPILED, COMPILE_FAILED };
+    mutable std::mutex compile_mutex;
+    mutable std::condition_variable compile_done;
+    COMPILE_STATE compile_state = NOT_COMPILED;
+    string compile_error;
+
+    void SetCompileState (COMPILE_STATE state, string error = "")
+    {
+      {
+        lock_guard<mutex> guard(compile_mutex);
+        compile_state = state;
+        compile_error = error;
+      }
+      compile_done.notify_all();
+    }
 
   public:
     CompiledCoefficientFunction (shared_ptr<CoefficientFunction> acf)
@@ -3708,26 +3764,209 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
          });
       cout << IM(3) << "inputs = " << endl << inputs << endl;
 
+      BuildTape();
+    }
+
+  private:
+    // operations which are evaluated by the tape
+    TAPE_OP ArithmeticOp (CoefficientFunction & stepcf) const
+    {
+      if (stepcf.IsComplex()) return TAPE_STEP;
+      switch (stepcf.GetType())
+        {
+        case CF_Type_add: case CF_Type_sub: case CF_Type_mult: case CF_Type_div:
+          {
+            // other products return CF_Type_mult as well
+            string descr = stepcf.GetDescription();
+            if (descr == "binary operation '+'") return TAPE_ADD;
+            if (descr == "binary operation '-'") return TAPE_SUB;
+            if (descr == "binary operation '*'") return TAPE_MULT;
+            if (descr == "binary operation '/'") return TAPE_DIV;
+            return TAPE_STEP;
+          }
+        default:
+          return TAPE_STEP;
+        }
+    }
+
+    bool IsConstant (CoefficientFunction & stepcf) const
+    {
+      return stepcf.GetType() == CF_Type_constant && !stepcf.IsComplex() && stepcf.Dimension() == 1;
+    }
+
+    void BuildTape ()
+    {
+      size_t n = steps.Size();
+
+      // common subexpressions
+      alias.SetSize(n);
+      for (size_t i = 0; i < n; i++)
+        {
+          alias[i] = i;
+          auto & cfi = *steps[i];
+          bool constant = IsConstant(cfi);
+          if (!constant && ArithmeticOp(cfi) == TAPE_STEP) continue;
+          for (size_t j = 0; j < i; j++)
+            {
+              auto & cfj = *steps[j];
+              if (alias[j] != int(j) || typeid(cfi) != typeid(cfj) ||
+                  dim[i] != dim[j] || cfi.GetDescription() != cfj.GetDescription())
+                continue;
+              if (constant && (!IsConstant(cfj) || cfi.EvaluateConst() != cfj.EvaluateConst()))
+                continue;
+              if (!constant && (inputs[i].Size() != inputs[j].Size() ||
+                                alias[inputs[i][0]] != alias[inputs[j][0]] ||
+                                alias[inputs[i][1]] != alias[inputs[j][1]]))
+                continue;
+              alias[i] = j;
+              break;
+            }
+        }
+
+      // constant folding
+      Array<bool> is_const(n);
+      Array<double> values(n);
+      is_const = false;
+      for (size_t i = 0; i < n; i++)
+        {
+          if (alias[i] != int(i)) continue;
+          if (IsConstant(*steps[i]))
+            {
+              is_const[i] = true;
+              values[i] = steps[i]->EvaluateConst();
+              continue;
+            }
+          auto op = ArithmeticOp(*steps[i]);
+          if (op == TAPE_STEP || dim[i] != 1) continue;
+          int a = alias[inputs[i][0]], b = alias[inputs[i][1]];
+          if (!is_const[a] || !is_const[b]) continue;
+          is_const[i] = true;
+          switch (op)
+            {
+            case TAPE_ADD: values[i] = values[a] + values[b]; break;
+            case TAPE_SUB: values[i] = values[a] - values[b]; break;
+            case TAPE_MULT: values[i] = values[a] * values[b]; break;
+            case TAPE_DIV: values[i] = values[a] / values[b]; break;
+            default: ;
+            }
+        }
+
+      // dead steps
+      Array<bool> live(n);
+      live = false;
+      live[n-1] = true;
+      for (size_t i = n; i-- > 0; )
+        if (live[i] && !is_const[i])
+          for (int in : inputs[i])
+            live[alias[in]] = true;
+
+      stored.SetSize(n);
+      stored = false;
+      stored[n-1] = true;
+      tape.SetSize0();
+      tape_constants.SetSize0();
+      num_regs = 0;
+
+      Array<int> regs(n);         // registers in the current block of arithmetic operations
+      regs = -1;
+      Array<int> block_steps;     // steps having registers in the current block
+      for (size_t i = 0; i < n; i++)
+        {
+          if (!live[i]) continue;
+          if (is_const[i])
+            {
+              // registers of constants are set once, and kept
+              tape_constants.Append ( { int(i), num_regs, values[i] } );
+              num_regs++;
+              continue;
+            }
+          auto op = ArithmeticOp(*steps[i]);
+          if (op == TAPE_STEP)
+            {
+              for (int in : inputs[i])
+                stored[alias[in]] = true;
+              TapeInstruction ins;
+              ins.op = TAPE_STEP;
+              ins.step = i;
+              tape.Append (ins);
+              for (int s : block_steps)
+                regs[s] = -1;
+              block_steps.SetSize0();
+              continue;
+            }
+
+          auto reg_of = [&] (int in)
+            {
+              in = alias[in];
+              if (is_const[in])
+                {
+                  for (auto & c : tape_constants)
+                    if (c.step == in) return c.reg;
+                }
+              if (regs[in] == -1)
+                {
+                  stored[in] = true;
+                  TapeInstruction load;
+                  load.op = TAPE_LOAD;
+                  load.step = in;
+                  load.reg = num_regs;
+                  tape.Append (load);
+                  regs[in] = num_regs;
+                  block_steps.Append (in);
+                  num_regs += dim[in];
+                }
+              return regs[in];
+            };
+          TapeInstruction ins;
+          ins.op = op;
+          ins.step = i;
+          ins.a = reg_of (inputs[i][0]);
+          ins.b = reg_of (inputs[i][1]);
+          ins.reg = num_regs;
+          num_regs += dim[i];
+          regs[i] = ins.reg;
+          block_steps.Append (i);
+          tape.Append (ins);
+        }
+      for (auto & ins : tape)
+        if (ins.op != TAPE_STEP && ins.op != TAPE_LOAD)
+          ins.store = stored[ins.step];
+
+      int num_live = 0;
+      for (bool l : live) if (l) num_live++;
+      cout << IM(3) << "tape: " << n << " steps, " << num_live << " live, "
+           << tape_constants.Size() << " constants, " << tape.Size() << " instructions" << endl;
+    }
+
+  public:
+
+    bool IsCompiled () const { return Compiled() != nullptr; }
+
+    /// blocks until a compilation started by RealCompile is finished
+    void WaitCompiled () const
+    {
+      unique_lock<mutex> guard(compile_mutex);
+      compile_done.wait (guard, [this] () { return compile_state != COMPILING; });
+      if (compile_state == COMPILE_FAILED)
+        throw Exception ("Compilation of CoefficientFunction failed: " + compile_error);
     }
 
     void RealCompile(int maxderiv, bool wait)
     {
         std::vector<string> link_flags;
+        std::vector<std::pair<string, const void*>> pointers;
         if(cf->IsComplex())
             maxderiv = 0;
-        stringstream s;
         string pointer_code;
-        string top_code = ""
-             "#include<fem.hpp>\n"
-             "using namespace ngfem;\n"
-             "extern \"C\" {\n"
-             ;
+        // one translation unit per variant, they are compiled in parallel
+        std::vector<string> codes;
 
         string parameters[3] = {"results", "deriv", "dderiv"};
 
         for (int deriv : Range(maxderiv+1))
         for (auto simd : {false,true}) {
             cout << IM(3) << "Compiled CF:" << endl;
+            stringstream s;
             Code code;
             code.is_simd = simd;
             code.deriv = deriv;
@@ -3737,7 +3976,7 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             }
 
             pointer_code += code.pointer;
-            top_code += code.top;
+            pointers.insert(pointers.end(), code.pointers.begin(), code.pointers.end());
 
             // set results
             string scal_type = cf->IsComplex() ? "Complex" : "double";
@@ -3811,54 +4050,84 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
             s << "auto & ip = mir[i];" << endl;
             s << code.body << endl;
             s << "}\n}" << endl << endl;
+            s << "}" << endl;
+            codes.push_back("#include<fem.hpp>\n"
+                            "using namespace ngfem;\n"
+                            "extern \"C\" {\n" + code.top + s.str());
 
             for(const auto &lib : code.link_flags)
                 if(std::find(std::begin(link_flags), std::end(link_flags), lib) == std::end(link_flags))
                     link_flags.push_back(lib);
 
         }
-        s << "}" << endl;
-        string file_code = top_code + s.str();
-        std::vector<string> codes;
-        codes.push_back(file_code);
         if(pointer_code.size()) {
           pointer_code = "extern \"C\" {\n" + pointer_code;
           pointer_code += "}\n";
           codes.push_back(pointer_code);
         }
 
+        {
+          lock_guard<mutex> guard(compile_mutex);
+          if (compile_state == COMPILING || compile_state == COMPILED)
+            throw Exception ("CompiledCoefficientFunction::RealCompile: already compiled");
+          compile_state = COMPILING;
+        }
+
         auto self = shared_from_this();
-        auto compile_func = [self, codes, link_flags, maxderiv] () {
-              self->library = CompileCode( codes, link_flags );
+        auto compile_func = [self, codes, link_flags, pointers, maxderiv] () {
+            try {
+              auto fc = make_unique<CompiledFunctions>();
+              fc->library = CompileCode( codes, link_flags );
+              auto & library = fc->library;
+              for (auto & p : pointers)
+                *library->GetFunction<const void**>(p.first) = p.second;
               if(self->cf->IsComplex())
               {
-                  self->compiled_function_simd_complex = self->library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
-                  self->compiled_function_complex = self->library->GetFunction<lib_function_complex>("CompiledEvaluate");
+                  fc->compiled_function_simd_complex = library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
+                  fc->compiled_function_complex = library->GetFunction<lib_function_complex>("CompiledEvaluate");
               }
               else
               {
-                  self->compiled_function_simd = self->library->GetFunction<lib_function_simd>("CompiledEvaluateSIMD");
-                  self->compiled_function = self->library->GetFunction<lib_function>("CompiledEvaluate");
+                  fc->compiled_function_simd = library->GetFunction<lib_function_simd>("CompiledEvaluateSIMD");
+                  fc->compiled_function = library->GetFunction<lib_function>("CompiledEvaluate");
                   if(maxderiv>0)
                   {
-                      self->compiled_function_simd_deriv = self->library->GetFunction<lib_function_simd_deriv>("CompiledEvaluateDerivSIMD");
-                      self->compiled_function_deriv = self->library->GetFunction<lib_function_deriv>("CompiledEvaluateDeriv");
+                      fc->compiled_function_simd_deriv = library->GetFunction<lib_function_simd_deriv>("CompiledEvaluateDerivSIMD");
+                      fc->compiled_function_deriv = library->GetFunction<lib_function_deriv>("CompiledEvaluateDeriv");
                   }
                   if(maxderiv>1)
                   {
-                      self->compiled_function_simd_dderiv = self->library->GetFunction<lib_function_simd_dderiv>("CompiledEvaluateDDerivSIMD");
-                      self->compiled_function_dderiv = self->library->GetFunction<lib_function_dderiv>("CompiledEvaluateDDeriv");
+                      fc->compiled_function_simd_dderiv = library->GetFunction<lib_function_simd_dderiv>("CompiledEvaluateDDerivSIMD");
+                      fc->compiled_function_dderiv = library->GetFunction<lib_function_dderiv>("CompiledEvaluateDDeriv");
                   }
               }
+              // published once, owned until the CoefficientFunction dies
+              self->compiled_functions = move(fc);
+              self->compiled.store(self->compiled_functions.get(), std::memory_order_release);
+              self->SetCompileState (COMPILED);
               cout << IM(7) << "Compilation done" << endl;
+            }
+            catch (const std::exception & e)
+            {
+              self->SetCompileState (COMPILE_FAILED, e.what());
+              throw;
+            }
         };
         if(wait)
             compile_func();
         else
         {
+          // evaluations use the interpreted steps until the compiled code is ready
           try {
-            std::thread( compile_func ).detach();
+            std::thread( [compile_func] ()
+                         {
+                           try { compile_func(); }
+                           catch (const std::exception &e) {
+                             cerr << IM(3) << "Compilation of CoefficientFunction failed: " << e.what() << endl;
+                           }
+                         }).detach();
           } catch (const std::exception &e) {
+              SetCompileState (COMPILE_FAILED, e.what());
               cerr << IM(3) << "Compilation of CoefficientFunction failed: " << e.what() << endl;
           }
         }
@@ -3903,24 +4172,84 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     void T_Evaluate (const MIR & ir,
                      BareSliceMatrix<T,ORD> values) const
     {
-      ArrayMem<T, 1000> hmem(ir.Size()*totdim);
+      size_t np = ir.Size();
+      size_t memsize = 0;
+      for (size_t i = 0; i < steps.Size()-1; i++)
+        if (stored[i]) memsize += np*dim[i];
+      ArrayMem<T, 1000> hmem(memsize);
       size_t mem_ptr = 0;
       ArrayMem<BareSliceMatrix<T,ORD>,100> temp(steps.Size());
       ArrayMem<BareSliceMatrix<T,ORD>, 100> in(max_inputsize);
       for (size_t i = 0; i < steps.Size()-1; i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ORD> (FlatMatrix<T,ORD> (dim[i], ir.Size(), &hmem[mem_ptr]));
-          mem_ptr += ir.Size()*dim[i];
-        }
+        if (stored[i])
+          {
+            new (&temp[i]) BareSliceMatrix<T,ORD> (FlatMatrix<T,ORD> (dim[i], np, &hmem[mem_ptr]));
+            mem_ptr += np*dim[i];
+          }
       
       new (&temp.Last()) BareSliceMatrix<T,ORD>(values);
 
-      for (size_t i = 0; i < steps.Size(); i++)
+      ArrayMem<T, 20*REG_BLOCK> regs(num_regs*REG_BLOCK);
+      for (auto & c : tape_constants)
         {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T,ORD> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
+          T val(c.value);
+          for (size_t j = 0; j < REG_BLOCK; j++)
+            regs[c.reg*REG_BLOCK+j] = val;
+          if (stored[c.step])
+            for (size_t j = 0; j < np; j++)
+              temp[c.step](0,j) = val;
+        }
+
+      for (size_t i = 0; i < tape.Size(); )
+        {
+          if (tape[i].op == TAPE_STEP)
+            {
+              int step = tape[i].step;
+              auto inputi = inputs[step];
+              for (int nr : Range(inputi))
+                new (&in[nr]) BareSliceMatrix<T,ORD> (temp[alias[inputi[nr]]]);
+              steps[step] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[step]);
+              i++;
+              continue;
+            }
+
+          // a block of arithmetic operations, evaluated in registers
+          size_t next = i;
+          while (next < tape.Size() && tape[next].op != TAPE_STEP) next++;
+          for (size_t first = 0; first < np; first += REG_BLOCK)
+            {
+              size_t nb = min2(size_t(REG_BLOCK), np-first);
+              for (auto & ins : tape.Range(i, next))
+                for (int k = 0; k < dim[ins.step]; k++)
+                  {
+                    T * r = &regs[(ins.reg+k)*REG_BLOCK];
+                    const T * a = (ins.a >= 0) ? &regs[(ins.a+k)*REG_BLOCK] : nullptr;
+                    const T * b = (ins.b >= 0) ? &regs[(ins.b+k)*REG_BLOCK] : nullptr;
+                    switch (ins.op)
+                      {
+                      case TAPE_LOAD:
+                        for (size_t j = 0; j < nb; j++) r[j] = temp[ins.step](k, first+j);
+                        break;
+                      case TAPE_ADD:
+                        for (size_t j = 0; j < nb; j++) r[j] = a[j] + b[j];
+                        break;
+                      case TAPE_SUB:
+                        for (size_t j = 0; j < nb; j++) r[j] = a[j] - b[j];
+                        break;
+                      case TAPE_MULT:
+                        for (size_t j = 0; j < nb; j++) r[j] = a[j] * b[j];
+                        break;
+                      case TAPE_DIV:
+                        for (size_t j = 0; j < nb; j++) r[j] = a[j] / b[j];
+                        break;
+                      default: ;
+                      }
+                    if (ins.store)
+                      for (size_t j = 0; j < nb; j++)
+                        temp[ins.step](k, first+j) = r[j];
+                  }
+            }
+          i = next;
         }
     }
     
@@ -3970,9 +4299,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     
     virtual void Evaluate (const BaseMappedIntegrationRule & ir, BareSliceMatrix<double> values) const
     {
-      if(compiled_function)
+      if (auto fc = Compiled(); fc && fc->compiled_function)
       {
-        compiled_function(ir,values);
+        fc->compiled_function(ir,values);
         return;
       }
 
@@ -4022,9 +4351,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     virtual void Evaluate (const BaseMappedIntegrationRule & ir, 
                            BareSliceMatrix<AutoDiff<1,double>> values) const
     {
-      if(compiled_function_deriv)
+      if (auto fc = Compiled(); fc && fc->compiled_function_deriv)
         {
-          compiled_function_deriv(ir, values);
+          fc->compiled_function_deriv(ir, values);
           return;
         }
 
@@ -4061,9 +4390,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     virtual void Evaluate (const BaseMappedIntegrationRule & ir, 
                            BareSliceMatrix<AutoDiffDiff<1,double>> values) const
     {
-      if(compiled_function_dderiv)
+      if (auto fc = Compiled(); fc && fc->compiled_function_dderiv)
       {
-        compiled_function_dderiv(ir, values);
+        fc->compiled_function_dderiv(ir, values);
         return;
       }
 
@@ -4100,9 +4429,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir, 
                            BareSliceMatrix<AutoDiff<1,SIMD<double>>> values) const
     {
-      if(compiled_function_simd_deriv)
+      if (auto fc = Compiled(); fc && fc->compiled_function_simd_deriv)
         {
-          compiled_function_simd_deriv(ir, values);
+          fc->compiled_function_simd_deriv(ir, values);
           return;
         }
 
@@ -4141,9 +4470,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir, 
                            BareSliceMatrix<AutoDiffDiff<1,SIMD<double>>> values) const
     {
-      if(compiled_function_simd_dderiv)
+      if (auto fc = Compiled(); fc && fc->compiled_function_simd_dderiv)
       {
-        compiled_function_simd_dderiv(ir, values);
+        fc->compiled_function_simd_dderiv(ir, values);
         return;
       }
       
@@ -4181,9 +4510,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
     
     virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<double>> values) const
     {
-      if(compiled_function_simd)
+      if (auto fc = Compiled(); fc && fc->compiled_function_simd)
       {
-        compiled_function_simd(ir, values);
+        fc->compiled_function_simd(ir, values);
         return;
       }
 
@@ -4222,9 +4551,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
     virtual void Evaluate (const BaseMappedIntegrationRule & ir, FlatMatrix<Complex> values) const
     {
-      if(compiled_function_complex)
+      if (auto fc = Compiled(); fc && fc->compiled_function_complex)
       {
-          compiled_function_complex(ir,values);
+          fc->compiled_function_complex(ir,values);
           return;
       }
       else
@@ -4235,9 +4564,9 @@ shared_ptr<CoefficientFunction> MakeCoordinateCoefficientFunction (int comp)
 
     virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values) const
     {
-      if(compiled_function_simd_complex)
+      if (auto fc = Compiled(); fc && fc->compiled_function_simd_complex)
       {
-        compiled_function_simd_complex(ir,values);
+        fc->compiled_function_simd_complex(ir,values);
         return;
       }
       else
@@ -4629,6 +4958,18 @@ class RealCF : public CoefficientFunctionNoDerivative
     return cf;
   }
 
+  bool IsCompiled (shared_ptr<CoefficientFunction> cf)
+  {
+    auto ccf = dynamic_pointer_cast<CompiledCoefficientFunction> (cf);
+    return ccf && ccf->IsCompiled();
+  }
+
+  void WaitCompiled (shared_ptr<CoefficientFunction> cf)
+  {
+    if (auto ccf = dynamic_pointer_cast<CompiledCoefficientFunction> (cf))
+      ccf->WaitCompiled();
+  }
+
   
 }
 
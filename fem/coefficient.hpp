@@ -1653,6 +1653,10 @@ INLINE shared_ptr<CoefficientFunction> BinaryOpCF(shared_ptr<CoefficientFunction
   
   NGS_DLL_HEADER
   shared_ptr<CoefficientFunction> Compile (shared_ptr<CoefficientFunction> c, bool realcompile=false, int maxderiv=2, bool wait=false);
+  /// true if the library of a compiled CoefficientFunction is loaded
+  NGS_DLL_HEADER bool IsCompiled (shared_ptr<CoefficientFunction> cf);
+  /// waits for a compilation started with wait=false, throws if it failed
+  NGS_DLL_HEADER void WaitCompiled (shared_ptr<CoefficientFunction> cf);
 }
 
 
@@ -78,5 +78,46 @@ namespace ngfem
     for (int i = 0; i < GetNComponents(); i++)
       (*this)[i].Print (ost);
   }
+
+
+
+  atomic<size_t> ShapeCaches::memory_usage { 0 };
+  atomic<size_t> ShapeCaches::max_memory { size_t(64) << 20 };
+  atomic<bool> ShapeCaches::enabled { true };
+
+  // created by the first cache, and therefore destroyed after all caches
+  static mutex & ShapeCachesMutex ()
+  {
+    static mutex m;
+    return m;
+  }
+
+  static Array<ShapeCacheBase*> & ShapeCachesList ()
+  {
+    static Array<ShapeCacheBase*> caches;
+    return caches;
+  }
+
+  void ShapeCaches :: Register (ShapeCacheBase * cache)
+  {
+    lock_guard<mutex> guard(ShapeCachesMutex());
+    ShapeCachesList().Append (cache);
+  }
+
+  void ShapeCaches :: Unregister (ShapeCacheBase * cache)
+  {
+    lock_guard<mutex> guard(ShapeCachesMutex());
+    auto & caches = ShapeCachesList();
+    auto pos = caches.Pos (cache);
+    if (pos != caches.ILLEGAL_POSITION)
+      caches.DeleteElement (pos);
+  }
+
+  void ShapeCaches :: Clear ()
+  {
+    lock_guard<mutex> guard(ShapeCachesMutex());
+    for (auto cache : ShapeCachesList())
+      cache->Clear();
+  }
 }
 
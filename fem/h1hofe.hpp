@@ -131,6 +131,22 @@ namespace ngfem
       order = ho;
     }
 
+    /// shapes are determined by the orders and the vertex ordering
+    bool GetShapeCacheKey (ShapeCacheKey & key) const
+    {
+      if (!is_same<SHAPES,H1HighOrderFE_Shape<ET>>::value || order < 2)
+        return false;
+      if (!key.AddVertexRanks (this->vnums, N_VERTEX)) return false;
+      for (int i = 0; i < N_EDGE; i++)
+        if (!key.Add (order_edge[i])) return false;
+      for (int i = 0; i < N_FACE; i++)
+        if (!key.Add (order_face[i][0]) || !key.Add (order_face[i][1])) return false;
+      for (int i = 0; i < N_CELL; i++)
+        for (int j = 0; j < 3; j++)
+          if (!key.Add (order_cell[i][j])) return false;
+      return key.Add (nodalp2);
+    }
+
 
   };
 
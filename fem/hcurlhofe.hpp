@@ -124,6 +124,27 @@ namespace ngfem
     
     void ComputeNDof();
 
+    /// shapes are determined by the orders, the gradient flags and the vertex ordering
+    bool GetShapeCacheKey (ShapeCacheKey & key) const
+    {
+      if (!is_same<BASE,T_HCurlHighOrderFiniteElement<ET,HCurlHighOrderFE_Shape<ET>>>::value
+          || order < 2)
+        return false;
+      if (!key.AddVertexRanks (vnums, N_VERTEX)) return false;
+      for (int i = 0; i < N_EDGE; i++)
+        if (!key.Add (order_edge[i]) || !key.Add (usegrad_edge[i])) return false;
+      for (int i = 0; i < N_FACE; i++)
+        if (!key.Add (order_face[i][0]) || !key.Add (order_face[i][1]) ||
+            !key.Add (usegrad_face[i])) return false;
+      if (DIM == 3)
+        {
+          for (int j = 0; j < 3; j++)
+            if (!key.Add (order_cell[j])) return false;
+          if (!key.Add (usegrad_cell)) return false;
+        }
+      return key.Add (type1) && key.Add (order);
+    }
+
     virtual void CalcDualShape (const MappedIntegrationPoint<DIM,DIM> & mip, SliceMatrix<> shape) const;
     virtual void CalcDualShape (const SIMD_MappedIntegrationRule<DIM,DIM> & mir, BareSliceMatrix<SIMD<double>> shape) const;
     virtual void EvaluateDual (const SIMD_MappedIntegrationRule<DIM,DIM> & mir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const;
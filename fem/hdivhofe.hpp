@@ -377,6 +377,18 @@ namespace ngfem
       RT = aRT; 
     };  
 
+    /// shapes are determined by the orders, the flags and the vertex ordering
+    bool GetShapeCacheKey (ShapeCacheKey & key) const
+    {
+      if (order < 2) return false;
+      if (!key.AddVertexRanks (vnums, N_VERTEX)) return false;
+      for (int i = 0; i < DIM; i++)
+        if (!key.Add (order_inner[i])) return false;
+      for (int i = 0; i < N_FACET; i++)
+        for (int j = 0; j < DIM-1; j++)
+          if (!key.Add (order_facet[i][j])) return false;
+      return key.Add (ho_div_free) && key.Add (only_ho_div) && key.Add (RT) && key.Add (order);
+    }
     
     virtual void ComputeNDof();
     virtual ELEMENT_TYPE ElementType() const { return ET; }
@@ -105,6 +105,17 @@ namespace ngfem
         order = max2(order, order_inner[i]);
     }
 
+    /// shapes are determined by the orders and the vertex ordering
+    bool GetShapeCacheKey (ShapeCacheKey & key) const
+    {
+      if (!is_same<SHAPES,L2HighOrderFE_Shape<ET>>::value || order < 2)
+        return false;
+      if (!key.AddVertexRanks (vnums, N_VERTEX)) return false;
+      for (int i = 0; i < DIM; i++)
+        if (!key.Add (order_inner[i])) return false;
+      return key.Add (order);
+    }
+
     NGS_DLL_HEADER virtual void PrecomputeTrace ();
     NGS_DLL_HEADER virtual void PrecomputeGrad ();
     NGS_DLL_HEADER virtual void PrecomputeShapes (const IntegrationRule & ir);
@@ -1,3 +1,6 @@
+#ifndef FILE_PRECOMP
+#define FILE_PRECOMP
+
 namespace ngfem
 {
 
@@ -57,4 +60,213 @@ public:
 };
 
 
+
+
+
+  /*
+    Shape function tables on reference integration rules.
+
+    Elements with equal keys (element class, orders, relative ordering
+    of the vertex numbers) have equal shape functions, so the shapes
+    and their reference derivatives (gradients, curls or divergences)
+    on a rule can be computed once and shared by all threads. Lookups
+    are lock-free and new tables are published by a compare-and-swap.
+    All caches share one memory budget, tables are only removed by
+    ShapeCaches::Clear.
+  */
+  
+  class ShapeCacheKey
+  {
+    enum { MAXSIZE = 64 };
+    unsigned char data[MAXSIZE];
+    int size = 0;
+  public:
+    /// returns false if val does not fit into the key
+    bool Add (int val)
+    {
+      if (val < 0 || val > 255 || size == MAXSIZE) return false;
+      data[size++] = val;
+      return true;
+    }
+
+    /// the shapes depend only on the relative order of the vertex numbers
+    template <typename TA>
+    bool AddVertexRanks (const TA & vnums, int nv)
+    {
+      for (int i = 0; i < nv; i++)
+        {
+          int rank = 0;
+          for (int j = 0; j < nv; j++)
+            if (vnums[j] < vnums[i]) rank++;
+          if (!Add (rank)) return false;
+        }
+      return true;
+    }
+
+    int Size () const { return size; }
+    const unsigned char * Data () const { return data; }
+
+    bool operator== (const ShapeCacheKey & other) const
+    {
+      return size == other.size && memcmp (data, other.data, size) == 0;
+    }
+  };
+
+
+  template <int DIM>
+  class ShapeTable
+  {
+  public:
+    ShapeCacheKey key;
+    size_t hash;
+    size_t ndof;
+    /// coordinates of the integration rule, DIM per SIMD point
+    Array<SIMD<double>> points;
+    /// dimshape*ndof x nip, values on the reference element
+    Matrix<SIMD<double>> shapes;
+    /// dimdshape*ndof x nip, reference gradients, curls or divergences
+    Matrix<SIMD<double>> dshapes;
+
+    ShapeTable (const ShapeCacheKey & akey, size_t ahash,
+                const SIMD_IntegrationRule & ir, size_t andof,
+                int dimshape, int dimdshape)
+      : key(akey), hash(ahash), ndof(andof), points(DIM*ir.Size()),
+        shapes(dimshape*ndof, ir.Size()), dshapes(dimdshape*ndof, ir.Size())
+    {
+      for (size_t i = 0; i < ir.Size(); i++)
+        for (int k = 0; k < DIM; k++)
+          points[i*DIM+k] = ir[i](k);
+    }
+
+    size_t MemoryUsage () const
+    {
+      return (points.Size() + shapes.Height() * shapes.Width()
+              + dshapes.Height() * dshapes.Width()) * sizeof(SIMD<double>);
+    }
+
+    bool Matches (const ShapeCacheKey & akey, size_t ahash,
+                  const SIMD_IntegrationRule & ir, size_t andof) const
+    {
+      if (hash != ahash || !(key == akey)) return false;
+      if (ndof != andof || points.Size() != DIM*ir.Size()) return false;
+      for (size_t i = 0; i < ir.Size(); i++)
+        for (int k = 0; k < DIM; k++)
+          if (memcmp (&points[i*DIM+k], &ir[i](k), sizeof(SIMD<double>)) != 0)
+            return false;
+      return true;
+    }
+  };
+
+
+  class ShapeCacheBase
+  {
+  public:
+    virtual ~ShapeCacheBase () { ; }
+    virtual void Clear () = 0;
+  };
+
+  /// memory budget and switch shared by all shape caches
+  class NGS_DLL_HEADER ShapeCaches
+  {
+  public:
+    static std::atomic<size_t> memory_usage;
+    /// no new tables once exceeded, all caches together
+    static std::atomic<size_t> max_memory;
+    /// if false, elements compute their shapes without cache
+    static std::atomic<bool> enabled;
+
+    static void Register (ShapeCacheBase * cache);
+    static void Unregister (ShapeCacheBase * cache);
+    /// deletes all tables, no element evaluation must be running
+    static void Clear ();
+  };
+
+
+  template <int DIM>
+  class ShapeCache : public ShapeCacheBase
+  {
+    enum { CAPACITY = 1024, MAXPROBE = 64 };
+    std::atomic<ShapeTable<DIM>*> tables[CAPACITY];
+  public:
+    ShapeCache ()
+    {
+      for (auto & table : tables) table = nullptr;
+      ShapeCaches::Register (this);
+    }
+    ~ShapeCache ()
+    {
+      ShapeCaches::Unregister (this);
+      Clear();
+    }
+
+    virtual void Clear () override
+    {
+      for (auto & slot : tables)
+        if (ShapeTable<DIM> * table = slot.exchange (nullptr))
+          {
+            ShapeCaches::memory_usage -= table->MemoryUsage();
+            delete table;
+          }
+    }
+
+    /**
+       Finds the table, or computes it by calc(shapes, dshapes).
+       dimshape and dimdshape are the rows per dof of the two matrices.
+       Returns nullptr if the cache is full or disabled.
+     */
+    template <typename FUNC>
+    const ShapeTable<DIM> * Get (const ShapeCacheKey & key, const SIMD_IntegrationRule & ir,
+                                 size_t ndof, int dimshape, int dimdshape, const FUNC & calc)
+    {
+      if (!ShapeCaches::enabled.load (std::memory_order_relaxed)) return nullptr;
+
+      // FNV-1a on key and coordinates
+      size_t hash = 14695981039346656037ull;
+      for (int i = 0; i < key.Size(); i++)
+        hash = (hash ^ key.Data()[i]) * 1099511628211ull;
+      for (size_t i = 0; i < ir.Size(); i++)
+        for (int k = 0; k < DIM; k++)
+          {
+            SIMD<double> x = ir[i](k);
+            for (size_t l = 0; l < SIMD<double>::Size(); l++)
+              {
+                uint64_t word;
+                double xl = x[l];
+                memcpy (&word, &xl, sizeof(word));
+                hash = (hash ^ word) * 1099511628211ull;
+              }
+          }
+
+      unique_ptr<ShapeTable<DIM>> newtable;
+      for (size_t i = 0; i < MAXPROBE; i++)
+        {
+          auto & slot = tables[(hash+i) % CAPACITY];
+          ShapeTable<DIM> * table = slot.load (std::memory_order_acquire);
+          if (!table)
+            {
+              if (ShapeCaches::memory_usage > ShapeCaches::max_memory) return nullptr;
+              if (!newtable)
+                {
+                  newtable = make_unique<ShapeTable<DIM>> (key, hash, ir, ndof,
+                                                          dimshape, dimdshape);
+                  calc (FlatMatrix<SIMD<double>> (newtable->shapes),
+                        FlatMatrix<SIMD<double>> (newtable->dshapes));
+                }
+              if (slot.compare_exchange_strong (table, newtable.get(),
+                                                std::memory_order_acq_rel))
+                {
+                  ShapeCaches::memory_usage += newtable->MemoryUsage();
+                  return newtable.release();
+                }
+              // another thread was faster, table is its entry now
+            }
+          if (table->Matches (key, hash, ir, ndof))
+            return table;
+        }
+      return nullptr;
+    }
+  };
+
 }
+
+#endif
@@ -987,7 +987,9 @@ Compile list of individual steps, experimental improvement for deep trees
 Parameters:
 
 realcompile : bool
-  True -> Compile to C++ code
+  True -> Compile to C++ code. Compiled libraries are cached in
+  $NGSOLVE_CODE_CACHE (default ~/.cache/ngsolve/compiled, 'off' disables
+  the cache), limited to $NGSOLVE_CODE_CACHE_SIZE MB (default 1024)
 
 maxderiv : int
   input maximal derivative
@@ -996,6 +998,11 @@ wait : bool
   True -> Waits until the previous Compile call is finished before start compiling
 
 )raw_string"))
+    .def ("IsCompiled", [] (shared_ptr<CF> coef) { return IsCompiled(coef); },
+          "True if the compiled code of a CoefficientFunction from Compile(realcompile=True) is loaded")
+    .def ("WaitCompiled", [] (shared_ptr<CF> coef) { WaitCompiled(coef); },
+          py::call_guard<py::gil_scoped_release>(),
+          "waits until a compilation started by Compile(realcompile=True, wait=False) is finished")
 
 
     .def_property_readonly ("type", [](shared_ptr<CF> cf) { return cf->GetType(); })
@@ -2273,6 +2280,31 @@ alpha : double
 
 )raw_string"));
     
+
+  m.def ("SetShapeCache", [] (bool enable, size_t memory)
+         {
+           ShapeCaches::enabled = enable;
+           ShapeCaches::max_memory = memory;
+         },
+         py::arg("enable")=true, py::arg("memory")=size_t(64) << 20, docu_string(R"raw_string(
+Controls the caches of shape functions on reference integration rules,
+shared by all high order elements.
+
+Parameters:
+
+enable : bool
+  use cached shape tables
+
+memory : int
+  bytes all caches together may allocate
+
+)raw_string"));
+
+  m.def ("ClearShapeCache", [] () { ShapeCaches::Clear(); },
+         "deletes all cached shape tables, must not be called during assembly");
+
+  m.def ("ShapeCacheMemory", [] () { return size_t(ShapeCaches::memory_usage); },
+         "bytes allocated by the shape caches");
                            
   m.def("GenerateL2ElementCode", &GenerateL2ElementCode);
 
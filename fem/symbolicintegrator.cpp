@@ -2489,6 +2489,235 @@ namespace ngfem
  
   
   
+  void SymbolicBilinearFormIntegrator ::
+  CalcProxyCoupling (const BaseMappedIntegrationRule & mir,
+                     FlatTensor<3,double> coupling,
+                     LocalHeap & lh) const
+  {
+    HeapReset hr(lh);
+    ProxyUserData ud;
+    const_cast<ElementTransformation&>(mir.GetTransformation()).userdata = &ud;
+
+    FlatMatrix<double> val(mir.Size(), 1, lh);
+    coupling = 0.0;
+
+    int k1 = 0;
+    for (auto proxy1 : trial_proxies)
+      {
+        int l1 = 0;
+        for (auto proxy2 : test_proxies)
+          {
+            for (int k = 0; k < proxy1->Dimension(); k++)
+              for (int l = 0; l < proxy2->Dimension(); l++)
+                if (nonzeros(l1+l, k1+k))
+                  {
+                    ud.trialfunction = proxy1;
+                    ud.trial_comp = k;
+                    ud.testfunction = proxy2;
+                    ud.test_comp = l;
+                    cf -> Evaluate (mir, val);
+                    coupling(STAR,k1+k,l1+l) = val.Col(0);
+                  }
+            l1 += proxy2->Dimension();
+          }
+        k1 += proxy1->Dimension();
+      }
+  }
+
+
+  void SymbolicBilinearFormIntegrator ::
+  CalcElementMatrixAddBatch (const FiniteElement & fel,
+                             FlatArray<const ElementTransformation*> trafos,
+                             FlatMatrix<SIMD<double>> elmats,
+                             LocalHeap & lh) const
+  {
+    if (!simd_evaluate || !SupportsBatch() ||
+        typeid(fel) == typeid(const MixedFiniteElement&) ||
+        ElementTopology::GetSpaceDim(fel.ElementType()) != trafos[0]->SpaceDim())
+      throw ExceptionNOSIMD ("CalcElementMatrixAddBatch: not supported");
+
+    switch (trafos[0]->SpaceDim())
+      {
+      case 1: T_CalcElementMatrixAddBatch<1> (fel, trafos, elmats, lh); break;
+      case 2: T_CalcElementMatrixAddBatch<2> (fel, trafos, elmats, lh); break;
+      case 3: T_CalcElementMatrixAddBatch<3> (fel, trafos, elmats, lh); break;
+      default:
+        throw ExceptionNOSIMD ("CalcElementMatrixAddBatch: not supported");
+      }
+  }
+
+  template <int D>
+  void SymbolicBilinearFormIntegrator ::
+  T_CalcElementMatrixAddBatch (const FiniteElement & fel,
+                               FlatArray<const ElementTransformation*> trafos,
+                               FlatMatrix<SIMD<double>> elmats,
+                               LocalHeap & lh) const
+  {
+    static Timer t("SymbolicBFI::CalcElementMatrixAddBatch", 2);
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    HeapReset hr(lh);
+    constexpr size_t simdw = SIMD<double>::Size();
+    const IntegrationRule & ir = GetIntegrationRule (fel, lh);
+    size_t nip = ir.Size();
+
+    // SIMD point i holds integration point i of all elements, element l in lane l,
+    // unused lanes repeat the last element
+    SIMD_IntegrationRule simd_ir(nip*simdw, lh);
+    for (size_t i = 0; i < nip; i++)
+      simd_ir[i] = [&] (int l) { return ir[i]; };
+    SIMD_MappedIntegrationRule<D,D> mir(simd_ir, *trafos[0], -1, lh);
+
+    SIMD_IntegrationRule eir(ir, lh);
+    auto et = fel.ElementType();
+    bool simplex = et == ET_SEGM || et == ET_TRIG || et == ET_TET;
+    for (size_t l = 0; l < simdw; l++)
+      {
+        HeapReset hr(lh);
+        auto & trafo = *trafos[min2(l, trafos.Size()-1)];
+        if (simplex && !trafo.IsCurvedElement())
+          {
+            // affine mapping, one Jacobian for all points
+            FlatVector<> p0(D, lh), p(D, lh);
+            FlatMatrix<> jac(D, D, lh);
+            trafo.CalcPointJacobian (ir[0], p0, jac);
+            for (size_t i = 0; i < nip; i++)
+              {
+                p = p0;
+                for (int j = 0; j < D; j++)
+                  for (int k = 0; k < D; k++)
+                    p(j) += jac(j,k) * (ir[i](k)-ir[0](k));
+                for (int j = 0; j < D; j++)
+                  {
+                    reinterpret_cast<double*>(&mir[i].Point()(j))[l] = p(j);
+                    for (int k = 0; k < D; k++)
+                      reinterpret_cast<double*>(&mir[i].Jacobian()(j,k))[l] = jac(j,k);
+                  }
+              }
+            continue;
+          }
+
+        auto & emir = static_cast<SIMD_MappedIntegrationRule<D,D>&> (trafo(eir, lh));
+        for (size_t i = 0; i < nip; i++)
+          {
+            auto & emip = emir[i / simdw];
+            size_t li = i % simdw;
+            for (int j = 0; j < D; j++)
+              {
+                reinterpret_cast<double*>(&mir[i].Point()(j))[l] = emip.GetPoint()(j)[li];
+                for (int k = 0; k < D; k++)
+                  reinterpret_cast<double*>(&mir[i].Jacobian()(j,k))[l] = emip.GetJacobian()(j,k)[li];
+              }
+          }
+      }
+    for (size_t i = 0; i < nip; i++)
+      mir[i].Compute();
+
+    ProxyUserData ud;
+    const_cast<ElementTransformation&>(*trafos[0]).userdata = &ud;
+
+    int k1 = 0;
+    int k1nr = 0;
+    for (auto proxy1 : trial_proxies)
+      {
+        int l1 = 0;
+        int l1nr = 0;
+        for (auto proxy2 : test_proxies)
+          {
+            size_t dim_proxy1 = proxy1->Dimension();
+            size_t dim_proxy2 = proxy2->Dimension();
+            size_t tt_pair = l1nr*trial_proxies.Size()+k1nr;
+
+            if (nonzeros_proxies(tt_pair))
+              {
+                HeapReset hr(lh);
+                bool samediffop = same_diffops(tt_pair);
+                bool symmetric = samediffop && diagonal_proxies(tt_pair);
+
+                FlatMatrix<SIMD<double>> proxyvalues(dim_proxy1*dim_proxy2, nip, lh);
+                for (size_t k = 0, kk = 0; k < dim_proxy1; k++)
+                  for (size_t l = 0; l < dim_proxy2; l++, kk++)
+                    if (nonzeros(l1+l, k1+k))
+                      {
+                        ud.trialfunction = proxy1;
+                        ud.trial_comp = k;
+                        ud.testfunction = proxy2;
+                        ud.test_comp = l;
+                        cf -> Evaluate (mir, proxyvalues.Rows(kk,kk+1));
+                      }
+                    else
+                      proxyvalues.Row(kk) = 0.0;
+                for (size_t i = 0; i < nip; i++)
+                  proxyvalues.Col(i) *= mir[i].GetWeight();
+
+                IntRange r1 = proxy1->Evaluator()->UsedDofs(fel);
+                IntRange r2 = proxy2->Evaluator()->UsedDofs(fel);
+
+                FlatMatrix<SIMD<double>> bbmat1(elmats.Width()*dim_proxy1, nip, lh);
+                FlatMatrix<SIMD<double>> bdbmat1(elmats.Width()*dim_proxy2, nip, lh);
+                FlatMatrix<SIMD<double>> bbmat2 = samediffop ?
+                  bbmat1 : FlatMatrix<SIMD<double>>(elmats.Height()*dim_proxy2, nip, lh);
+
+                proxy1->Evaluator()->CalcMatrix(fel, mir, bbmat1);
+                if (!samediffop)
+                  proxy2->Evaluator()->CalcMatrix(fel, mir, bbmat2);
+
+                bdbmat1 = 0.0;
+                for (auto i : r1)
+                  for (size_t j = 0; j < dim_proxy2; j++)
+                    for (size_t k = 0; k < dim_proxy1; k++)
+                      bdbmat1.Row(i*dim_proxy2+j) += pw_mult(bbmat1.Row(i*dim_proxy1+k),
+                                                             proxyvalues.Row(k*dim_proxy2+j));
+
+                // sum over integration points only, lanes are different elements
+                FlatMatrix<SIMD<double>> hbdbmat1(elmats.Width(), dim_proxy2*nip, &bdbmat1(0,0));
+                FlatMatrix<SIMD<double>> hbbmat2(elmats.Height(), dim_proxy2*nip, &bbmat2(0,0));
+                size_t w = hbbmat2.Width();
+                auto add = [&] (size_t i, size_t j, SIMD<double> sum)
+                  {
+                    elmats(i,j) += sum;
+                    if (symmetric && j < i)
+                      elmats(j,i) += sum;
+                  };
+                for (auto i : r2)
+                  {
+                    IntRange cols = symmetric ? IntRange(r1.First(), i+1) : r1;
+                    size_t j = cols.First();
+                    for ( ; j+4 <= cols.Next(); j += 4)
+                      {
+                        SIMD<double> sum0(0.0), sum1(0.0), sum2(0.0), sum3(0.0);
+                        for (size_t k = 0; k < w; k++)
+                          {
+                            SIMD<double> bi = hbbmat2(i,k);
+                            sum0 += bi * hbdbmat1(j,k);
+                            sum1 += bi * hbdbmat1(j+1,k);
+                            sum2 += bi * hbdbmat1(j+2,k);
+                            sum3 += bi * hbdbmat1(j+3,k);
+                          }
+                        add (i, j, sum0);
+                        add (i, j+1, sum1);
+                        add (i, j+2, sum2);
+                        add (i, j+3, sum3);
+                      }
+                    for ( ; j < cols.Next(); j++)
+                      {
+                        SIMD<double> sum(0.0);
+                        for (size_t k = 0; k < w; k++)
+                          sum += hbbmat2(i,k) * hbdbmat1(j,k);
+                        add (i, j, sum);
+                      }
+                  }
+              }
+
+            l1 += proxy2->Dimension();
+            l1nr++;
+          }
+        k1 += proxy1->Dimension();
+        k1nr++;
+      }
+  }
+
+  
   template <typename SCAL, typename SCAL_SHAPES>
   void SymbolicBilinearFormIntegrator ::
   T_ApplyElementMatrixEB (const FiniteElement & fel, 
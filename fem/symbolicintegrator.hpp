@@ -674,7 +674,35 @@ public:
                                  void * precomputed,
                                  LocalHeap & lh) const;
 
-
+    const Array<ProxyFunction*> & TrialProxies() const { return trial_proxies; }
+    const Array<ProxyFunction*> & TestProxies() const { return test_proxies; }
+    VorB ElementVB() const { return element_vb; }
+    shared_ptr<CoefficientFunction> GetCoefficientFunction() const { return cf; }
+
+    /// coupling(i,k,l) is the coefficient of trial component k times test component l
+    /// in the integrand at point i (no integration weight), used by matrix-free operators
+    NGS_DLL_HEADER void CalcProxyCoupling (const BaseMappedIntegrationRule & mir,
+                                           FlatTensor<3,double> coupling,
+                                           LocalHeap & lh) const;
+
+    /// coefficients are evaluated for several elements at once,
+    /// thus they must not depend on the element (like GridFunctions do)
+    bool SupportsBatch () const
+    { return element_vb == VOL && !gridfunction_cfs.Size() && !cf->IsComplex(); }
+
+    /// element matrices of elements sharing the reference element fel:
+    /// lane l of elmats(i,j) is added to the element matrix of trafos[l].
+    /// Throws ExceptionNOSIMD if the coefficient has no SIMD evaluation.
+    NGS_DLL_HEADER void CalcElementMatrixAddBatch (const FiniteElement & fel,
+                                                   FlatArray<const ElementTransformation*> trafos,
+                                                   FlatMatrix<SIMD<double>> elmats,
+                                                   LocalHeap & lh) const;
+
+    template <int D>
+    void T_CalcElementMatrixAddBatch (const FiniteElement & fel,
+                                      FlatArray<const ElementTransformation*> trafos,
+                                      FlatMatrix<SIMD<double>> elmats,
+                                      LocalHeap & lh) const;
   };
 
 
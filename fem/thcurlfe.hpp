@@ -96,6 +96,11 @@ namespace ngfem
     HD NGS_DLL_HEADER virtual void AddCurlTrans (const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values,
                                                  BareSliceVector<Complex> coefs) const;  // actually not in base-class !!!!
 
+    /// key for the shape table cache, elements without a key are not cached
+    bool GetShapeCacheKey (ShapeCacheKey & key) const { return false; }
+
+    /// shared reference shapes and curls on the rule, or nullptr
+    const ShapeTable<DIM> * GetShapeTable (const SIMD_BaseMappedIntegrationRule & mir) const;
 
     
   };
@@ -32,6 +32,56 @@ namespace ngfem
   } 
 
 #ifndef FASTCOMPILE
+
+  // Piola transformation of reference curls, J/det in 3D and 1/det in 2D
+  template <int DIM>
+  INLINE Mat<DIM,DIM,SIMD<double>> GetCurlTrafo (const SIMD<MappedIntegrationPoint<DIM,DIM>> & mip)
+  {
+    Mat<DIM,DIM,SIMD<double>> jac = mip.GetJacobian();
+    SIMD<double> idet = 1.0 / mip.GetJacobiDet();
+    Mat<DIM,DIM,SIMD<double>> trafo;
+    for (int k = 0; k < DIM; k++)
+      for (int l = 0; l < DIM; l++)
+        if (DIM == 3)
+          trafo(k,l) = idet * jac(k,l);
+        else
+          trafo(k,l) = (k == l) ? idet : SIMD<double>(0.0);
+    return trafo;
+  }
+
+  template <ELEMENT_TYPE ET, typename SHAPES, typename BASE>
+  auto T_HCurlHighOrderFiniteElement<ET,SHAPES,BASE> :: 
+  GetShapeTable (const SIMD_BaseMappedIntegrationRule & bmir) const -> const ShapeTable<DIM> *
+  {
+    // the Piola transformations are applied for volume elements only
+    ShapeCacheKey key;
+    if (DIM < 2 || bmir.DimSpace() != DIM ||
+        !static_cast<const SHAPES*> (this) -> GetShapeCacheKey (key))
+      return nullptr;
+
+    static ShapeCache<DIM> cache;
+    auto & ir = bmir.IR();
+    return cache.Get (key, ir, ndof, DIM, DIM_CURL,
+                      [this, &ir] (FlatMatrix<SIMD<double>> shapes,
+                                   FlatMatrix<SIMD<double>> curlshapes)
+                      {
+                        for (size_t i = 0; i < ir.Size(); i++)
+                          {
+                            Vec<DIM, AutoDiff<DIM,SIMD<double>>> adp = ir[i];
+                            this->T_CalcShape (TIP<DIM,AutoDiff<DIM,SIMD<double>>> (adp),
+                                               SBLambda ([&] (size_t j, auto s)
+                                                         {
+                                                           auto shape = s.Value();
+                                                           auto cshape = s.CurlValue();
+                                                           for (int k = 0; k < DIM; k++)
+                                                             shapes(j*DIM+k,i) = shape(k);
+                                                           for (int k = 0; k < DIM_CURL; k++)
+                                                             curlshapes(j*DIM_CURL+k,i) = cshape(k);
+                                                         }));
+                          }
+                      });
+  }
+
   template <ELEMENT_TYPE ET, typename SHAPES, typename BASE>
   void T_HCurlHighOrderFiniteElement<ET, SHAPES, BASE> :: 
   CalcMappedShape (const BaseMappedIntegrationPoint & bmip,
@@ -61,6 +111,25 @@ namespace ngfem
   CalcMappedShape (const SIMD_BaseMappedIntegrationRule & bmir, 
                    BareSliceMatrix<SIMD<double>> shapes) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        auto & refshapes = table->shapes;
+        for (size_t i = 0; i < mir.Size(); i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> ijac = mir[i].GetJacobianInverse();
+            for (size_t j = 0; j < ndof; j++)
+              for (int l = 0; l < DIM; l++)
+                {
+                  SIMD<double> sum = 0.0;
+                  for (int k = 0; k < DIM; k++)
+                    sum += refshapes(j*DIM+k,i) * ijac(k,l);
+                  shapes(j*DIM+l,i) = sum;
+                }
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,shapes](auto CODIM)
        {
@@ -128,6 +197,25 @@ namespace ngfem
   CalcMappedCurlShape (const SIMD_BaseMappedIntegrationRule & bmir, 
                        BareSliceMatrix<SIMD<double>> shapes) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        auto & refcurls = table->dshapes;
+        for (size_t i = 0; i < mir.Size(); i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> trafo = GetCurlTrafo (mir[i]);
+            for (size_t j = 0; j < ndof; j++)
+              for (int l = 0; l < DIM_CURL; l++)
+                {
+                  SIMD<double> sum = 0.0;
+                  for (int k = 0; k < DIM_CURL; k++)
+                    sum += trafo(l,k) * refcurls(j*DIM_CURL+k,i);
+                  shapes(j*DIM_CURL+l,i) = sum;
+                }
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,shapes](auto CODIM)
        {
@@ -183,6 +271,36 @@ namespace ngfem
   Evaluate (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs,
             BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        // reference values, mapped by the inverse Jacobian
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM*nip);
+        FlatMatrix<SIMD<double>> refvals(DIM, nip, &mem[0]);
+        refvals = SIMD<double> (0.0);
+        auto & refshapes = table->shapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> c = coefs(j);
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < nip; i++)
+                refvals(k,i) += c * refshapes(j*DIM+k,i);
+          }
+        for (size_t i = 0; i < nip; i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> ijac = mir[i].GetJacobianInverse();
+            for (int l = 0; l < DIM; l++)
+              {
+                SIMD<double> sum = 0.0;
+                for (int k = 0; k < DIM; k++)
+                  sum += refvals(k,i) * ijac(k,l);
+                values(l,i) = sum;
+              }
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,coefs,values](auto CODIM)
        {
@@ -236,6 +354,35 @@ namespace ngfem
   void T_HCurlHighOrderFiniteElement<ET,SHAPES,BASE> :: 
   EvaluateCurl (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM_CURL*nip);
+        FlatMatrix<SIMD<double>> refcurl(DIM_CURL, nip, &mem[0]);
+        refcurl = SIMD<double> (0.0);
+        auto & refcurls = table->dshapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> c = coefs(j);
+            for (int k = 0; k < DIM_CURL; k++)
+              for (size_t i = 0; i < nip; i++)
+                refcurl(k,i) += c * refcurls(j*DIM_CURL+k,i);
+          }
+        for (size_t i = 0; i < nip; i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> trafo = GetCurlTrafo (mir[i]);
+            for (int l = 0; l < DIM_CURL; l++)
+              {
+                SIMD<double> sum = 0.0;
+                for (int k = 0; k < DIM_CURL; k++)
+                  sum += trafo(l,k) * refcurl(k,i);
+                values(l,i) = sum;
+              }
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,coefs,values](auto CODIM)
        {
@@ -293,6 +440,36 @@ namespace ngfem
   AddTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values,
             BareSliceVector<> coefs) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        // pull back the values to the reference element
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM*nip);
+        FlatMatrix<SIMD<double>> refvals(DIM, nip, &mem[0]);
+        for (size_t i = 0; i < nip; i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> ijac = mir[i].GetJacobianInverse();
+            for (int k = 0; k < DIM; k++)
+              {
+                SIMD<double> sum = 0.0;
+                for (int l = 0; l < DIM; l++)
+                  sum += ijac(k,l) * values(l,i);
+                refvals(k,i) = sum;
+              }
+          }
+        auto & refshapes = table->shapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> sum = 0.0;
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < nip; i++)
+                sum += refvals(k,i) * refshapes(j*DIM+k,i);
+            coefs(j) += HSum(sum);
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,coefs,values](auto CODIM)
        {
@@ -359,6 +536,35 @@ namespace ngfem
   AddCurlTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values,
                 BareSliceVector<> coefs) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM_CURL*nip);
+        FlatMatrix<SIMD<double>> refvals(DIM_CURL, nip, &mem[0]);
+        for (size_t i = 0; i < nip; i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> trafo = GetCurlTrafo (mir[i]);
+            for (int k = 0; k < DIM_CURL; k++)
+              {
+                SIMD<double> sum = 0.0;
+                for (int l = 0; l < DIM_CURL; l++)
+                  sum += trafo(l,k) * values(l,i);
+                refvals(k,i) = sum;
+              }
+          }
+        auto & refcurls = table->dshapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> sum = 0.0;
+            for (int k = 0; k < DIM_CURL; k++)
+              for (size_t i = 0; i < nip; i++)
+                sum += refvals(k,i) * refcurls(j*DIM_CURL+k,i);
+            coefs(j) += HSum(sum);
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,coefs,values](auto CODIM)
        {
@@ -711,6 +711,12 @@ namespace ngfem
     virtual void CalcDivShape (const IntegrationPoint & ip, 
 			       SliceVector<> divshape) const;
 
+    /// key for the shape table cache, elements without a key are not cached
+    bool GetShapeCacheKey (ShapeCacheKey & key) const { return false; }
+
+    /// shared reference shapes and divergences on the rule, or nullptr
+    const ShapeTable<DIM> * GetShapeTable (const SIMD_BaseMappedIntegrationRule & mir) const;
+
 #ifndef FASTCOMPILE
     virtual void CalcMappedShape (const MappedIntegrationPoint<DIM,DIM> & mip,
 				  SliceMatrix<> shape) const;
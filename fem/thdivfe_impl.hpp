@@ -90,6 +90,52 @@ namespace ngfem
   }
 
 #ifndef FASTCOMPILE
+  template <class FEL, ELEMENT_TYPE ET>
+  auto T_HDivFiniteElement<FEL,ET> :: 
+  GetShapeTable (const SIMD_BaseMappedIntegrationRule & bmir) const -> const ShapeTable<DIM> *
+  {
+    // the Piola transformation is applied for volume elements only
+    ShapeCacheKey key;
+    if (bmir.DimSpace() != DIM ||
+        !static_cast<const FEL*> (this) -> GetShapeCacheKey (key))
+      return nullptr;
+
+    static ShapeCache<DIM> cache;
+    auto & ir = bmir.IR();
+    return cache.Get (key, ir, this->ndof, DIM, 1,
+                      [this, &ir] (FlatMatrix<SIMD<double>> shapes,
+                                   FlatMatrix<SIMD<double>> divshapes)
+                      {
+                        for (size_t i = 0; i < ir.Size(); i++)
+                          {
+                            // as GetTIPHDiv for the identity mapping
+                            Vec<DIM, AutoDiff<DIM,SIMD<double>>> adp = ir[i];
+                            if (DIM == 2)
+                              for (int k = 0; k < DIM; k++)
+                                {
+                                  adp(0).DValue(k) = (k == 1) ? 1.0 : 0.0;
+                                  adp(DIM-1).DValue(k) = (k == 0) ? -1.0 : 0.0;
+                                }
+                            static_cast<const FEL*> (this) ->
+                              T_CalcShape (TIP<DIM,AutoDiff<DIM,SIMD<double>>> (adp),
+                                           SBLambda ([&] (size_t j, auto s)
+                                                     {
+                                                       auto vshape = HDiv2ShapeNew (s);
+                                                       for (int k = 0; k < DIM; k++)
+                                                         shapes(j*DIM+k,i) = vshape(k);
+                                                     }));
+
+                            Vec<DIM, AutoDiff<DIM,SIMD<double>>> adpdiv = ir[i];
+                            static_cast<const FEL*> (this) ->
+                              T_CalcShape (TIP<DIM,AutoDiff<DIM,SIMD<double>>> (adpdiv),
+                                           SBLambda ([&] (size_t j, THDiv2DivShape<DIM,SIMD<double>> divshape)
+                                                     {
+                                                       divshapes(j,i) = divshape.Get();
+                                                     }));
+                          }
+                      });
+  }
+
   template <class FEL, ELEMENT_TYPE ET>
   void T_HDivFiniteElement<FEL,ET> :: 
   CalcMappedShape (const MappedIntegrationPoint<DIM,DIM> & mip,
@@ -132,6 +178,26 @@ namespace ngfem
   CalcMappedShape (const SIMD_BaseMappedIntegrationRule & bmir, 
                    BareSliceMatrix<SIMD<double>> shapes) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        auto & refshapes = table->shapes;
+        for (size_t i = 0; i < mir.Size(); i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> jac = mir[i].GetJacobian();
+            SIMD<double> idet = 1.0 / mir[i].GetJacobiDet();
+            for (size_t j = 0; j < this->ndof; j++)
+              for (int l = 0; l < DIM; l++)
+                {
+                  SIMD<double> sum = 0.0;
+                  for (int k = 0; k < DIM; k++)
+                    sum += jac(l,k) * refshapes(j*DIM+k,i);
+                  shapes(j*DIM+l,i) = idet * sum;
+                }
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,shapes](auto CODIM)
        {
@@ -161,6 +227,18 @@ namespace ngfem
                       BareSliceMatrix<SIMD<double>> divshapes) const
   {
     auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & refdivs = table->dshapes;
+        for (size_t i = 0; i < mir.Size(); i++)
+          {
+            SIMD<double> idet = 1.0 / mir[i].GetJacobiDet();
+            for (size_t j = 0; j < this->ndof; j++)
+              divshapes(j,i) = idet * refdivs(j,i);
+          }
+        return;
+      }
+    
     for (size_t i = 0; i < mir.Size(); i++)
       {
         static_cast<const FEL*> (this) ->                 
@@ -220,6 +298,37 @@ namespace ngfem
   void T_HDivFiniteElement<FEL,ET> :: 
   Evaluate (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceVector<> coefs, BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        // reference values, mapped by the Piola transformation
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM*nip);
+        FlatMatrix<SIMD<double>> refvals(DIM, nip, &mem[0]);
+        refvals = SIMD<double> (0.0);
+        auto & refshapes = table->shapes;
+        for (size_t j = 0; j < this->ndof; j++)
+          {
+            SIMD<double> c = coefs(j);
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < nip; i++)
+                refvals(k,i) += c * refshapes(j*DIM+k,i);
+          }
+        for (size_t i = 0; i < nip; i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> jac = mir[i].GetJacobian();
+            SIMD<double> idet = 1.0 / mir[i].GetJacobiDet();
+            for (int l = 0; l < DIM; l++)
+              {
+                SIMD<double> sum = 0.0;
+                for (int k = 0; k < DIM; k++)
+                  sum += jac(l,k) * refvals(k,i);
+                values(l,i) = idet * sum;
+              }
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,coefs,values](auto CODIM)
        {
@@ -249,6 +358,37 @@ namespace ngfem
   AddTrans (const SIMD_BaseMappedIntegrationRule & bmir, BareSliceMatrix<SIMD<double>> values,
             BareSliceVector<> coefs) const
   {
+    if (auto table = GetShapeTable (bmir))
+      {
+        // pull back the values to the reference element
+        auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM*nip);
+        FlatMatrix<SIMD<double>> refvals(DIM, nip, &mem[0]);
+        for (size_t i = 0; i < nip; i++)
+          {
+            Mat<DIM,DIM,SIMD<double>> jac = mir[i].GetJacobian();
+            SIMD<double> idet = 1.0 / mir[i].GetJacobiDet();
+            for (int k = 0; k < DIM; k++)
+              {
+                SIMD<double> sum = 0.0;
+                for (int l = 0; l < DIM; l++)
+                  sum += jac(l,k) * values(l,i);
+                refvals(k,i) = idet * sum;
+              }
+          }
+        auto & refshapes = table->shapes;
+        for (size_t j = 0; j < this->ndof; j++)
+          {
+            SIMD<double> sum = 0.0;
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < nip; i++)
+                sum += refvals(k,i) * refshapes(j*DIM+k,i);
+            coefs(j) += HSum(sum);
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,values,coefs](auto CODIM)
        {
@@ -283,6 +423,22 @@ namespace ngfem
                BareVector<SIMD<double>> values) const
   {
     auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+    if (auto table = GetShapeTable (bmir))
+      {
+        auto & refdivs = table->dshapes;
+        for (size_t i = 0; i < mir.Size(); i++)
+          values(i) = SIMD<double> (0.0);
+        for (size_t j = 0; j < this->ndof; j++)
+          {
+            SIMD<double> c = coefs(j);
+            for (size_t i = 0; i < mir.Size(); i++)
+              values(i) += c * refdivs(j,i);
+          }
+        for (size_t i = 0; i < mir.Size(); i++)
+          values(i) /= mir[i].GetJacobiDet();
+        return;
+      }
+    
     for (size_t i = 0; i < mir.Size(); i++)
       {
         SIMD<double> sum(0.0);
@@ -304,6 +460,23 @@ namespace ngfem
                BareSliceVector<> coefs) const
   {
     auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
+    if (auto table = GetShapeTable (bmir))
+      {
+        size_t nip = mir.Size();
+        STACK_ARRAY(SIMD<double>, mem, nip);
+        for (size_t i = 0; i < nip; i++)
+          mem[i] = values(i) / mir[i].GetJacobiDet();
+        auto & refdivs = table->dshapes;
+        for (size_t j = 0; j < this->ndof; j++)
+          {
+            SIMD<double> sum = 0.0;
+            for (size_t i = 0; i < nip; i++)
+              sum += mem[i] * refdivs(j,i);
+            coefs(j) += HSum(sum);
+          }
+        return;
+      }
+    
     for (size_t i = 0; i < mir.Size(); i++)
       {
         SIMD<double> vali = values(i);
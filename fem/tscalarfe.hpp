@@ -151,6 +151,12 @@ namespace ngfem
     {
       throw Exception (string("dual shape not implemented for element ")+typeid(*this).name()); 
     }
+
+    /// key for the shape table cache, elements without a key are not cached
+    bool GetShapeCacheKey (ShapeCacheKey & key) const { return false; }
+
+    /// shared shapes and reference gradients on the rule, or nullptr
+    const ShapeTable<DIM> * GetShapeTable (const SIMD_IntegrationRule & ir) const;
     
   };
 
@@ -50,6 +50,33 @@ namespace ngfem
 
 #ifndef FASTCOMPILE
 
+  template <class FEL, ELEMENT_TYPE ET, class BASE>
+  auto T_ScalarFiniteElement<FEL,ET,BASE> :: 
+  GetShapeTable (const SIMD_IntegrationRule & ir) const -> const ShapeTable<DIM> *
+  {
+    ShapeCacheKey key;
+    if (DIM == 0 || !static_cast<const FEL*> (this) -> GetShapeCacheKey (key))
+      return nullptr;
+
+    static ShapeCache<DIM> cache;
+    return cache.Get (key, ir, ndof, 1, DIM,
+                      [this, &ir] (FlatMatrix<SIMD<double>> shapes,
+                                   FlatMatrix<SIMD<double>> dshapes)
+                      {
+                        for (size_t i = 0; i < ir.Size(); i++)
+                          {
+                            Vec<DIM, AutoDiff<DIM,SIMD<double>>> adp = ir[i];
+                            T_CalcShape (TIP<DIM,AutoDiff<DIM,SIMD<double>>> (adp),
+                                         SBLambda ([&] (size_t j, auto shape)
+                                                   {
+                                                     shapes(j,i) = shape.Value();
+                                                     for (int k = 0; k < DIM; k++)
+                                                       dshapes(j*DIM+k,i) = shape.DValue(k);
+                                                   }));
+                          }
+                      });
+  }
+
   template <class FEL, ELEMENT_TYPE ET, class BASE>
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   CalcShape (const IntegrationRule & ir, BareSliceMatrix<> shape) const
@@ -62,6 +89,12 @@ namespace ngfem
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shapes) const
   {
+    if (auto table = GetShapeTable (ir))
+      {
+        shapes.AddSize(ndof, ir.Size()) = table->shapes;
+        return;
+      }
+    
     for (size_t i = 0; i < ir.Size(); i++)
       T_CalcShape (ir[i].TIp<DIM>(),
                    SBLambda([&](size_t j, SIMD<double> shape)
@@ -103,6 +136,20 @@ namespace ngfem
     // static Timer t("ScalarFE::Evaluate", 2); RegionTimer reg(t);
     // t.AddFlops (ir.GetNIP()*ndof);
 
+    if (auto table = GetShapeTable (ir))
+      {
+        auto & shapes = table->shapes;
+        for (size_t i = 0; i < ir.Size(); i++)
+          values(i) = SIMD<double> (0.0);
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> c = coefs(j);
+            for (size_t i = 0; i < ir.Size(); i++)
+              values(i) += c * shapes(j,i);
+          }
+        return;
+      }
+
     /*
     FlatArray<SIMD<IntegrationPoint>> hir = ir;
     for (int i = 0; i < hir.Size(); i++)
@@ -431,6 +478,19 @@ namespace ngfem
   AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values,
             BareSliceVector<> coefs) const
   {
+    if (auto table = GetShapeTable (ir))
+      {
+        auto & shapes = table->shapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> sum = 0.0;
+            for (size_t i = 0; i < ir.Size(); i++)
+              sum += values(i) * shapes(j,i);
+            coefs(j) += HSum(sum);
+          }
+        return;
+      }
+    
     FlatArray<SIMD<IntegrationPoint>> hir = ir;
     /*
     for (int i = 0; i < hir.Size(); i++)
@@ -694,6 +754,44 @@ namespace ngfem
                 BareSliceVector<> coefs,
                 BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto table = GetShapeTable (bmir.IR()))
+      {
+        // reference gradient, mapped by the inverse Jacobian
+        size_t nip = bmir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM*nip);
+        FlatMatrix<SIMD<double>> refgrad(DIM, nip, &mem[0]);
+        refgrad = SIMD<double> (0.0);
+        auto & dshapes = table->dshapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> c = coefs(j);
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < nip; i++)
+                refgrad(k,i) += c * dshapes(j*DIM+k,i);
+          }
+        Iterate<4-DIM>
+          ([&](auto CODIM)
+           {
+             constexpr int DIMSPACE = DIM+CODIM.value;
+             if (bmir.DimSpace() == DIMSPACE)
+               {
+                 auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+                 for (size_t i = 0; i < nip; i++)
+                   {
+                     Mat<DIM,DIMSPACE,SIMD<double>> ijac = mir[i].GetJacobianInverse();
+                     for (int l = 0; l < DIMSPACE; l++)
+                       {
+                         SIMD<double> sum = 0.0;
+                         for (int k = 0; k < DIM; k++)
+                           sum += refgrad(k,i) * ijac(k,l);
+                         values(l,i) = sum;
+                       }
+                   }
+               }
+           });
+        return;
+      }
+    
     Iterate<4-DIM>
       ([this,&bmir,coefs,values](auto CODIM)
        {
@@ -816,6 +914,44 @@ namespace ngfem
                 BareSliceMatrix<SIMD<double>> values,
                 BareSliceVector<> coefs) const
   {
+    if (auto table = GetShapeTable (bmir.IR()))
+      {
+        // pull back the values to the reference element
+        size_t nip = bmir.Size();
+        STACK_ARRAY(SIMD<double>, mem, DIM*nip);
+        FlatMatrix<SIMD<double>> refvals(DIM, nip, &mem[0]);
+        Iterate<4-DIM>
+          ([&](auto CODIM)
+           {
+             constexpr int DIMSPACE = DIM+CODIM.value;
+             if (bmir.DimSpace() == DIMSPACE)
+               {
+                 auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+                 for (size_t i = 0; i < nip; i++)
+                   {
+                     Mat<DIM,DIMSPACE,SIMD<double>> ijac = mir[i].GetJacobianInverse();
+                     for (int k = 0; k < DIM; k++)
+                       {
+                         SIMD<double> sum = 0.0;
+                         for (int l = 0; l < DIMSPACE; l++)
+                           sum += ijac(k,l) * values(l,i);
+                         refvals(k,i) = sum;
+                       }
+                   }
+               }
+           });
+        auto & dshapes = table->dshapes;
+        for (size_t j = 0; j < ndof; j++)
+          {
+            SIMD<double> sum = 0.0;
+            for (int k = 0; k < DIM; k++)
+              for (size_t i = 0; i < nip; i++)
+                sum += refvals(k,i) * dshapes(j*DIM+k,i);
+            coefs(j) += HSum(sum);
+          }
+        return;
+      }
+    
     Iterate<4-DIM>
       ([&](auto CODIM)
        {
@@ -1000,6 +1136,33 @@ namespace ngfem
   CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & bmir, 
                     BareSliceMatrix<SIMD<double>> dshapes) const
   {
+   if (auto table = GetShapeTable (bmir.IR()))
+     {
+       auto & refdshapes = table->dshapes;
+       Iterate<4-DIM>
+         ([&](auto CODIM)
+          {
+            constexpr int DIMSPACE = DIM+CODIM.value;
+            if (bmir.DimSpace() == DIMSPACE)
+              {
+                auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+                for (size_t i = 0; i < mir.Size(); i++)
+                  {
+                    Mat<DIM,DIMSPACE,SIMD<double>> ijac = mir[i].GetJacobianInverse();
+                    for (size_t j = 0; j < ndof; j++)
+                      for (int l = 0; l < DIMSPACE; l++)
+                        {
+                          SIMD<double> sum = 0.0;
+                          for (int k = 0; k < DIM; k++)
+                            sum += refdshapes(j*DIM+k,i) * ijac(k,l);
+                          dshapes(j*DIMSPACE+l,i) = sum;
+                        }
+                  }
+              }
+          });
+       return;
+     }
+    
    if (bmir.DimSpace() == DIM)
       {
         auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
@@ -105,6 +105,22 @@ namespace ngla
     y += s * *temp;
   }
 
+  void BaseMatrix :: Mult (const MultiVector & x, MultiVector & y) const
+  {
+    if (x.Size() != y.Size())
+      throw Exception ("BaseMatrix::Mult: MultiVectors of different size");
+    for (size_t i = 0; i < x.Size(); i++)
+      Mult (x[i], y[i]);
+  }
+
+  void BaseMatrix :: MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    if (x.Size() != y.Size())
+      throw Exception ("BaseMatrix::MultAdd: MultiVectors of different size");
+    for (size_t i = 0; i < x.Size(); i++)
+      MultAdd (s, x[i], y[i]);
+  }
+
   void BaseMatrix :: MultAdd (Complex s, const BaseVector & x, BaseVector & y) const 
   {
     stringstream err;
@@ -104,6 +104,11 @@ namespace ngla
     /// y += s Trans(matrix) * x
     virtual void MultTransAdd (Complex s, const BaseVector & x, BaseVector & y) const;
 
+    /// y[i] = matrix * x[i] for all vectors, default calls Mult for every vector
+    virtual void Mult (const MultiVector & x, MultiVector & y) const;
+    /// y[i] += s matrix * x[i] for all vectors
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+
 
 
 
@@ -221,6 +226,10 @@ namespace ngla
       m.MultAdd (s, x, v);
     }
 
+    /// the product is evaluated on its own
+    template <class TS>
+    bool CollectTerms (TS s, VLinearTerms & terms) const { return false; }
+
     NGS_DLL_HEADER void CheckSize (BaseVector & dest_vec) const;
   };
 
@@ -168,6 +168,155 @@ namespace ngla
   }
 
 
+  /// the vector behind an AutoVector
+  static const BaseVector * UnwrapVector (const BaseVector * v)
+  {
+    if (auto av = dynamic_cast<const AutoVector*> (v))
+      return &**av;
+    return v;
+  }
+
+  /// sequential, non-block vectors of the same scalar type and size
+  template <class TV>
+  static bool FusableVectors (const BaseVector & me, FlatArray<const BaseVector*> v)
+  {
+    if (!dynamic_cast<const S_BaseVector<TV>*> (&me) || me.GetParallelStatus() != NOT_PARALLEL)
+      return false;
+    for (auto vi : v)
+      {
+        auto uvi = UnwrapVector (vi);
+        if (!dynamic_cast<const S_BaseVector<TV>*> (uvi) || uvi->GetParallelStatus() != NOT_PARALLEL ||
+            uvi->Size() != me.Size() || uvi->EntrySize() != me.EntrySize())
+          return false;
+      }
+    return true;
+  }
+
+  /// CNT entries of the linear combination, summed in a buffer before they are written
+  template <size_t CNT, class TV, class TS>
+  INLINE void LinearCombinationBlock (TV * me, FlatArray<TS> s, FlatArray<TV*> v,
+                                      size_t first, bool add)
+  {
+    TV buf[CNT];
+    if (add)
+      for (size_t k = 0; k < CNT; k++)
+        buf[k] = me[first+k];
+    else
+      for (size_t k = 0; k < CNT; k++)
+        buf[k] = TV(0.0);
+    for (size_t i = 0; i < v.Size(); i++)
+      {
+        TS si = s[i];
+        const TV * pv = v[i]+first;
+        for (size_t k = 0; k < CNT; k++)
+          buf[k] += si * pv[k];
+      }
+    for (size_t k = 0; k < CNT; k++)
+      me[first+k] = buf[k];
+  }
+
+  /// one sweep over all vectors, the blocks stay in cache
+  template <class TV, class TS>
+  static void FusedLinearCombination (FlatVector<TV> me, FlatArray<TS> s,
+                                      FlatArray<TV*> v, bool add)
+  {
+    ParallelForRange (me.Size(), [me,s,v,add] (IntRange r)
+                      {
+                        constexpr size_t BS = 256;
+                        size_t first = r.First();
+                        for ( ; first+BS <= r.Next(); first += BS)
+                          LinearCombinationBlock<BS> (me.Data(), s, v, first, add);
+                        for ( ; first < r.Next(); first++)
+                          LinearCombinationBlock<1> (me.Data(), s, v, first, add);
+                      });
+  }
+
+  /// term by term, the terms of the vector itself first
+  template <class TS>
+  static void SequentialLinearCombination (BaseVector & me, FlatArray<TS> s,
+                                           FlatArray<const BaseVector*> v, bool add)
+  {
+    bool self = false;
+    TS sself = add ? TS(1.0) : TS(0.0);
+    for (size_t i = 0; i < v.Size(); i++)
+      if (UnwrapVector (v[i]) == &me)
+        {
+          sself += s[i];
+          self = true;
+        }
+    if (self)
+      {
+        me.Scale (sself);
+        add = true;
+      }
+    for (size_t i = 0; i < v.Size(); i++)
+      {
+        if (UnwrapVector (v[i]) == &me) continue;
+        if (add)
+          me.Add (s[i], *v[i]);
+        else
+          me.Set (s[i], *v[i]);
+        add = true;
+      }
+    if (!add)
+      me.SetScalar (0.0);
+  }
+
+  BaseVector & BaseVector :: SetLinearCombination (FlatArray<double> s, FlatArray<const BaseVector*> v,
+                                                   bool add)
+  {
+    static Timer t("BaseVector::SetLinearCombination");
+    RegionTimer reg(t);
+
+    for (auto vi : v)
+      if (vi->Size() != Size())
+        throw Exception (string ("BaseVector::SetLinearCombination: size of me = ") +
+                         ToString(Size()) + " != size of other = " + ToString(vi->Size()));
+
+    if (IsComplex() && FusableVectors<Complex> (*this, v))
+      {
+        ArrayMem<Complex*,8> fv;
+        for (auto vi : v)
+          fv.Append (vi->FVComplex().Data());
+        FusedLinearCombination<Complex> (FVComplex(), s, fv, add);
+      }
+    else if (!IsComplex() && FusableVectors<double> (*this, v))
+      {
+        ArrayMem<double*,8> fv;
+        for (auto vi : v)
+          fv.Append (vi->FVDouble().Data());
+        t.AddFlops (v.Size() * Size() * EntrySize());
+        FusedLinearCombination<double> (FVDouble(), s, fv, add);
+      }
+    else
+      SequentialLinearCombination (*this, s, v, add);
+    return *this;
+  }
+
+  BaseVector & BaseVector :: SetLinearCombination (FlatArray<Complex> s, FlatArray<const BaseVector*> v,
+                                                   bool add)
+  {
+    static Timer t("BaseVector::SetLinearCombination");
+    RegionTimer reg(t);
+
+    for (auto vi : v)
+      if (vi->Size() != Size())
+        throw Exception (string ("BaseVector::SetLinearCombination: size of me = ") +
+                         ToString(Size()) + " != size of other = " + ToString(vi->Size()));
+
+    if (IsComplex() && FusableVectors<Complex> (*this, v))
+      {
+        ArrayMem<Complex*,8> fv;
+        for (auto vi : v)
+          fv.Append (vi->FVComplex().Data());
+        FusedLinearCombination<Complex> (FVComplex(), s, fv, add);
+      }
+    else
+      SequentialLinearCombination (*this, s, v, add);
+    return *this;
+  }
+
+
   double BaseVector :: InnerProductD (const BaseVector & v2) const
   {
     return dynamic_cast<const S_BaseVector<double>&> (*this) . 
@@ -875,6 +1024,268 @@ namespace ngla
     return make_shared<S_BaseVectorPtr<TSCAL>> (range.Size(), es, pdata+range.First()*es);
   }
 
+  /// products of entries for the inner product types
+  template <class IPTYPE> struct IPEntry
+  {
+    template <class T>
+    static T Mult (T a, T b) { return a * b; }
+  };
+  template <> struct IPEntry<ComplexConjugate>
+  {
+    static Complex Mult (Complex a, Complex b) { return a * Conj(b); }
+  };
+  template <> struct IPEntry<ComplexConjugate2>
+  {
+    static Complex Mult (Complex a, Complex b) { return Conj(a) * b; }
+  };
+
+  /// local inner products (a[i], b[i]), the vectors are swept block by block
+  template <class IPTYPE>
+  static void LocalInnerProducts (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                                  FlatVector<typename SCAL_TRAIT<IPTYPE>::SCAL> res)
+  {
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    size_t n = a.Size();
+    res = SCAL(0.0);
+    if (n == 0) return;
+
+    ArrayMem<SCAL*,8> fa, fb;
+    for (size_t i = 0; i < n; i++)
+      {
+        fa.Append (a[i]->FV<SCAL>().Data());
+        fb.Append (b[i]->FV<SCAL>().Data());
+      }
+    size_t size = a[0]->FV<SCAL>().Size();
+
+    constexpr int ntasks = 16;
+    Matrix<SCAL> parts(ntasks, n);
+    parts = SCAL(0.0);
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   constexpr size_t BS = 1024;
+                   auto r = ::Range(size).Split (ti.task_nr, ti.ntasks);
+                   for (size_t first = r.First(); first < r.Next(); first += BS)
+                     {
+                       size_t next = min2 (first+BS, r.Next());
+                       for (size_t i = 0; i < n; i++)
+                         {
+                           SCAL sum = 0.0;
+                           for (size_t k = first; k < next; k++)
+                             sum += IPEntry<IPTYPE>::Mult (fa[i][k], fb[i][k]);
+                           parts(ti.task_nr, i) += sum;
+                         }
+                     }
+                 }, ntasks);
+    for (size_t i = 0; i < n; i++)
+      for (int j = 0; j < ntasks; j++)
+        res(i) += parts(j,i);
+  }
+
+  template <class IPTYPE>
+  void S_InnerProducts (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                        FlatVector<typename SCAL_TRAIT<IPTYPE>::SCAL> res)
+  {
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    static Timer t("S_InnerProducts");
+    RegionTimer reg(t);
+
+    bool fusable = true;
+    for (size_t i = 0; i < a.Size(); i++)
+      {
+        auto ua = UnwrapVector (a[i]), ub = UnwrapVector (b[i]);
+        if (!dynamic_cast<const S_BaseVector<SCAL>*> (ua) ||
+            !dynamic_cast<const S_BaseVector<SCAL>*> (ub) ||
+            ua->GetParallelStatus() != NOT_PARALLEL || ub->GetParallelStatus() != NOT_PARALLEL ||
+            ua->Size() != a[0]->Size() || ub->Size() != a[0]->Size())
+          fusable = false;
+      }
+
+    if (fusable)
+      LocalInnerProducts<IPTYPE> (a, b, res);
+    else
+      for (size_t i = 0; i < a.Size(); i++)
+        res(i) = S_InnerProduct<IPTYPE> (*a[i], *b[i]);
+  }
+
+  // bilinear products of distributed vectors share one reduction
+  template <>
+  void S_InnerProducts<double> (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                                FlatVector<double> res)
+  {
+    InnerProductsReduction<double> reduction;
+    reduction.Start (a, b);
+    auto ips = reduction.Wait();
+    for (size_t i = 0; i < ips.Size(); i++)
+      res(i) = ips[i];
+  }
+
+  template <>
+  void S_InnerProducts<Complex> (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                                 FlatVector<Complex> res)
+  {
+    InnerProductsReduction<Complex> reduction;
+    reduction.Start (a, b);
+    auto ips = reduction.Wait();
+    for (size_t i = 0; i < ips.Size(); i++)
+      res(i) = ips[i];
+  }
+
+  template <class IPTYPE>
+  typename SCAL_TRAIT<IPTYPE>::SCAL
+  S_AddInnerProduct (BaseVector & y, typename SCAL_TRAIT<IPTYPE>::SCAL s,
+                     const BaseVector & x, const BaseVector & z)
+  {
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    static Timer t("S_AddInnerProduct");
+    RegionTimer reg(t);
+
+    const BaseVector * px = &x, * pz = &z;
+    if (!FusableVectors<SCAL> (*UnwrapVector(&y), FlatArray<const BaseVector*> (1, &px)) ||
+        !FusableVectors<SCAL> (*UnwrapVector(&y), FlatArray<const BaseVector*> (1, &pz)))
+      {
+        y.Add (s, x);
+        return S_InnerProduct<IPTYPE> (y, z);
+      }
+
+    auto fy = y.FV<SCAL>();
+    auto fx = x.FV<SCAL>();
+    auto fz = z.FV<SCAL>();
+    SCAL parts[16];
+    ParallelJob ([&] (TaskInfo ti)
+                 {
+                   auto r = ::Range(fy).Split (ti.task_nr, ti.ntasks);
+                   SCAL sum = 0.0;
+                   for (size_t k : r)
+                     {
+                       fy(k) += s * fx(k);
+                       sum += IPEntry<IPTYPE>::Mult (fy(k), fz(k));
+                     }
+                   parts[ti.task_nr] = sum;
+                 }, 16);
+    SCAL sum = 0.0;
+    for (auto part : parts) sum += part;
+    return sum;
+  }
+
+  template NGS_DLL_HEADER void S_InnerProducts<ComplexConjugate>
+  (FlatArray<const BaseVector*>, FlatArray<const BaseVector*>, FlatVector<Complex>);
+  template NGS_DLL_HEADER void S_InnerProducts<ComplexConjugate2>
+  (FlatArray<const BaseVector*>, FlatArray<const BaseVector*>, FlatVector<Complex>);
+  template NGS_DLL_HEADER double S_AddInnerProduct<double>
+  (BaseVector &, double, const BaseVector &, const BaseVector &);
+  template NGS_DLL_HEADER Complex S_AddInnerProduct<Complex>
+  (BaseVector &, Complex, const BaseVector &, const BaseVector &);
+  template NGS_DLL_HEADER Complex S_AddInnerProduct<ComplexConjugate>
+  (BaseVector &, Complex, const BaseVector &, const BaseVector &);
+  template NGS_DLL_HEADER Complex S_AddInnerProduct<ComplexConjugate2>
+  (BaseVector &, Complex, const BaseVector &, const BaseVector &);
+
+
+  template <class IPTYPE>
+  void InnerProductsReduction<IPTYPE> :: Start (FlatArray<const BaseVector*> a,
+                                               FlatArray<const BaseVector*> b)
+  {
+    static Timer t("InnerProductsReduction::Start");
+    RegionTimer reg(t);
+
+    size_t n = a.Size();
+    local.SetSize (n);
+    global.SetSize (n);
+
+    auto unwrap = [] (const BaseVector * x)
+      {
+        auto ax = dynamic_cast<const AutoVector*> (x);
+        return ax ? &**ax : x;
+      };
+    auto is_block = [&] (const BaseVector * x)
+      {
+        return dynamic_cast<const BlockVector*> (unwrap(x)) != nullptr;
+      };
+
+    // block vectors reduce their components themselves
+    bool blocking = false;
+    bool parallel = false;
+    for (size_t i = 0; i < n; i++)
+      {
+        if (is_block(a[i]) || is_block(b[i])) blocking = true;
+        if (a[i]->GetParallelStatus() != NOT_PARALLEL ||
+            b[i]->GetParallelStatus() != NOT_PARALLEL) parallel = true;
+      }
+    if (blocking)
+      {
+        for (size_t i = 0; i < n; i++)
+          global[i] = S_InnerProduct<IPTYPE> (*a[i], *b[i]);
+        pending = false;
+        return;
+      }
+
+    // the left vectors are cumulated, the right ones distributed.
+    // The status is decided per vector, not per pair: a vector may
+    // appear in several pairs, or on both sides (norms).  A right
+    // vector also used on the left gets a distributed copy.
+    ArrayMem<const BaseVector*,20> bd(n), left(n);
+    std::vector<AutoVector> copies;
+    copies.reserve (n);
+    for (size_t i = 0; i < n; i++)
+      {
+        a[i]->Cumulate();
+        bd[i] = b[i];
+        left[i] = unwrap(a[i]);
+      }
+    if (parallel)
+      for (size_t i = 0; i < n; i++)
+        {
+          if (b[i]->GetParallelStatus() != CUMULATED) continue;
+          if (left.Contains (unwrap(b[i])))
+            {
+              for (size_t j = 0; j < i; j++)
+                if (unwrap(b[j]) == unwrap(b[i])) bd[i] = bd[j];
+              if (bd[i] != b[i]) continue;
+              copies.push_back (b[i]->CreateVector());
+              copies.back() = *b[i];
+              copies.back().Distribute();
+              bd[i] = &copies.back();
+            }
+          else
+            b[i]->Distribute();
+        }
+
+    LocalInnerProducts<IPTYPE> (a, bd, FlatVector<SCAL> (n, &local[0]));
+
+    if (!parallel)
+      {
+        global = local;
+        pending = false;
+        return;
+      }
+
+#ifdef PARALLEL
+    // complex values are reduced as pairs of doubles
+    size_t nd = n * sizeof(SCAL) / sizeof(double);
+    request = MyMPI_IAllReduce (FlatArray<double> (nd, reinterpret_cast<double*> (&local[0])),
+                                FlatArray<double> (nd, reinterpret_cast<double*> (&global[0])));
+    pending = true;
+#else
+    global = local;
+#endif
+  }
+
+  template <class IPTYPE>
+  FlatArray<typename InnerProductsReduction<IPTYPE>::SCAL>
+  InnerProductsReduction<IPTYPE> :: Wait ()
+  {
+#ifdef PARALLEL
+    if (pending)
+      MyMPI_Wait (request);
+#endif
+    pending = false;
+    return global;
+  }
+
+  template class InnerProductsReduction<double>;
+  template class InnerProductsReduction<Complex>;
+
+
   template class S_BaseVector<double>;
   template class S_BaseVector<Complex>;
   
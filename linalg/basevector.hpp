@@ -15,6 +15,7 @@ namespace ngla
 
   class BaseVector;
   class AutoVector;
+  class VLinearTerms;
 
   template <class SCAL> class S_BaseVector;
 
@@ -66,6 +67,10 @@ namespace ngla
     /// add s * vector-expression data to v
     template <class TS>
     void AddTo (TS s, BaseVector & v) const { data.AddTo(s, v); }
+
+    /// append s * vector-expression data as terms s_i v_i, false if not a linear combination
+    template <class TS>
+    bool CollectTerms (TS s, VLinearTerms & terms) const { return data.CollectTerms(s, terms); }
   };
 
 
@@ -233,6 +238,12 @@ namespace ngla
     virtual BaseVector & Add (double scal, const BaseVector & v);
     virtual BaseVector & Add (Complex scal, const BaseVector & v);
 
+    /// this = sum s[i] * v[i] (or this += ...) in one sweep, v may contain this
+    virtual BaseVector & SetLinearCombination (FlatArray<double> s, FlatArray<const BaseVector*> v,
+                                               bool add = false);
+    virtual BaseVector & SetLinearCombination (FlatArray<Complex> s, FlatArray<const BaseVector*> v,
+                                               bool add = false);
+
     virtual ostream & Print (ostream & ost) const;
     virtual void Save(ostream & ost) const;
     virtual void Load(istream & ist);
@@ -490,6 +501,17 @@ namespace ngla
       return vec->Add (scal,v);
     }
 
+    virtual BaseVector & SetLinearCombination (FlatArray<double> s, FlatArray<const BaseVector*> v,
+                                               bool add = false)
+    {
+      return vec->SetLinearCombination (s, v, add);
+    }
+    virtual BaseVector & SetLinearCombination (FlatArray<Complex> s, FlatArray<const BaseVector*> v,
+                                               bool add = false)
+    {
+      return vec->SetLinearCombination (s, v, add);
+    }
+
     virtual ostream & Print (ostream & ost) const
     {
       return vec->Print (ost);
@@ -717,6 +739,41 @@ namespace ngla
   /* ********************* Expression templates ***************** */
 
 
+  /**
+     The terms s_i v_i of a linear vector expression.  Sums of vectors
+     are collected and evaluated in one sweep over memory.
+  */
+  class VLinearTerms
+  {
+    ArrayMem<double,8> sr;
+    ArrayMem<Complex,8> sc;
+    ArrayMem<const BaseVector*,8> vecs;
+    bool real = true;
+  public:
+    void Append (double s, const BaseVector & v)
+    {
+      sr.Append (s);
+      sc.Append (s);
+      vecs.Append (&v);
+    }
+
+    void Append (Complex s, const BaseVector & v)
+    {
+      sr.Append (s.real());
+      sc.Append (s);
+      vecs.Append (&v);
+      if (s.imag() != 0) real = false;
+    }
+
+    void AssignTo (BaseVector & v, bool add)
+    {
+      if (real)
+        v.SetLinearCombination (sr, vecs, add);
+      else
+        v.SetLinearCombination (sc, vecs, add);
+    }
+  };
+
 
   template <> class VVecExpr<BaseVector>
   {
@@ -728,6 +785,12 @@ namespace ngla
     void AssignTo (TS s, BaseVector & v2) const { v2.Set (s, v); }
     template <class TS>
     void AddTo (TS s, BaseVector & v2) const { v2.Add (s,  v); }
+    template <class TS>
+    bool CollectTerms (TS s, VLinearTerms & terms) const
+    {
+      terms.Append (s, v);
+      return true;
+    }
   };
 
 
@@ -747,15 +810,32 @@ namespace ngla
     template <class TS>
     void AssignTo (TS s, BaseVector & v) const
     { 
+      VLinearTerms terms;
+      if (CollectTerms (s, terms))
+        {
+          terms.AssignTo (v, false);
+          return;
+        }
       a.AssignTo (s, v);
       b.AddTo (s, v);
     }
     template <class TS>
     void AddTo (TS s, BaseVector & v) const
     { 
+      VLinearTerms terms;
+      if (CollectTerms (s, terms))
+        {
+          terms.AssignTo (v, true);
+          return;
+        }
       a.AddTo (s, v);
       b.AddTo (s, v);
     }
+    template <class TS>
+    bool CollectTerms (TS s, VLinearTerms & terms) const
+    {
+      return a.CollectTerms (s, terms) && b.CollectTerms (s, terms);
+    }
   };
 
 
@@ -814,15 +894,32 @@ namespace ngla
     template <class TS>
     void AssignTo (TS s, BaseVector & v) const
     { 
+      VLinearTerms terms;
+      if (CollectTerms (s, terms))
+        {
+          terms.AssignTo (v, false);
+          return;
+        }
       a.AssignTo (s, v);
       b.AddTo (-s, v);
     }
     template <class TS>
     void AddTo (TS s, BaseVector & v) const
     { 
+      VLinearTerms terms;
+      if (CollectTerms (s, terms))
+        {
+          terms.AssignTo (v, true);
+          return;
+        }
       a.AddTo (s, v);
       b.AddTo (-s, v);
     }
+    template <class TS>
+    bool CollectTerms (TS s, VLinearTerms & terms) const
+    {
+      return a.CollectTerms (s, terms) && b.CollectTerms (-s, terms);
+    }
   };
 
 
@@ -886,6 +983,11 @@ namespace ngla
     { 
       a.AddTo (scal * s, v);
     }
+    template <class TS>
+    bool CollectTerms (TS s, VLinearTerms & terms) const
+    {
+      return a.CollectTerms (scal * s, terms);
+    }
   };
 
 
@@ -1016,6 +1118,51 @@ namespace ngla
     return InnerProduct( v2.FVComplex(), Conj(v1.FVComplex()) );
   }
 
+  /// inner products (a[i], b[i]) in one sweep over the vectors
+  template <class IPTYPE>
+  NGS_DLL_HEADER void S_InnerProducts (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                                       FlatVector<typename SCAL_TRAIT<IPTYPE>::SCAL> res);
+
+  // bilinear products share one reduction for distributed vectors
+  template <>
+  NGS_DLL_HEADER void S_InnerProducts<double> (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                                               FlatVector<double> res);
+  template <>
+  NGS_DLL_HEADER void S_InnerProducts<Complex> (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b,
+                                                FlatVector<Complex> res);
+
+  /// y += s * x, returns the inner product (y,z) of the updated y, in one sweep
+  template <class IPTYPE>
+  NGS_DLL_HEADER typename SCAL_TRAIT<IPTYPE>::SCAL
+  S_AddInnerProduct (BaseVector & y, typename SCAL_TRAIT<IPTYPE>::SCAL s,
+                     const BaseVector & x, const BaseVector & z);
+
+
+  /**
+     Inner products of several pairs of vectors with one global
+     reduction.  Start computes the local parts and posts a non-blocking
+     reduction, Wait returns the global values.  Work done in between,
+     such as a preconditioner or a matrix-vector product, overlaps the
+     reduction.  Bilinear products (IPTYPE double or Complex).
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER InnerProductsReduction
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+  private:
+    Array<SCAL> local, global;
+    bool pending = false;
+#ifdef PARALLEL
+    MPI_Request request;
+#endif
+  public:
+    /// inner products (a[i], b[i])
+    void Start (FlatArray<const BaseVector*> a, FlatArray<const BaseVector*> b);
+    /// waits for the reduction
+    FlatArray<SCAL> Wait ();
+  };
+
   ///
   inline double L2Norm (const BaseVector & v)
   {
@@ -30,6 +30,95 @@ namespace ngla
   { ; }
 
 
+  void BaseBlockJacobiPrecond ::
+  ColorBlocks (const MatrixGraph & graph, size_t width, bool symmetric)
+  {
+    *testout << "block coloring";
+
+    static Timer tcol("BlockJacobi-coloring");
+    tcol.Start();
+
+    size_t nblocks = blocktable->Size();
+    Array<int> coloring(nblocks);
+    coloring = -1;
+
+    int maxcolor = 0;
+    int basecol = 0;
+    Array<unsigned int> mask(width);
+    size_t found = 0;
+
+    do
+      {
+        mask = 0;
+        
+        for (auto i : Range(nblocks))
+          {
+            if (coloring[i] >= 0) continue;
+
+            unsigned check = 0;
+	    for (int d : (*blocktable)[i] )              
+              check |= mask[d];
+            if (symmetric)
+              for (int d : (*blocktable)[i] )
+                for (auto coupling : graph.GetRowIndices(d))
+                  check |= mask[coupling];
+            
+            if (check != UINT_MAX) // 0xFFFFFFFF)
+              {
+                found++;
+                unsigned checkbit = 1;
+                int color = basecol;
+                while (check & checkbit)
+                  {
+                    color++;
+                    checkbit *= 2;
+                  }
+
+                coloring[i] = color;
+                if (color > maxcolor) maxcolor = color;
+                
+                for (int d : (*blocktable)[i] )
+                  {
+                    if (symmetric) mask[d] |= checkbit;
+                    for(auto coupling : graph.GetRowIndices(d))
+                      mask[coupling] |= checkbit;
+                  }
+              }
+          }
+        basecol += 8*sizeof(unsigned int); // 32;
+      }
+    while (found < nblocks);
+    tcol.Stop();    
+
+    TableCreator<int> creator(maxcolor+1);
+    for ( ; !creator.Done(); creator++)
+      for (size_t i = 0; i < nblocks; i++)
+          creator.Add (coloring[i], i);
+    block_coloring = creator.MoveTable();
+
+    cout << IM(4) << " using " << maxcolor+1 << " colors" << endl;
+
+    // calc balancing:
+
+    color_balance.SetSize (block_coloring.Size());
+
+    for (auto c : Range (block_coloring))
+      {
+        color_balance[c].Calc (block_coloring[c].Size(),
+                               [&] (size_t bi)
+                               {
+                                 int costs = 0;
+                                 size_t blocknr = block_coloring[c][bi];
+
+                                 for (auto d : (*blocktable)[blocknr])
+                                   costs += graph.GetRowIndices(d).Size();
+                                 return costs;
+                               });
+
+      }
+  }
+
+
   int BaseBlockJacobiPrecond ::
   Reorder (FlatArray<int> block, const MatrixGraph & graph,
 	   FlatArray<int> block_inv,
@@ -409,82 +498,7 @@ namespace ngla
        } );
     
     cout << IM(3) << "\rBuilding block " << blocktable->Size() << "/" << blocktable->Size() << flush;
-    *testout << "block coloring";
-
-    static Timer tcol("BlockJacobi-coloring");
-    tcol.Start();
-
-    size_t nblocks = blocktable->Size();
-    Array<int> coloring(nblocks);
-    coloring = -1;
-
-    int maxcolor = 0;
-    int basecol = 0;
-    Array<unsigned int> mask(mat.Width());
-    size_t found = 0;
-
-    do
-      {
-        mask = 0;
-        
-        for (auto i : Range(nblocks))
-          {
-            if (coloring[i] >= 0) continue;
-
-            unsigned check = 0;
-	    for (int d : (*blocktable)[i] )              
-              check |= mask[d];
-            
-            if (check != UINT_MAX) // 0xFFFFFFFF)
-              {
-                found++;
-                unsigned checkbit = 1;
-                int color = basecol;
-                while (check & checkbit)
-                  {
-                    color++;
-                    checkbit *= 2;
-                  }
-
-                coloring[i] = color;
-                if (color > maxcolor) maxcolor = color;
-                
-                for (int d : (*blocktable)[i] )
-                  for(auto coupling : mat.GetRowIndices(d))
-                    mask[coupling] |= checkbit;
-              }
-          }
-        basecol += 8*sizeof(unsigned int); // 32;
-      }
-    while (found < nblocks);
-    tcol.Stop();    
-
-    TableCreator<int> creator(maxcolor+1);
-    for ( ; !creator.Done(); creator++)
-      for (size_t i = 0; i < nblocks; i++)
-          creator.Add (coloring[i], i);
-    block_coloring = creator.MoveTable();
-
-    cout << IM(4) << " using " << maxcolor+1 << " colors" << endl;
-
-    // calc balancing:
-
-    color_balance.SetSize (block_coloring.Size());
-
-    for (auto c : Range (block_coloring))
-      {
-        color_balance[c].Calc (block_coloring[c].Size(),
-                               [&] (size_t bi)
-                               {
-                                 int costs = 0;
-                                 size_t blocknr = block_coloring[c][bi];
-
-                                 for (auto d : (*blocktable)[blocknr])
-                                   costs += mat.GetRowIndices(d).Size();
-                                 return costs;
-                               });
-
-      }
+    ColorBlocks (mat, mat.Width());
 
     cout << IM(3) << "\rBlockJacobi Preconditioner built" << endl;
   }
@@ -1199,6 +1213,201 @@ namespace ngla
 
 
 
+  BlockJacobiPrecondFloat ::
+  BlockJacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                           shared_ptr<Table<int>> ablocktable,
+                           bool parallel)
+    : BaseBlockJacobiPrecond(ablocktable), mat(amat)
+  {
+    static Timer t("BlockJacobiPrecondFloat ctor"); RegionTimer reg(t);
+    cout << IM(3) << "BlockJacobi Preconditioner (float), constructor called, #blocks = " << blocktable->Size() << endl;
+
+    size_t nblocks = blocktable->Size();
+    firstinv.SetSize (nblocks+1);
+    firstinv[0] = 0;
+    nze = 0;
+    for (size_t i = 0; i < nblocks; i++)
+      {
+        firstinv[i+1] = firstinv[i] + sqr ((*blocktable)[i].Size());
+        for (auto row : (*blocktable)[i])
+          nze += mat.GetRowIndices(row).Size();
+      }
+    bigmem.SetSize (firstinv[nblocks]);
+
+    auto invert_block = [&] (size_t i)
+      {
+        auto blocki = (*blocktable)[i];
+        QuickSort (blocki);
+        size_t bs = blocki.Size();
+        if (!bs) return;
+
+        Matrix<double> blockmat(bs, bs);
+        for (size_t j = 0; j < bs; j++)
+          for (size_t k = 0; k < bs; k++)
+            blockmat(j,k) = mat(blocki[j], blocki[k]);
+        CalcInverse (blockmat);
+
+        float * inv = &bigmem[firstinv[i]];
+        for (size_t j = 0; j < bs*bs; j++)
+          inv[j] = blockmat(j/bs, j%bs);
+      };
+
+    if (parallel)
+      ParallelFor (nblocks, invert_block, TasksPerThread(4));
+    else
+      for (size_t i = 0; i < nblocks; i++)
+        invert_block (i);
+
+    ColorBlocks (mat, mat.Width(), mat.IsSymmetric());
+    cout << IM(3) << "\rBlockJacobi Preconditioner built" << endl;
+  }
+
+
+  template <bool TRANS>
+  void BlockJacobiPrecondFloat ::
+  MultAddImpl (double s, FlatVector<double> fx, FlatVector<double> fy) const
+  {
+    for (int c : Range(block_coloring))
+      ParallelForRange
+        (color_balance[c], [&] (IntRange r)
+         {
+           VectorMem<100,double> hx(maxbs);
+           
+           for (size_t i : block_coloring[c].Range(r))
+             {
+               FlatArray<int> block = (*blocktable)[i];
+               size_t bs = block.Size();
+               const float * inv = &bigmem[firstinv[i]];
+               
+               for (size_t j = 0; j < bs; j++)
+                 hx(j) = fx(block[j]);
+
+               for (size_t j = 0; j < bs; j++)
+                 {
+                   double sum = 0;
+                   for (size_t k = 0; k < bs; k++)
+                     sum += double(TRANS ? inv[k*bs+j] : inv[j*bs+k]) * hx(k);
+                   fy(block[j]) += s * sum;
+                 }
+             }
+         });
+  }
+
+  void BlockJacobiPrecondFloat ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer timer("BlockJacobiFloat::MultAdd");
+    RegionTimer reg (timer);
+    timer.AddFlops (bigmem.Size());
+    MultAddImpl<false> (s, x.FV<double>(), y.FV<double>());
+  }
+
+  void BlockJacobiPrecondFloat ::
+  MultTransAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer timer("BlockJacobiFloat::MultTransAdd");
+    RegionTimer reg (timer);
+    timer.AddFlops (bigmem.Size());
+    MultAddImpl<true> (s, x.FV<double>(), y.FV<double>());
+  }
+
+
+  void BlockJacobiPrecondFloat ::
+  SmoothBlock (size_t i, FlatVector<double> fx, FlatVector<double> fb,
+               FlatVector<double> hx) const
+  {
+    FlatArray<int> block = (*blocktable)[i];
+    size_t bs = block.Size();
+    const float * inv = &bigmem[firstinv[i]];
+
+    for (size_t j = 0; j < bs; j++)
+      hx(j) = fb(block[j]) - mat.RowTimesVector (block[j], fx);
+
+    for (size_t j = 0; j < bs; j++)
+      {
+        double sum = 0;
+        for (size_t k = 0; k < bs; k++)
+          sum += double(inv[j*bs+k]) * hx(k);
+        fx(block[j]) += sum;
+      }
+  }
+
+  void BlockJacobiPrecondFloat ::
+  SmoothBlockSymmetric (size_t i, FlatVector<double> fx, FlatVector<double> fy,
+                        FlatVector<double> hx) const
+  {
+    FlatArray<int> block = (*blocktable)[i];
+    size_t bs = block.Size();
+    const float * inv = &bigmem[firstinv[i]];
+
+    // residual of the block: y holds b minus the upper part and the diagonal
+    for (size_t j = 0; j < bs; j++)
+      hx(j) = fy(block[j]) - mat.RowTimesVectorNoDiag (block[j], fx);
+
+    for (size_t j = 0; j < bs; j++)
+      {
+        double sum = 0;
+        for (size_t k = 0; k < bs; k++)
+          sum += double(inv[j*bs+k]) * hx(k);
+        fx(block[j]) += sum;
+        mat.AddRowTransToVector (block[j], -sum, fy);
+      }
+  }
+
+  void BlockJacobiPrecondFloat ::
+  Smooth (BaseVector & x, const BaseVector & b, int steps, bool forward) const
+  {
+    FlatVector<double> fb = b.FV<double> (); 
+    FlatVector<double> fx = x.FV<double> ();
+
+    Vector<double> y;
+    if (mat.IsSymmetric())
+      {
+        // y = b - (D+L^t) x
+        y.SetSize (fx.Size());
+        y = fb;
+        for (size_t i = 0; i < fx.Size(); i++)
+          mat.AddRowTransToVector (i, -fx(i), y);
+      }
+
+    for (int k = 0; k < steps; k++)
+      for (int c1 : Range(block_coloring))
+        {
+          int c = forward ? c1 : block_coloring.Size()-1-c1;
+          ParallelForRange
+            (color_balance[c], [&] (IntRange r)
+             {
+               VectorMem<100,double> hx(maxbs);
+               for (size_t i : block_coloring[c].Range(r))
+                 if (mat.IsSymmetric())
+                   SmoothBlockSymmetric (i, fx, y, hx);
+                 else
+                   SmoothBlock (i, fx, fb, hx);
+             });
+        }
+  }
+
+  void BlockJacobiPrecondFloat ::
+  GSSmooth (BaseVector & x, const BaseVector & b, int steps) const 
+  {
+    static Timer timer ("BlockJacobiPrecondFloat::GSSmooth");
+    RegionTimer reg(timer);
+    timer.AddFlops (nze);
+    Smooth (x, b, steps, true);
+  }
+
+  void BlockJacobiPrecondFloat ::
+  GSSmoothBack (BaseVector & x, const BaseVector & b, int steps) const 
+  {
+    static Timer timer ("BlockJacobiPrecondFloat::GSSmoothBack");
+    RegionTimer reg(timer);
+    timer.AddFlops (nze);
+    Smooth (x, b, steps, false);
+  }
+
+
+
+
   // compiled separately, for testing only
   template class BlockJacobiPrecond<double>;
   template class BlockJacobiPrecond<Complex>;
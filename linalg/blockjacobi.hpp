@@ -62,6 +62,11 @@ namespace ngla
     }
 
 
+    /// colors blocks not coupling via the graph, and balances the colors.
+    /// For a lower triangle graph (symmetric), blocks of one color also
+    /// get disjoint coupling sets, since smoothing writes to the transposed rows
+    void ColorBlocks (const MatrixGraph & graph, size_t width, bool symmetric = false);
+
     /// reorders block entries for band-width minimization
     int Reorder (FlatArray<int> block, const MatrixGraph & graph,
 		 FlatArray<int> usedflags,        // in and out: array of -1, size = graph.size
@@ -190,6 +195,73 @@ namespace ngla
 
 
 
+  /**
+     Block-Jacobi preconditioner for SparseMatrixFloat.
+     Block inverses are computed in double and stored in float.
+  */
+  class NGS_DLL_HEADER BlockJacobiPrecondFloat : virtual public BaseBlockJacobiPrecond,
+                                                virtual public S_BaseMatrix<double>
+  {
+  protected:
+    /// a reference to the matrix
+    const SparseMatrixFloat & mat;
+    /// inverse of block i starts at firstinv[i]
+    Array<size_t> firstinv;
+    /// the data for the inverses
+    Array<float> bigmem;
+
+  public:
+    ///
+    BlockJacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                             shared_ptr<Table<int>> ablocktable,
+                             bool parallel = true);
+
+    virtual int VHeight() const override { return mat.Height(); }
+    virtual int VWidth() const override { return mat.Width(); }
+    
+    virtual AutoVector CreateVector () const override
+    {
+      return mat.CreateVector();
+    }
+
+    ///
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override; 
+    ///
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    ///
+    virtual void GSSmooth (BaseVector & x, const BaseVector & b,
+			   int steps = 1) const override;
+
+    virtual void GSSmoothBack (BaseVector & x, const BaseVector & b,
+			       int steps = 1) const override;
+  
+    virtual void GSSmoothResiduum (BaseVector & x, const BaseVector & b,
+				   BaseVector & res, int steps = 1) const override
+    {
+      GSSmooth (x, b, 1);
+      res = b - mat * x;
+    }
+
+    virtual Array<MemoryUsage> GetMemoryUsage () const override
+    {
+      return { MemoryUsage ("BlockJacFloat", bigmem.Size()*sizeof(float), blocktable->Size()) };
+    }
+
+  private:
+    template <bool TRANS>
+    void MultAddImpl (double s, FlatVector<double> fx, FlatVector<double> fy) const;
+    void SmoothBlock (size_t i, FlatVector<double> fx, FlatVector<double> fb,
+                      FlatVector<double> hx) const;
+    /// symmetric matrix: keeps y = b - (D+L^T) x up to date
+    void SmoothBlockSymmetric (size_t i, FlatVector<double> fx, FlatVector<double> fy,
+                               FlatVector<double> hx) const;
+    void Smooth (BaseVector & x, const BaseVector & b, int steps, bool forward) const;
+  };
+
+
+
+
   /* **************** SYMMETRIC ****************** */
 
 
@@ -0,0 +1,362 @@
+/*********************************************************************/
+/* File:   bsrmatrix.cpp                                             */
+/* Date:   17. Oct. 2026                                             */
+/*********************************************************************/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  BaseBSRMatrix :: BaseBSRMatrix (const Array<int> & elsperrow, int abs, bool asymmetric)
+    : BaseSparseMatrix (elsperrow, elsperrow.Size()), bs(abs), symmetric(asymmetric),
+      data(nze*abs*abs+1)
+  {
+    data[nze*bs*bs] = 0.0;
+  }
+
+  BaseBSRMatrix :: ~BaseBSRMatrix ()
+  { ; }
+
+
+  shared_ptr<BaseBSRMatrix> BaseBSRMatrix :: Create (const MatrixGraph & graph, int bs, bool symmetric)
+  {
+    static Timer t("BSRMatrix - create"); RegionTimer reg(t);
+
+    if (graph.Size() % bs != 0) return nullptr;
+    size_t n = graph.Size() / bs;
+
+    // block row i is the union of the scalar rows k*n+i, columns taken modulo n
+    auto blockrow = [&] (size_t i, Array<int> & cols)
+      {
+        cols.SetSize0();
+        for (int k = 0; k < bs; k++)
+          for (int c : graph.GetRowIndices(k*n+i))
+            cols.Append (c % n);
+        QuickSort (cols);
+        size_t cnt = 0;
+        for (size_t j = 0; j < cols.Size(); j++)
+          if (cnt == 0 || cols[j] != cols[cnt-1])
+            cols[cnt++] = cols[j];
+        cols.SetSize (cnt);
+      };
+
+    Array<int> elsperrow(n);
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        Array<int> cols;
+                        for (auto i : r)
+                          {
+                            blockrow (i, cols);
+                            elsperrow[i] = cols.Size();
+                          }
+                      });
+
+    shared_ptr<BaseBSRMatrix> mat;
+    switch (bs)
+      {
+      case 2: mat = make_shared<BSRMatrix<2>> (elsperrow, symmetric); break;
+      case 3: mat = make_shared<BSRMatrix<3>> (elsperrow, symmetric); break;
+      default: return nullptr;
+      }
+
+    ParallelForRange (n, [&] (IntRange r)
+                      {
+                        Array<int> cols;
+                        for (auto i : r)
+                          {
+                            blockrow (i, cols);
+                            FlatArray<int> rowind = mat->GetRowIndices(i);
+                            rowind = cols;
+                          }
+                      });
+    mat->SetZero();
+    return mat;
+  }
+
+
+  AutoVector BaseBSRMatrix :: CreateVector () const
+  {
+    return make_shared<VVector<double>> (bs*size);
+  }
+
+  AutoVector BaseBSRMatrix :: CreateRowVector () const
+  {
+    return make_shared<VVector<double>> (bs*width);
+  }
+
+  AutoVector BaseBSRMatrix :: CreateColVector () const
+  {
+    return make_shared<VVector<double>> (bs*size);
+  }
+
+  void BaseBSRMatrix :: SetZero ()
+  {
+    FlatArray<double> hdata = data;
+    ParallelForRange (nze*bs*bs, [hdata] (IntRange r)
+                      {
+                        hdata.Range(r) = 0.0;
+                      });
+  }
+
+
+  shared_ptr<SparseMatrixTM<double>> BaseBSRMatrix :: CreateSparseMatrix () const
+  {
+    static Timer t("BSRMatrix - to CSR"); RegionTimer reg(t);
+
+    // scalar row k*n+i has columns l*n+j for all blocks (i,j), sorted by l, then j
+    size_t n = size;
+    Array<int> elsperrow(bs*n);
+    for (int k = 0; k < bs; k++)
+      for (size_t i = 0; i < n; i++)
+        {
+          int cnt = 0;
+          for (int l = 0; l < bs; l++)
+            for (int j : GetRowIndices(i))
+              if (!symmetric || l*n+j <= k*n+i) cnt++;
+          elsperrow[k*n+i] = cnt;
+        }
+
+    shared_ptr<SparseMatrixTM<double>> mat;
+    if (symmetric)
+      mat = make_shared<SparseMatrixSymmetric<double>> (elsperrow);
+    else
+      mat = make_shared<SparseMatrix<double>> (elsperrow, bs*n);
+
+    CopyToScalar (*mat);
+    mat->SetInverseType (inversetype);
+    mat->SetSPD (spd);
+    mat->SetParallelDofs (GetParallelDofs());
+    return mat;
+  }
+
+
+  void BaseBSRMatrix :: CopyToScalar (SparseMatrixTM<double> & mat) const
+  {
+    size_t n = size;
+    ParallelFor (bs*n, [&] (size_t row)
+                 {
+                   size_t k = row / n, i = row % n;
+                   FlatArray<int> cols = mat.GetRowIndices(row);
+                   FlatVector<double> vals = mat.GetRowValues(row);
+                   size_t cnt = 0;
+                   for (int l = 0; l < bs; l++)
+                     for (size_t pos = firsti[i]; pos < firsti[i+1]; pos++)
+                       {
+                         size_t col = l*n+colnr[pos];
+                         if (symmetric && col > row) continue;
+                         cols[cnt] = col;
+                         vals(cnt) = data[pos*bs*bs + l*bs + k];
+                         cnt++;
+                       }
+                 });
+  }
+
+  shared_ptr<SparseMatrixTM<double>> BaseBSRMatrix :: ScalarCopy () const
+  {
+    if (!csr)
+      csr = CreateSparseMatrix();
+    else
+      {
+        CopyToScalar (*csr);
+        csr->SetInverseType (inversetype);
+      }
+    return csr;
+  }
+
+
+  shared_ptr<BaseMatrix> BaseBSRMatrix :: InverseMatrix (shared_ptr<BitArray> subset) const
+  {
+    ScalarCopy();
+    return csr->InverseMatrix (subset);
+  }
+
+  shared_ptr<BaseMatrix> BaseBSRMatrix :: InverseMatrix (shared_ptr<const Array<int>> clusters) const
+  {
+    ScalarCopy();
+    return csr->InverseMatrix (clusters);
+  }
+
+  shared_ptr<BaseBlockJacobiPrecond>
+  BaseBSRMatrix :: CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
+                                             const BaseVector * constraint,
+                                             bool parallel,
+                                             shared_ptr<BitArray> freedofs) const
+  {
+    ScalarCopy();
+    return csr->CreateBlockJacobiPrecond (blocks, constraint, parallel, freedofs);
+  }
+
+
+  Array<MemoryUsage> BaseBSRMatrix :: GetMemoryUsage () const
+  {
+    Array<MemoryUsage> mu = MatrixGraph::GetMemoryUsage();
+    mu += { "BSRMatrix", nze*bs*bs*sizeof(double), 1 };
+    return mu;
+  }
+
+  ostream & BaseBSRMatrix :: Print (ostream & ost) const
+  {
+    for (int i = 0; i < size; i++)
+      {
+        ost << "Row " << i << ":";
+        for (size_t pos = firsti[i]; pos < firsti[i+1]; pos++)
+          {
+            ost << "   " << colnr[pos] << ":";
+            for (int k = 0; k < bs; k++)
+              for (int l = 0; l < bs; l++)
+                ost << " " << data[pos*bs*bs+l*bs+k];
+          }
+        ost << "\n";
+      }
+    return ost;
+  }
+
+
+  list<tuple<string,double>> BaseBSRMatrix :: Timing () const
+  {
+    list<tuple<string,double>> results;
+    auto x = CreateRowVector();
+    auto y = CreateColVector();
+    x.FV<double>() = 1.0;
+
+    auto scal = CreateSparseMatrix();
+    size_t nzefull = max2 (NZE(), size_t(1));
+    double time = RunTiming ([&] () { scal->Mult (x, y); });
+    results.push_back (make_tuple ("scalar Mult, per nze", 1e9 * time / nzefull));
+    time = RunTiming ([&] () { Mult (x, y); });
+    results.push_back (make_tuple ("block Mult, per nze", 1e9 * time / nzefull));
+    return results;
+  }
+
+
+
+  template <int BS>
+  void BSRMatrix<BS> :: AddElementMatrix (FlatArray<int> dnums1, FlatArray<int> dnums2,
+                                          BareSliceMatrix<double> elmat, bool use_atomic)
+  {
+    int n = size;
+    // walk the sorted block columns of the element along the block row
+    ArrayMem<int, 100> bcols(dnums2.Size()), map(dnums2.Size());
+    for (size_t j = 0; j < dnums2.Size(); j++)
+      {
+        bcols[j] = IsRegularIndex(dnums2[j]) ? dnums2[j] % n : -1;
+        map[j] = j;
+      }
+    QuickSortI (bcols, map);
+
+    for (size_t i = 0; i < dnums1.Size(); i++)
+      {
+        if (!IsRegularIndex(dnums1[i])) continue;
+        int brow = dnums1[i] % n;
+        int k = dnums1[i] / n;
+
+        FlatArray<int> rowind = GetRowIndices(brow);
+        size_t first = firsti[brow];
+        size_t pos = 0;
+        for (size_t j1 = 0; j1 < map.Size(); j1++)
+          {
+            int j = map[j1];
+            if (bcols[j] < 0) continue;
+            while (rowind[pos] != bcols[j])
+              {
+                pos++;
+                if (pos >= rowind.Size())
+                  throw Exception ("BSRMatrix::AddElementMatrix: illegal dnums");
+              }
+            double & val = data[(first+pos)*BS*BS + (dnums2[j]/n)*BS + k];
+            if (use_atomic)
+              MyAtomicAdd (val, elmat(i,j));
+            else
+              val += elmat(i,j);
+          }
+      }
+  }
+
+
+  template <int BS>
+  void BSRMatrix<BS> :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t(string("BSRMatrix<")+ToString(BS)+">::Mult"); RegionTimer reg(t);
+    t.AddFlops (NZE());
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    size_t n = size;
+    ParallelForRange (balance, [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          {
+                            Vec<BS> sum = RowTimesVector (i, fx);
+                            for (int k = 0; k < BS; k++)
+                              fy(k*n+i) = sum(k);
+                          }
+                      });
+  }
+
+  template <int BS>
+  void BSRMatrix<BS> :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t(string("BSRMatrix<")+ToString(BS)+">::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (NZE());
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    size_t n = size;
+    ParallelForRange (balance, [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          {
+                            Vec<BS> sum = RowTimesVector (i, fx);
+                            for (int k = 0; k < BS; k++)
+                              fy(k*n+i) += s * sum(k);
+                          }
+                      });
+  }
+
+  template <int BS>
+  void BSRMatrix<BS> :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t(string("BSRMatrix<")+ToString(BS)+">::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (NZE());
+
+    if (symmetric)
+      {
+        MultAdd (s, x, y);
+        return;
+      }
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    size_t n = size;
+    for (size_t i = 0; i < n; i++)
+      {
+        Vec<BS> xi;
+        for (int k = 0; k < BS; k++)
+          xi(k) = s * fx(k*n+i);
+        for (size_t j = firsti[i]; j < firsti[i+1]; j++)
+          {
+            const double * pb = &data[j*BS*BS];
+            for (int l = 0; l < BS; l++)
+              {
+                double sum = 0;
+                for (int k = 0; k < BS; k++)
+                  sum += pb[l*BS+k] * xi(k);
+                fy(l*n+colnr[j]) += sum;
+              }
+          }
+      }
+  }
+
+
+  template <int BS>
+  shared_ptr<BaseJacobiPrecond>
+  BSRMatrix<BS> :: CreateJacobiPrecond (shared_ptr<BitArray> inner) const
+  {
+    return make_shared<BSRJacobiPrecond<BS>> (*this, inner);
+  }
+
+
+  template class BSRMatrix<2>;
+  template class BSRMatrix<3>;
+}
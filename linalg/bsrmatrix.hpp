@@ -0,0 +1,151 @@
+#ifndef FILE_NGS_BSRMATRIX
+#define FILE_NGS_BSRMATRIX
+
+/**************************************************************************/
+/* File:   bsrmatrix.hpp                                                  */
+/* Date:   17. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Sparse matrix of dense bs x bs blocks (block compressed rows).
+
+     Vectors are numbered component by component, as a compound space of
+     bs equal components numbers its dofs: scalar index k*n+i is
+     component k of block i, where n is the number of block rows.  One
+     column index serves bs*bs values, blocks are stored column major
+     and multiplied by SIMD columns.
+
+     Symmetric matrices store the full pattern.  Direct solvers and block
+     smoothers work on a scalar copy.
+  */
+  class NGS_DLL_HEADER BaseBSRMatrix : public BaseSparseMatrix,
+                                       public S_BaseMatrix<double>
+  {
+  protected:
+    int bs;
+    bool symmetric;
+    /// bs*bs values per block, plus one for SIMD loads behind the last block
+    NumaDistributedArray<double> data;
+    VFlatVector<double> asvec;
+    /// scalar copy, kept alive for inverses and smoothers referencing it
+    mutable shared_ptr<SparseMatrixTM<double>> csr;
+
+  public:
+    BaseBSRMatrix (const Array<int> & elsperrow, int abs, bool asymmetric);
+    virtual ~BaseBSRMatrix ();
+
+    /// block pattern from the scalar graph, returns nullptr for unsupported block sizes
+    static shared_ptr<BaseBSRMatrix> Create (const MatrixGraph & graph, int bs, bool symmetric);
+
+    int BlockSize () const { return bs; }
+    bool IsSymmetricStorage () const { return symmetric; }
+
+    virtual int VHeight() const override { return bs*size; }
+    virtual int VWidth() const override { return bs*width; }
+
+    virtual AutoVector CreateVector () const override;
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
+
+    virtual BaseVector & AsVector() override
+    {
+      asvec.AssignMemory (nze*bs*bs, (void*)data.Addr(0));
+      return asvec;
+    }
+
+    virtual const BaseVector & AsVector() const override
+    {
+      const_cast<VFlatVector<double>&> (asvec).AssignMemory (nze*bs*bs, (void*)data.Addr(0));
+      return asvec;
+    }
+
+    virtual void SetZero() override;
+
+    /// values of the block at position pos, column major
+    double * GetBlock (size_t pos) const { return const_cast<double*> (&data[pos*bs*bs]); }
+
+    double operator() (int row, int col) const
+    {
+      size_t pos = GetPositionTest (row % size, col % width);
+      return (pos != numeric_limits<size_t>::max())
+        ? data[pos*bs*bs + (col/width)*bs + row/size] : 0.0;
+    }
+
+    static bool IsRegularIndex (int index) { return index >= 0; }
+    virtual void AddElementMatrix (FlatArray<int> dnums1, FlatArray<int> dnums2,
+                                   BareSliceMatrix<double> elmat, bool use_atomic = false) = 0;
+
+    /// scalar copy of the current values
+    shared_ptr<SparseMatrixTM<double>> CreateSparseMatrix () const;
+
+    virtual shared_ptr<BaseMatrix>
+      InverseMatrix (shared_ptr<BitArray> subset = nullptr) const override;
+    virtual shared_ptr<BaseMatrix>
+      InverseMatrix (shared_ptr<const Array<int>> clusters) const override;
+
+    virtual shared_ptr<BaseBlockJacobiPrecond>
+      CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
+                                const BaseVector * constraint = 0,
+                                bool parallel  = 1,
+                                shared_ptr<BitArray> freedofs = NULL) const override;
+
+    virtual size_t NZE () const override { return nze*bs*bs; }
+    virtual Array<MemoryUsage> GetMemoryUsage () const override;
+    virtual ostream & Print (ostream & ost) const override;
+
+    /// compares scalar and block matrix-vector products
+    list<tuple<string,double>> Timing () const;
+
+  protected:
+    /// pattern and values into a scalar matrix with the pattern of CreateSparseMatrix
+    void CopyToScalar (SparseMatrixTM<double> & mat) const;
+    /// the kept scalar copy, with current values
+    shared_ptr<SparseMatrixTM<double>> ScalarCopy () const;
+  };
+
+
+  template <int BS>
+  class NGS_DLL_HEADER BSRMatrix : public BaseBSRMatrix
+  {
+    /// SIMD type holding one block column
+    typedef SIMD<double, (BS==2) ? 2 : 4> TCOL;
+
+  public:
+    BSRMatrix (const Array<int> & elsperrow, bool asymmetric)
+      : BaseBSRMatrix (elsperrow, BS, asymmetric) { ; }
+
+    /// block row times vector, x in component-wise numbering
+    Vec<BS> RowTimesVector (int row, FlatVector<double> x) const
+    {
+      size_t n = width;
+      TCOL sum(0.0);
+      for (size_t j = firsti[row]; j < firsti[row+1]; j++)
+        {
+          const double * pb = &data[j*BS*BS];
+          size_t col = colnr[j];
+          for (int l = 0; l < BS; l++)
+            sum += TCOL(pb+l*BS) * TCOL(x(l*n+col));
+        }
+      Vec<BS> res;
+      for (int k = 0; k < BS; k++)
+        res(k) = sum[k];
+      return res;
+    }
+
+    virtual void AddElementMatrix (FlatArray<int> dnums1, FlatArray<int> dnums2,
+                                   BareSliceMatrix<double> elmat, bool use_atomic = false) override;
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual shared_ptr<BaseJacobiPrecond>
+      CreateJacobiPrecond (shared_ptr<BitArray> inner = nullptr) const override;
+  };
+
+}
+
+#endif
@@ -76,6 +76,19 @@ namespace ngla
     return a->CreateVector();
   }
 
+  void KrylovSpaceSolver :: Mult (const MultiVector & v, MultiVector & prod) const
+  {
+    if (v.Size() != prod.Size())
+      throw Exception ("KrylovSpaceSolver::Mult: MultiVectors of different size");
+    int allsteps = 0;
+    for (size_t i = 0; i < v.Size(); i++)
+      {
+        Mult (v[i], prod[i]);
+        allsteps = max2 (allsteps, steps);
+      }
+    const_cast<int&> (steps) = allsteps;
+  }
+
 
   template <class SCAL>
   void BruteInnerProduct(const BaseVector & a, const BaseVector & b, Vector<SCAL> & result, const int start = 0)
@@ -612,18 +625,22 @@ namespace ngla
 	    
 	    al = wd / kss;
 	    u += al * s;
-	    d -= al * w;
 
 	    if (c)
-	      w = (*c) * d;
+	      {
+	        d -= al * w;
+	        w = (*c) * d;
+	        wdn = S_InnerProduct<IPTYPE> (d, w);
+	        be = wdn / wd;
+	        s = be * s + w;
+	      }
 	    else
-	      w = d;
-	    wdn = S_InnerProduct<IPTYPE> (d, w);
-
-	    be = wdn / wd;
-	    
-	    s *= be;
-	    s += w;
+	      {
+	        // residual update and its norm in one sweep
+	        wdn = S_AddInnerProduct<IPTYPE> (d, -al, w, d);
+	        be = wdn / wd;
+	        s = be * s + d;
+	      }
 
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (wdn)) << endl;
 	    if ( sh )
@@ -887,7 +904,9 @@ namespace ngla
         Matrix<SCAL> h(maxsteps+1, maxsteps);
         Matrix<SCAL> h2(maxsteps+1, maxsteps);
         Vector<SCAL> gammai(maxsteps), ci(maxsteps), si(maxsteps);
-
+        Vector<SCAL> hcol(maxsteps);
+        Array<const BaseVector*> va, vb;
+        Array<SCAL> coefs;
 
         h = SCAL(0.0);
         h2 = SCAL(0.0);
@@ -935,12 +954,28 @@ namespace ngla
                 av = hv;
               }
 
+            // all projections in one sweep, and the orthogonalization in another
+            va.SetSize(j+1);
+            vb.SetSize(j+1);
             for (int i = 0; i <= j; i++)
-              h2(i,j) = h(i,j) = S_InnerProduct<IPTYPE> (*vi[i], av);
+              {
+                va[i] = &*vi[i];
+                vb[i] = &av;
+              }
+            S_InnerProducts<IPTYPE> (va, vb, hcol.Range(0, j+1));
+            for (int i = 0; i <= j; i++)
+              h2(i,j) = h(i,j) = hcol(i);
 
-            w = av;
+            coefs.SetSize(j+2);
+            vb.SetSize(j+2);
+            coefs[0] = 1.0;
+            vb[0] = &av;
             for (int i = 0; i <= j; i++)
-              w -= h(i,j) * (*vi[i]);
+              {
+                coefs[i+1] = -h(i,j);
+                vb[i+1] = &*vi[i];
+              }
+            w.SetLinearCombination (coefs, vb);
 
             v = (1.0 / sqrt (S_InnerProduct<IPTYPE> (w, w))) * w;
             h2(j+1,j) = h(j+1,j) = S_InnerProduct<IPTYPE> (v, av);
@@ -1038,6 +1073,538 @@ namespace ngla
 
 
 
+  template <class IPTYPE>
+  void PipelinedCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("pipelined CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+        // Ghysels, Vanroose: Hiding global synchronization latency in the
+        // preconditioned conjugate gradient algorithm, Parallel Computing 2014
+        auto r = f.CreateVector();    // residual
+        auto u = f.CreateVector();    // M r
+        auto w = f.CreateVector();    // A u
+        auto m = f.CreateVector();    // M w
+        auto an = f.CreateVector();   // A m
+        auto p = f.CreateVector();    // search direction
+        auto ap = f.CreateVector();   // A p
+        auto q = f.CreateVector();    // M A p
+        auto z = f.CreateVector();    // A M A p
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+	if (c)
+	  u = (*c) * r;
+	else
+	  u = r;
+        w = (*a) * u;
+
+        InnerProductsReduction<IPTYPE> reduction;
+        Array<const BaseVector*> va { &r, &w }, vb { &u, &u };
+
+        SCAL gamma, gamma_old = 0.0, delta, alpha = 0.0, beta;
+        double err = 0, lwstart = 0, lerr = 0;
+        int n = 0;
+        for ( ; ; n++)
+          {
+            // the reduction runs during preconditioner and matrix-vector product
+            reduction.Start (va, vb);
+            if (c)
+              m = (*c) * w;
+            else
+              m = w;
+            an = (*a) * m;
+            auto ips = reduction.Wait();
+            gamma = ips[0];
+            delta = ips[1];
+
+            if (n == 0)
+              {
+                if (printrates) cout << IM(1) << "0 " << sqrt(Abs(gamma)) << endl;
+                double start = (gamma == 0.0) ? 1.0 : Abs(gamma);
+                err = stop_absolute ? prec * prec : prec * prec * start;
+                lwstart = log(start);
+                lerr = log(err);
+              }
+            else
+              {
+                if (printrates) cout << IM(1) << n << " " << sqrt (Abs (gamma)) << endl;
+                if (sh)
+                  sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+                                                    (lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+              }
+
+            if (Abs(gamma) <= err || n >= maxsteps || (sh && sh->ShouldTerminate())) break;
+            if (delta == 0.0) break;
+
+            if (n == 0)
+              {
+                alpha = gamma / delta;
+                z = an;
+                q = m;
+                ap = w;
+                p = u;
+              }
+            else
+              {
+                beta = gamma / gamma_old;
+                alpha = gamma / (delta - beta * gamma / alpha);
+                z *= beta;
+                z += an;
+                q *= beta;
+                q += m;
+                ap *= beta;
+                ap += w;
+                p *= beta;
+                p += u;
+              }
+            gamma_old = gamma;
+
+            x += alpha * p;
+            r -= alpha * ap;
+            u -= alpha * q;
+            w -= alpha * z;
+          }
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in PipelinedCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in PipelinedCGSolver::Mult\n"));
+      }
+  }
+
+
+
+  template <class IPTYPE>
+  void SStepCGSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("s-step CG solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+        // Chronopoulos, Gear: s-step iterative methods for symmetric linear systems
+        int ns = max2 (s, 1);
+        auto r = f.CreateVector();
+        // blocks of search directions P and A*P, current and previous
+        Array<AutoVector> pv(2*ns), apv(2*ns);
+        for (int i = 0; i < 2*ns; i++)
+          {
+            pv[i].AssignPointer (f.CreateVector());
+            apv[i].AssignPointer (f.CreateVector());
+          }
+
+        Matrix<SCAL> wmat(ns), wprevinv(ns), cmat(ns), bmat(ns);
+        Vector<SCAL> g(ns), alpha(ns);
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+        InnerProductsReduction<IPTYPE> reduction;
+        Array<const BaseVector*> va, vb;
+        double err = 0, lwstart = 0, lerr = 0;
+        int n = 0;
+        bool first = true;
+        for (int cur = 0; ; cur = 1-cur)
+          {
+            auto P = [&] (int i) -> BaseVector & { return *pv[cur*ns+i]; };
+            auto AP = [&] (int i) -> BaseVector & { return *apv[cur*ns+i]; };
+            auto Pold = [&] (int i) -> BaseVector & { return *pv[(1-cur)*ns+i]; };
+            auto APold = [&] (int i) -> BaseVector & { return *apv[(1-cur)*ns+i]; };
+
+            // monomial basis of the preconditioned operator
+            if (c)
+              P(0) = (*c) * r;
+            else
+              P(0) = r;
+            for (int i = 0; i < ns; i++)
+              {
+                AP(i) = (*a) * P(i);
+                if (i+1 < ns)
+                  {
+                    if (c)
+                      P(i+1) = (*c) * AP(i);
+                    else
+                      P(i+1) = AP(i);
+                  }
+              }
+
+            // all inner products of the block in one reduction:
+            // G = P^T A P,  C = (A Pold)^T P,  g = P^T r
+            va.SetSize0();
+            vb.SetSize0();
+            for (int i = 0; i < ns; i++)
+              for (int j = 0; j < ns; j++)
+                {
+                  va.Append (&P(i));
+                  vb.Append (&AP(j));
+                }
+            if (!first)
+              for (int i = 0; i < ns; i++)
+                for (int j = 0; j < ns; j++)
+                  {
+                    va.Append (&APold(i));
+                    vb.Append (&P(j));
+                  }
+            for (int i = 0; i < ns; i++)
+              {
+                va.Append (&P(i));
+                vb.Append (&r);
+              }
+            reduction.Start (va, vb);
+            auto ips = reduction.Wait();
+            size_t goff = first ? ns*ns : 2*ns*ns;
+
+            // (M r, r) as in CGSolver
+            SCAL gamma = ips[goff];
+            if (first)
+              {
+                if (printrates) cout << IM(1) << "0 " << sqrt(Abs(gamma)) << endl;
+                double start = (gamma == 0.0) ? 1.0 : Abs(gamma);
+                err = stop_absolute ? prec * prec : prec * prec * start;
+                lwstart = log(start);
+                lerr = log(err);
+              }
+            else
+              {
+                if (printrates) cout << IM(1) << n << " " << sqrt (Abs (gamma)) << endl;
+                if (sh)
+                  sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
+                                                    (lwstart-log(Abs(gamma)))/(lwstart-lerr)));
+              }
+            if (Abs(gamma) <= err || n >= maxsteps || (sh && sh->ShouldTerminate())) break;
+
+            for (int i = 0; i < ns; i++)
+              for (int j = 0; j < ns; j++)
+                wmat(i,j) = ips[i*ns+j];
+            for (int i = 0; i < ns; i++)
+              g(i) = ips[goff+i];
+
+            if (!first)
+              {
+                // A-orthogonalize against the previous block, P -= Pold B
+                for (int i = 0; i < ns; i++)
+                  for (int j = 0; j < ns; j++)
+                    cmat(i,j) = ips[ns*ns+i*ns+j];
+                bmat = wprevinv * cmat;
+                wmat -= Trans(cmat) * bmat;
+                for (int j = 0; j < ns; j++)
+                  for (int l = 0; l < ns; l++)
+                    {
+                      P(j) -= bmat(l,j) * Pold(l);
+                      AP(j) -= bmat(l,j) * APold(l);
+                    }
+              }
+
+            CalcInverse (wmat);
+            alpha = wmat * g;
+            wprevinv = wmat;
+
+            for (int j = 0; j < ns; j++)
+              {
+                x += alpha(j) * P(j);
+                r -= alpha(j) * AP(j);
+              }
+            n += ns;
+            first = false;
+          }
+
+	const_cast<int&> (steps) = n;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in SStepCGSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in SStepCGSolver::Mult\n"));
+      }
+  }
+
+
+
+  template <class IPTYPE>
+  void SStepGMRESSolver<IPTYPE> :: Mult (const BaseVector & f, BaseVector & x) const
+  {
+    static Timer timer ("s-step GMRES solver");
+    RegionTimer reg (timer);
+
+    try
+      {
+        int ns = max2 (s, 1);
+        int m = maxsteps;
+
+	auto r = f.CreateVector();
+	auto hv = f.CreateVector();
+
+        // orthonormal basis, the block of a step is built in place behind the last vector
+        Array<AutoVector> vi(m+ns+1);
+        // Hessenberg matrix, and its rotated copy
+        Matrix<SCAL> h(m+ns+1, m+ns), hr(m+ns+1, m+ns);
+        Vector<SCAL> gammai(m+ns+1), ci(m+ns+1), si(m+ns+1);
+        Matrix<SCAL> r1(m+1, ns), gram(ns), r2(ns), p1(m+1, ns), p2(ns);
+        h = SCAL(0.0);
+
+	if (initialize)
+	  {
+	    x = 0.0;
+	    r = f;
+	  }
+	else
+	  {
+	    r = f - (*a) * x;
+	  }
+
+	if (c)
+          {
+            hv = (*c) * r;
+            r = hv;
+          }
+
+        double norm = sqrt (Abs (S_InnerProduct<IPTYPE> (r, r)));
+        gammai(0) = norm;
+	if (printrates) cout << IM(1) << "0 " << norm << endl;
+
+	double err = stop_absolute ? prec : prec * norm;
+        if (norm == 0.0)
+          {
+            const_cast<int&> (steps) = 0;
+            return;
+          }
+
+        vi[0].AssignPointer (f.CreateVector());
+        *vi[0] = (1.0/norm) * r;
+        int nalloc = 1;
+
+        // y = M A x
+        auto apply = [&] (const BaseVector & vx, BaseVector & vy)
+          {
+            if (c)
+              {
+                hv = (*a) * vx;
+                vy = (*c) * hv;
+              }
+            else
+              vy = (*a) * vx;
+          };
+
+        InnerProductsReduction<IPTYPE> reduction;
+        Array<const BaseVector*> va, vb;
+        double sigma = 1.0;      // scaling of the monomial basis, estimates |M A|
+        int k = 0;               // last basis vector
+        int j = 0;               // columns of the Hessenberg matrix
+        while (j < m && norm > err && !(sh && sh->ShouldTerminate()))
+          {
+            int bs = min2 (ns, m-j);
+            for ( ; nalloc <= k+bs; nalloc++)
+              vi[nalloc].AssignPointer (f.CreateVector());
+            auto W = [&] (int i) -> BaseVector & { return *vi[k+1+i]; };
+
+            // scaled monomial basis, w_0 = M A v_k / sigma, w_i = M A w_{i-1} / sigma
+            for (int i = 0; i < bs; i++)
+              {
+                apply ((i == 0) ? *vi[k] : W(i-1), W(i));
+                W(i) *= 1.0/sigma;
+              }
+
+            // block classical Gram-Schmidt with Cholesky QR, twice for
+            // orthogonality; each pass needs one reduction
+            int rank = bs;
+            for (int pass = 0; pass < 2; pass++)
+              {
+                va.SetSize0();
+                vb.SetSize0();
+                for (int l = 0; l <= k; l++)
+                  for (int i = 0; i < bs; i++)
+                    {
+                      va.Append (&*vi[l]);
+                      vb.Append (&W(i));
+                    }
+                for (int t = 0; t < bs; t++)
+                  for (int i = 0; i < bs; i++)
+                    {
+                      va.Append (&W(t));
+                      vb.Append (&W(i));
+                    }
+                reduction.Start (va, vb);
+                auto ips = reduction.Wait();
+                for (int l = 0; l <= k; l++)
+                  for (int i = 0; i < bs; i++)
+                    p1(l,i) = ips[l*bs+i];
+                for (int t = 0; t < bs; t++)
+                  for (int i = 0; i < bs; i++)
+                    gram(t,i) = ips[(k+1)*bs+t*bs+i];
+
+                // Cholesky of W^T W - P1^T P1, the block is cut where it becomes dependent
+                p2 = SCAL(0.0);
+                for (int i = 0; i < bs && rank == bs; i++)
+                  for (int t = 0; t <= i; t++)
+                    {
+                      SCAL sum = gram(t,i);
+                      for (int l = 0; l <= k; l++)
+                        sum -= p1(l,t) * p1(l,i);
+                      for (int q = 0; q < t; q++)
+                        sum -= p2(q,t) * p2(q,i);
+                      if (t < i)
+                        p2(t,i) = sum / p2(t,t);
+                      else if (Real(sum) > 1e-12 * Abs(gram(i,i)))
+                        p2(i,i) = sqrt(sum);
+                      else
+                        rank = i;
+                    }
+                if (rank == 0) break;
+                bs = rank;
+
+                // W = (W - V P1) P2^{-1}
+                for (int i = 0; i < bs; i++)
+                  {
+                    for (int l = 0; l <= k; l++)
+                      W(i) -= p1(l,i) * *vi[l];
+                    for (int t = 0; t < i; t++)
+                      W(i) -= p2(t,i) * W(t);
+                    W(i) *= SCAL(1.0) / p2(i,i);
+                  }
+
+                // accumulate W_orig = V R1 + Q R2
+                if (pass == 0)
+                  {
+                    r1 = p1;
+                    r2 = p2;
+                  }
+                else
+                  {
+                    for (int i = 0; i < bs; i++)
+                      {
+                        for (int l = 0; l <= k; l++)
+                          {
+                            SCAL sum = r1(l,i);
+                            for (int t = 0; t <= i; t++)
+                              sum += p1(l,t) * r2(t,i);
+                            r1(l,i) = sum;
+                          }
+                        for (int t = 0; t <= i; t++)
+                          {
+                            SCAL sum = 0.0;
+                            for (int q = t; q <= i; q++)
+                              sum += p2(t,q) * r2(q,i);
+                            r2(t,i) = sum;
+                          }
+                      }
+                  }
+              }
+            if (rank == 0) break;
+
+            // Hessenberg columns from M A v_k = sigma w_0 and M A w_i = sigma w_{i+1}
+            for (int l = 0; l <= k; l++)
+              h(l,k) = sigma * r1(l,0);
+            for (int t = 0; t < bs; t++)
+              h(k+1+t,k) = sigma * r2(t,0);
+            for (int i = 0; i+1 < bs; i++)
+              {
+                int col = k+1+i;
+                for (int l = 0; l <= k; l++)
+                  h(l,col) = sigma * r1(l,i+1);
+                for (int t = 0; t < bs; t++)
+                  h(k+1+t,col) = sigma * r2(t,i+1);
+                for (int l = 0; l <= k; l++)
+                  for (int row = 0; row <= l+1; row++)
+                    h(row,col) -= r1(l,i) * h(row,l);
+                for (int t = 0; t < i; t++)
+                  for (int row = 0; row <= k+2+t; row++)
+                    h(row,col) -= r2(t,i) * h(row,k+1+t);
+                for (int row = 0; row <= col+1; row++)
+                  h(row,col) /= r2(i,i);
+              }
+
+            double hnorm = 0;
+            for (int row = 0; row <= k+1; row++)
+              hnorm += sqr (Abs (h(row,k)));
+            sigma = sqrt (hnorm);
+
+            // Givens rotations as in GMRESSolver
+            for (int col = k; col < k+bs && norm > err; col++, j++)
+              {
+                for (int row = 0; row <= col+1; row++)
+                  hr(row,col) = h(row,col);
+                for (int i = 0; i < col; i++)
+                  {
+                    SCAL hi = hr(i,col), hip = hr(i+1,col);
+                    hr(i,col)   = ci(i+1) * hi + si(i+1) * hip;
+                    hr(i+1,col) = si(i+1) * hi - ci(i+1) * hip;
+                  }
+                SCAL beta = sqrt ( sqr(hr(col,col)) + sqr(hr(col+1,col)));
+                si(col+1) = hr(col+1,col) / beta;
+                ci(col+1) = hr(col,col) / beta;
+                hr(col,col) = beta;
+                gammai(col+1) = si(col+1) * gammai(col);
+                gammai(col) = ci(col+1) * gammai(col);
+                norm = Abs (gammai(col+1));
+
+                if (printrates) cout << IM(1) << col+1 << " " << norm << endl;
+              }
+            k += bs;
+          }
+
+        Vector<SCAL> y(j);
+        for (int i = j-1; i >= 0; i--)
+          {
+            SCAL sum = gammai(i);
+            for (int l = i+1; l < j; l++)
+              sum -= hr(i,l) * y(l);
+            y(i) = sum / hr(i,i);
+          }
+
+        for (int i = 0; i < j; i++)
+          x += y(i) * *vi[i];
+
+	const_cast<int&> (steps) = j;
+      }
+
+    catch (Exception & e)
+      {
+	e.Append ("in caught in SStepGMRESSolver::Mult\n");
+	throw;
+      }
+    catch (exception & e)
+      {
+	throw Exception(e.what() +
+			string ("\ncaught in SStepGMRESSolver::Mult\n"));
+      }
+  }
+
+
+
+
+
+
 //*****************************************************************
 // Iterative template routine -- QMR
 //
@@ -1337,6 +1904,12 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
   template class QMRSolver<Complex>;
   template class QMRSolver<ComplexConjugate>;
   template class QMRSolver<ComplexConjugate2>;
+  template class PipelinedCGSolver<double>;
+  template class PipelinedCGSolver<Complex>;
+  template class SStepCGSolver<double>;
+  template class SStepCGSolver<Complex>;
+  template class SStepGMRESSolver<double>;
+  template class SStepGMRESSolver<Complex>;
   template class GMRESSolver<double>;
   template class GMRESSolver<Complex>;
   template class GMRESSolver<ComplexConjugate>;
@@ -89,6 +89,8 @@ namespace ngla
     { return steps; }
     ///
     NGS_DLL_HEADER virtual void Mult (const BaseVector & v, BaseVector & prod) const = 0;
+    /// solves for all right hand sides, GetSteps returns the maximum
+    NGS_DLL_HEADER virtual void Mult (const MultiVector & v, MultiVector & prod) const;
     ///
     NGS_DLL_HEADER virtual AutoVector CreateVector() const;
 
@@ -201,6 +203,85 @@ namespace ngla
 
 
 
+  /**
+     Pipelined preconditioned CG (Ghysels, Vanroose).  Both inner
+     products of an iteration go into one global reduction, which
+     overlaps the preconditioner and the matrix-vector product.  Needs
+     six vectors more than CG.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER PipelinedCGSolver : public KrylovSpaceSolver
+  {
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    PipelinedCGSolver () 
+      : KrylovSpaceSolver () { ; }
+    ///
+    PipelinedCGSolver (const BaseMatrix & aa)
+      : KrylovSpaceSolver (aa) { ; }
+    ///
+    PipelinedCGSolver (const BaseMatrix & aa, const BaseMatrix & ac)
+      : KrylovSpaceSolver (aa, ac) { ; }
+
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     s-step CG: s search directions per outer step, spanned by the
+     monomial basis of the preconditioned operator and made A-orthogonal
+     to the previous block.  One global reduction per s steps.  Small s
+     (2 to 5) keep the basis well conditioned.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER SStepCGSolver : public KrylovSpaceSolver
+  {
+    int s;
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    SStepCGSolver (const BaseMatrix & aa, int as = 4)
+      : KrylovSpaceSolver (aa), s(as) { ; }
+    ///
+    SStepCGSolver (const BaseMatrix & aa, const BaseMatrix & ac, int as = 4)
+      : KrylovSpaceSolver (aa, ac), s(as) { ; }
+
+    void SetS (int as) { s = as; }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+
+
+  /**
+     s-step GMRES: the Krylov basis grows by blocks of s scaled monomial
+     vectors, orthogonalized by two passes of block Gram-Schmidt with
+     Cholesky QR, that is two global reductions per block.  Minimizes
+     the preconditioned residual as GMRESSolver does.
+  */
+  template <class IPTYPE>
+  class NGS_DLL_HEADER SStepGMRESSolver : public KrylovSpaceSolver
+  {
+    int s;
+  public:
+    typedef typename SCAL_TRAIT<IPTYPE>::SCAL SCAL;
+    ///
+    SStepGMRESSolver (const BaseMatrix & aa, int as = 4)
+      : KrylovSpaceSolver (aa), s(as) { ; }
+    ///
+    SStepGMRESSolver (const BaseMatrix & aa, const BaseMatrix & ac, int as = 4)
+      : KrylovSpaceSolver (aa, ac), s(as) { ; }
+
+    void SetS (int as) { s = as; }
+    ///
+    virtual void Mult (const BaseVector & v, BaseVector & prod) const;
+  };
+  
+
+
+
+
   /// The quasi-minimal residual (QMR) solver
   template <class IPTYPE>
   class NGS_DLL_HEADER QMRSolver : public KrylovSpaceSolver
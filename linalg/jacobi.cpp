@@ -284,6 +284,244 @@ namespace ngla
 
 
 
+  JacobiPrecondFloat ::
+  JacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                      shared_ptr<BitArray> ainner, bool use_par)
+    : mat(amat), inner(ainner)
+  { 
+    static Timer t("JacobiPrecondFloat::ctor"); RegionTimer r(t);
+    SetParallelDofs (mat.GetParallelDofs());
+
+    height = mat.Height();
+
+    // diagonal is summed up and inverted in double, only stored in float
+    Array<double> diag(height);
+    ParallelFor (height, [&](size_t i)
+		 {
+                   diag[i] = (!inner || inner->Test(i)) ? mat(i,i) : 0.0;
+		 });
+    
+    if (paralleldofs!=nullptr && use_par)
+      AllReduceDofData (diag, MPI_SUM, paralleldofs);  
+
+    invdiag.SetSize (height); 
+    ParallelFor (height, [&](size_t i)
+		 {
+                   invdiag[i] = (!inner || inner->Test(i)) ? 1.0/diag[i] : 0.0;
+		 });
+  }
+
+  void JacobiPrecondFloat ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer t("JacobiPrecondFloat::MultAdd");
+    RegionTimer reg(t);
+
+    x.Cumulate();
+    y.Cumulate();
+
+    FlatVector<double> fx = x.FV<double> ();
+    FlatVector<double> fy = y.FV<double> ();
+
+    ParallelForRange (height, [&](IntRange r)
+                      {
+                        for (size_t i : r)
+                          fy(i) += s * (double(invdiag[i]) * fx(i));
+                      });
+  }
+
+  AutoVector JacobiPrecondFloat :: CreateVector () const 
+  {
+    return mat.CreateVector();
+  }
+
+  void JacobiPrecondFloat ::
+  GSSmooth (BaseVector & x, const BaseVector & b) const 
+  {
+    static Timer timer("JacobiPrecondFloat::GSSmooth");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+
+    FlatVector<double> fx = x.FV<double> ();
+    FlatVector<double> fb = b.FV<double> ();
+
+    if (mat.IsSymmetric())
+      {
+        // y = b - (D+L^t) x
+        Vector<double> y(height);
+        y = fb;
+        for (int i = 0; i < height; i++)
+          mat.AddRowTransToVector (i, -fx(i), y);
+        SmoothSymmetric (fx, y, true);
+        return;
+      }
+
+    for (int i = 0; i < height; i++)
+      if (!inner || inner->Test(i))
+	{
+	  double ax = mat.RowTimesVector (i, fx);
+	  fx(i) += double(invdiag[i]) * (fb(i) - ax);
+	}
+  }
+
+  void JacobiPrecondFloat ::
+  GSSmooth (BaseVector & x, const BaseVector & b, BaseVector & y) const 
+  {
+    if (!mat.IsSymmetric())
+      {
+        GSSmooth (x, b);
+        return;
+      }
+
+    static Timer timer("JacobiPrecondFloat::GSSmooth-help");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+    SmoothSymmetric (x.FV<double>(), y.FV<double>(), true);
+  }
+
+  void JacobiPrecondFloat ::
+  GSSmoothBack (BaseVector & x, const BaseVector & b) const 
+  {
+    static Timer timer("JacobiPrecondFloat::GSSmoothBack");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+
+    FlatVector<double> fx = x.FV<double> ();
+    FlatVector<double> fb = b.FV<double> ();
+
+    if (mat.IsSymmetric())
+      {
+        Vector<double> y(height);
+        y = fb;
+        for (int i = 0; i < height; i++)
+          mat.AddRowTransToVector (i, -fx(i), y);
+        SmoothSymmetric (fx, y, false);
+        return;
+      }
+
+    for (int i = height-1; i >= 0; i--)
+      if (!inner || inner->Test(i))
+	{
+	  double ax = mat.RowTimesVector (i, fx);
+	  fx(i) += double(invdiag[i]) * (fb(i) - ax);
+	}
+  }
+
+  void JacobiPrecondFloat ::
+  SmoothSymmetric (FlatVector<double> fx, FlatVector<double> fy, bool forward) const
+  {
+    // the stored row i holds the lower part, the upper part of row i
+    // is accumulated in y by the transposed rows:
+    // D (x_new-x) = y - L x,   y -= (D+L^t) w
+    for (int k = 0; k < height; k++)
+      {
+        int i = forward ? k : height-1-k;
+        if (inner && !inner->Test(i)) continue;
+
+        double d = fy(i) - mat.RowTimesVectorNoDiag (i, fx);
+        double w = double(invdiag[i]) * d;
+        fx(i) += w;
+        mat.AddRowTransToVector (i, -w, fy);
+      }
+  }
+
+
+
+  template <int BS>
+  BSRJacobiPrecond<BS> ::
+  BSRJacobiPrecond (const BSRMatrix<BS> & amat, shared_ptr<BitArray> ainner)
+    : mat(amat), inner(ainner)
+  { 
+    static Timer t("BSRJacobiPrecond::ctor"); RegionTimer r(t);
+
+    n = mat.VHeight() / BS;
+    invdiag.SetSize (n);
+    ParallelFor (n, [&](size_t i)
+		 {
+                   size_t pos = mat.GetPosition (i, i);
+                   const double * pb = mat.GetBlock (pos);
+                   Vec<BS,bool> free;
+                   for (int k = 0; k < BS; k++)
+                     free(k) = !inner || inner->Test(k*n+i);
+
+                   // non-inner components are decoupled by an identity row and column
+                   Mat<BS,BS> diag;
+                   for (int k = 0; k < BS; k++)
+                     for (int l = 0; l < BS; l++)
+                       diag(k,l) = (free(k) && free(l)) ? pb[l*BS+k] : double(k==l);
+                   diag = Inv (diag);
+                   for (int k = 0; k < BS; k++)
+                     for (int l = 0; l < BS; l++)
+                       if (!free(k) || !free(l)) diag(k,l) = 0.0;
+                   invdiag[i] = diag;
+		 });
+  }
+
+  template <int BS>
+  void BSRJacobiPrecond<BS> ::
+  MultAdd (double s, const BaseVector & x, BaseVector & y) const 
+  {
+    static Timer t("BSRJacobiPrecond::MultAdd");
+    RegionTimer reg(t);
+
+    FlatVector<double> fx = x.FV<double> ();
+    FlatVector<double> fy = y.FV<double> ();
+
+    ParallelForRange (n, [&](IntRange r)
+                      {
+                        for (size_t i : r)
+                          {
+                            Vec<BS> xi;
+                            for (int k = 0; k < BS; k++)
+                              xi(k) = fx(k*n+i);
+                            Vec<BS> yi = invdiag[i] * xi;
+                            for (int k = 0; k < BS; k++)
+                              fy(k*n+i) += s * yi(k);
+                          }
+                      });
+  }
+
+  template <int BS>
+  AutoVector BSRJacobiPrecond<BS> :: CreateVector () const 
+  {
+    return mat.CreateVector();
+  }
+
+  template <int BS>
+  void BSRJacobiPrecond<BS> ::
+  GSSmooth (BaseVector & x, const BaseVector & b) const 
+  {
+    static Timer timer("BSRJacobiPrecond::GSSmooth");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+
+    FlatVector<double> fx = x.FV<double> ();
+    FlatVector<double> fb = b.FV<double> ();
+
+    for (int i = 0; i < n; i++)
+      SmoothBlock (i, fx, fb);
+  }
+
+  template <int BS>
+  void BSRJacobiPrecond<BS> ::
+  GSSmoothBack (BaseVector & x, const BaseVector & b) const 
+  {
+    static Timer timer("BSRJacobiPrecond::GSSmoothBack");
+    RegionTimer reg (timer);
+    timer.AddFlops (mat.NZE());
+
+    FlatVector<double> fx = x.FV<double> ();
+    FlatVector<double> fb = b.FV<double> ();
+
+    for (int i = n-1; i >= 0; i--)
+      SmoothBlock (i, fx, fb);
+  }
+
+  template class BSRJacobiPrecond<2>;
+  template class BSRJacobiPrecond<3>;
+
+
+
   template class JacobiPrecond<double>;
   template class JacobiPrecond<Complex>;
   template class JacobiPrecond<double, Complex, Complex>;
@@ -110,6 +110,101 @@ namespace ngla
 				    int forward = 1) const;
   };
 
+
+
+  /// Jacobi preconditioner with single precision diagonal, for SparseMatrixFloat
+  class NGS_DLL_HEADER JacobiPrecondFloat : virtual public BaseJacobiPrecond,
+                                           virtual public S_BaseMatrix<double>
+  {
+  protected:
+    const SparseMatrixFloat & mat;
+    ///
+    shared_ptr<BitArray> inner;
+    ///
+    int height;
+    ///
+    Array<float> invdiag;
+  public:
+    ///
+    JacobiPrecondFloat (const SparseMatrixFloat & amat, 
+                        shared_ptr<BitArray> ainner = nullptr, bool use_par = true);
+
+    virtual int VHeight() const override { return height; }
+    virtual int VWidth() const override { return height; }
+  
+    ///
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override
+    { MultAdd (s, x, y); }
+    ///
+    virtual AutoVector CreateVector () const override;
+    ///
+    virtual void GSSmooth (BaseVector & x, const BaseVector & b) const override;
+
+    /// for symmetric matrices, y = b - (D+L^T) x is kept up to date
+    virtual void GSSmooth (BaseVector & x, const BaseVector & b, BaseVector & y) const override;
+
+    ///
+    virtual void GSSmoothBack (BaseVector & x, const BaseVector & b) const override;
+
+  private:
+    /// Gauss-Seidel sweep on the lower triangle, with partial residual y
+    void SmoothSymmetric (FlatVector<double> x, FlatVector<double> y, bool forward) const;
+  };
+
+
+  /// point-block Jacobi and Gauss-Seidel for BSRMatrix, inverting the diagonal blocks
+  template <int BS>
+  class NGS_DLL_HEADER BSRJacobiPrecond : virtual public BaseJacobiPrecond,
+                                          virtual public S_BaseMatrix<double>
+  {
+  protected:
+    const BSRMatrix<BS> & mat;
+    ///
+    shared_ptr<BitArray> inner;
+    /// number of blocks
+    int n;
+    /// inverse diagonal blocks, rows and columns of non-inner dofs are zero
+    Array<Mat<BS,BS>> invdiag;
+  public:
+    ///
+    BSRJacobiPrecond (const BSRMatrix<BS> & amat, 
+                      shared_ptr<BitArray> ainner = nullptr);
+
+    virtual int VHeight() const override { return BS*n; }
+    virtual int VWidth() const override { return BS*n; }
+  
+    ///
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override
+    { MultAdd (s, x, y); }
+    ///
+    virtual AutoVector CreateVector () const override;
+    ///
+    virtual void GSSmooth (BaseVector & x, const BaseVector & b) const override;
+
+    virtual void GSSmooth (BaseVector & x, const BaseVector & b, BaseVector & y) const override
+    {
+      GSSmooth (x, b);
+    }
+
+    ///
+    virtual void GSSmoothBack (BaseVector & x, const BaseVector & b) const override;
+
+  private:
+    void SmoothBlock (int i, FlatVector<double> fx, FlatVector<double> fb) const
+    {
+      Vec<BS> r = mat.RowTimesVector (i, fx);
+      for (int k = 0; k < BS; k++)
+        r(k) = fb(k*n+i) - r(k);
+      Vec<BS> w = invdiag[i] * r;
+      for (int k = 0; k < BS; k++)
+        fx(k*n+i) += w(k);
+    }
+  };
+
 }
 
 
@@ -0,0 +1,51 @@
+#ifndef FILE_NGS_MULTIVECTOR
+#define FILE_NGS_MULTIVECTOR
+
+/**************************************************************************/
+/* File:   multivector.hpp                                                */
+/* Date:   17. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     A set of vectors of the same layout, e.g. several right hand sides.
+
+     Matrices can apply themselves to all vectors at once, and exploit
+     that the matrix entries are loaded only once (see BaseMatrix::Mult).
+  */
+  class MultiVector
+  {
+    Array<shared_ptr<BaseVector>> vecs;
+  public:
+    /// cnt new vectors of the same type as v
+    MultiVector (shared_ptr<BaseVector> v, size_t cnt)
+    {
+      for (size_t i = 0; i < cnt; i++)
+        vecs.Append (v->CreateVector());
+    }
+
+    /// take given vectors, no copy
+    MultiVector (const Array<shared_ptr<BaseVector>> & avecs)
+      : vecs(avecs) { ; }
+
+    size_t Size() const { return vecs.Size(); }
+
+    BaseVector & operator[] (size_t i) const { return *vecs[i]; }
+
+    shared_ptr<BaseVector> Get (size_t i) const { return vecs[i]; }
+
+    void Append (shared_ptr<BaseVector> v) { vecs.Append (v); }
+
+    MultiVector & operator= (double s)
+    {
+      for (auto & v : vecs)
+        *v = s;
+      return *this;
+    }
+  };
+
+}
+
+#endif
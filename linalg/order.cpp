@@ -7,6 +7,8 @@
 
 
 #include <la.hpp>
+#include <queue>
+
 namespace ngla
 {
   using namespace ngla;
@@ -534,7 +536,7 @@ namespace ngla
     
     // t4.Start();
     // calc master degrees in new clique
-    if (anymaster)
+    if (anymaster && calc_degrees)
       {
         CliqueEl * p3 = anymaster;
         do
@@ -648,6 +650,101 @@ namespace ngla
 
 
 
+  void MinimumDegreeOrdering :: Order (FlatArray<int> sequence)
+  {
+    static Timer reorder_timer("MinimumDegreeOrdering::Order - given sequence");
+    RegionTimer reg(reorder_timer);
+
+    // every master vertex must be in the sequence, slaves follow their masters
+    Array<bool> inseq(n);
+    inseq = false;
+    for (int v : sequence)
+      {
+        if (v < 0 || v >= n)
+          throw Exception ("MinimumDegreeOrdering::Order: vertex in sequence out of range");
+        inseq[v] = true;
+      }
+    for (int i = 0; i < n; i++)
+      if (!vertices[i].Eliminated() && vertices[i].Master() == i && !inseq[i])
+        throw Exception ("MinimumDegreeOrdering::Order: sequence does not contain all vertices");
+
+    if (task_manager) task_manager -> StopWorkers();
+
+    calc_degrees = false;
+    nused = 0;
+    for (int i = 0; i < n; i++)
+      if (!vertices[i].Eliminated())
+        nused++;
+
+    int lastel = -1;
+    size_t pos = 0;
+    for (int i = 0; i < nused; i++)
+      {
+        int v;
+	if (lastel != -1 && vertices[lastel].NextSlave() != -1)
+	  {
+	    v = vertices[lastel].NextSlave();
+	    blocknr[i] = blocknr[i-1];
+	    EliminateSlaveVertex (v);
+	  }
+	else
+	  {
+            // slaves of not yet eliminated masters are skipped
+            do
+              {
+                if (pos >= sequence.Size())
+                  {
+                    if (task_manager) task_manager -> StartWorkers();
+                    throw Exception ("MinimumDegreeOrdering::Order: sequence ends after "
+                                     + ToString(i) + " of " + ToString(nused) + " vertices");
+                  }
+                v = sequence[pos++];
+              }
+            while (vertices[v].Eliminated() || vertices[v].Master() != v);
+
+	    blocknr[i] = i;
+	    EliminateMasterVertex (v);
+	  }
+
+	order[i] = v;
+	vertices[v].SetEliminated (1);
+	lastel = v;
+      }
+    if (task_manager) task_manager -> StartWorkers();
+  }
+
+
+  void MinimumDegreeOrdering :: OrderNestedDissection ()
+  {
+    cout << IM(4) << "start nested dissection" << endl;
+
+    // graph of the used vertices, every clique is still a single edge
+    Array<int> used, index(n);
+    index = -1;
+    for (int i = 0; i < n; i++)
+      if (!vertices[i].Eliminated())
+        {
+          index[i] = used.Size();
+          used.Append (i);
+        }
+
+    TableCreator<int> creator(used.Size());
+    for ( ; !creator.Done(); creator++)
+      for (size_t i = 0; i < used.Size(); i++)
+        for (CliqueEl * p1 = cliques[used[i]]; p1; p1 = p1->nextcl)
+          for (CliqueEl * p2 = p1->next; p2 != p1; p2 = p2->next)
+            if (index[p2->Nr()] != -1)
+              creator.Add (i, index[p2->Nr()]);
+    Table<int> graph = creator.MoveTable();
+
+    Array<int> sequence = NestedDissectionOrdering (graph);
+    for (auto & v : sequence)
+      v = used[v];
+    Order (sequence);
+  }
+
+
+
   MinimumDegreeOrdering:: ~MinimumDegreeOrdering ()
   {
     // cout << "~MDO: all data should be deleted, please double-check" << endl;
@@ -796,4 +893,426 @@ namespace ngla
     list[nr].degree = 0;
   }
 
+  /* 
+
+  Nested dissection ordering
+  Algorithm: recursive multilevel graph bisection
+
+  The graph is coarsened by heavy edge matching, bisected by graph
+  growing at the coarsest level, and refined by Fiduccia-Mattheyses passes
+  on the way back. The smaller side of the edge cut becomes the vertex
+  separator, which is ordered after both halves. The halves are
+  dissected independently, in parallel.
+
+  See:       A fast and high quality multilevel scheme for
+  partitioning irregular graphs
+
+  G. Karypis and V. Kumar
+  SIAM J. Sci. Comput., Vol20, 1998, pp359-392
+
+  */
+
+  class NDGraph
+  {
+  public:
+    Array<int> firstedge;
+    Array<int> adj;
+    Array<int> ewgt;
+    Array<int> vwgt;
+
+    size_t Size() const { return vwgt.Size(); }
+    IntRange Edges (int v) const { return IntRange(firstedge[v], firstedge[v+1]); }
+  };
+
+
+  // heavy edge matching, cmap is fine -> coarse vertex
+  static NDGraph Coarsen (const NDGraph & g, Array<int> & cmap)
+  {
+    size_t n = g.Size();
+    Array<int> match(n);
+    match = -1;
+    cmap.SetSize(n);
+
+    // visit in pseudo-random order, natural order gives stripes on structured meshes
+    Array<int> perm(n);
+    for (size_t i = 0; i < n; i++)
+      perm[i] = i;
+    unsigned int seed = 4711;
+    for (size_t i = n; i > 1; i--)
+      {
+        seed = 1103515245 * seed + 12345;
+        Swap (perm[i-1], perm[(seed >> 8) % i]);
+      }
+
+    int nc = 0;
+    for (int v : perm)
+      {
+        if (match[v] != -1) continue;
+        int best = v, bestw = 0;
+        for (auto k : g.Edges(v))
+          {
+            int u = g.adj[k];
+            if (match[u] == -1 && u != v && g.ewgt[k] > bestw)
+              {
+                best = u;
+                bestw = g.ewgt[k];
+              }
+          }
+        match[v] = best;
+        match[best] = v;
+      }
+
+    // coarse vertices are numbered in the order of their first fine vertex
+    for (size_t v = 0; v < n; v++)
+      if (match[v] >= int(v))
+        cmap[v] = cmap[match[v]] = nc++;
+
+    NDGraph gc;
+    gc.vwgt.SetSize (nc);
+    gc.firstedge.SetSize (nc+1);
+    Array<int> marker(nc);
+    marker = -1;
+
+    for (size_t v = 0; v < n; v++)
+      {
+        if (match[v] < int(v)) continue;
+        int c = cmap[v];
+        int start = gc.adj.Size();
+        gc.firstedge[c] = start;
+        gc.vwgt[c] = g.vwgt[v];
+        if (match[v] != int(v))
+          gc.vwgt[c] += g.vwgt[match[v]];
+
+        for (int w : { int(v), match[v] })
+          {
+            for (auto k : g.Edges(w))
+              {
+                int cu = cmap[g.adj[k]];
+                if (cu == c) continue;
+                if (marker[cu] < start)
+                  {
+                    marker[cu] = gc.adj.Size();
+                    gc.adj.Append (cu);
+                    gc.ewgt.Append (g.ewgt[k]);
+                  }
+                else
+                  gc.ewgt[marker[cu]] += g.ewgt[k];
+              }
+            if (match[v] == int(v)) break;
+          }
+      }
+    gc.firstedge[nc] = gc.adj.Size();
+    return gc;
+  }
+
+
+  // Fiduccia-Mattheyses passes: move boundary vertices by largest gain,
+  // allowing temporary increase of the cut, and roll back to the best state
+  static void Refine (const NDGraph & g, FlatArray<int> part)
+  {
+    size_t n = g.Size();
+    int w[2] = { 0, 0 };
+    for (size_t v = 0; v < n; v++)
+      w[part[v]] += g.vwgt[v];
+    int maxw = int(0.52 * (w[0]+w[1])) + 1;
+
+    Array<int> gain(n);
+    Array<bool> locked(n);
+    Array<int> moves;
+
+    for (int pass = 0; pass < 6; pass++)
+      {
+        priority_queue<pair<int,int>> queue;
+        int cut = 0;
+        for (size_t v = 0; v < n; v++)
+          {
+            int ext = 0, in = 0;
+            for (auto k : g.Edges(v))
+              {
+                if (part[g.adj[k]] == part[v])
+                  in += g.ewgt[k];
+                else
+                  ext += g.ewgt[k];
+              }
+            gain[v] = ext - in;
+            cut += ext;
+            locked[v] = false;
+            if (ext > 0) queue.push (make_pair (gain[v], int(v)));
+          }
+        cut /= 2;
+
+        // feasible states first, then small cut, then balance
+        auto better = [] (int cut1, int imb1, bool feas1, int cut2, int imb2, bool feas2)
+          {
+            if (feas1 != feas2) return feas1;
+            if (cut1 != cut2) return cut1 < cut2;
+            return imb1 < imb2;
+          };
+        int bestcut = cut, bestimb = abs(w[0]-w[1]);
+        bool bestfeas = max2(w[0],w[1]) <= maxw;
+        size_t bestpos = 0;
+        moves.SetSize (0);
+
+        while (!queue.empty() && moves.Size() < bestpos + 100)
+          {
+            auto top = queue.top();
+            queue.pop();
+            int v = top.second;
+            if (locked[v] || top.first != gain[v]) continue;
+            int p = part[v];
+            if (w[1-p]+g.vwgt[v] > maxw && w[p] <= maxw) continue;
+
+            part[v] = 1-p;
+            w[p] -= g.vwgt[v];
+            w[1-p] += g.vwgt[v];
+            cut -= gain[v];
+            locked[v] = true;
+            moves.Append (v);
+
+            for (auto k : g.Edges(v))
+              {
+                int u = g.adj[k];
+                if (locked[u]) continue;
+                gain[u] += (part[u] == p) ? 2*g.ewgt[k] : -2*g.ewgt[k];
+                queue.push (make_pair (gain[u], u));
+              }
+
+            bool feas = max2(w[0],w[1]) <= maxw;
+            if (better (cut, abs(w[0]-w[1]), feas, bestcut, bestimb, bestfeas))
+              {
+                bestcut = cut;
+                bestimb = abs(w[0]-w[1]);
+                bestfeas = feas;
+                bestpos = moves.Size();
+              }
+          }
+
+        for (size_t k = moves.Size(); k-- > bestpos; )
+          {
+            int v = moves[k];
+            int p = part[v];
+            part[v] = 1-p;
+            w[p] -= g.vwgt[v];
+            w[1-p] += g.vwgt[v];
+          }
+        if (bestpos == 0) break;
+      }
+  }
+
+
+  // graph growing from a few start vertices, keep the smallest cut
+  static void InitialBisection (const NDGraph & g, Array<int> & part)
+  {
+    size_t n = g.Size();
+    int total = 0;
+    for (size_t v = 0; v < n; v++)
+      total += g.vwgt[v];
+
+    Array<int> trial(n), queue(n);
+    int bestcut = numeric_limits<int>::max();
+    part.SetSize (n);
+
+    int start = 0;
+    for (int t = 0; t < 4; t++)
+      {
+        trial = 1;
+        int w0 = 0, last = start;
+        size_t qbegin = 0, qend = 0;
+        for (size_t seed = start, cnt = 0; w0 < total/2 && cnt < n; seed = (seed+1) % n, cnt++)
+          {
+            if (trial[seed] == 0) continue;
+            // new component
+            trial[seed] = 0;
+            w0 += g.vwgt[seed];
+            queue[qend++] = seed;
+            while (qbegin < qend && w0 < total/2)
+              {
+                int v = queue[qbegin++];
+                last = v;
+                for (auto k : g.Edges(v))
+                  {
+                    int u = g.adj[k];
+                    if (trial[u] == 0 || w0 >= total/2) continue;
+                    trial[u] = 0;
+                    w0 += g.vwgt[u];
+                    queue[qend++] = u;
+                  }
+              }
+          }
+
+        Refine (g, trial);
+        int cut = 0;
+        for (size_t v = 0; v < n; v++)
+          for (auto k : g.Edges(v))
+            if (trial[v] != trial[g.adj[k]])
+              cut += g.ewgt[k];
+        if (cut < bestcut)
+          {
+            bestcut = cut;
+            part = trial;
+          }
+
+        // next start vertex is far away from this one
+        start = (last != start) ? last : (start + n/4 + 1) % n;
+      }
+  }
+
+
+  static void Bisect (const NDGraph & g, Array<int> & part)
+  {
+    size_t n = g.Size();
+    if (n <= 100)
+      {
+        InitialBisection (g, part);
+        return;
+      }
+
+    Array<int> cmap;
+    NDGraph gc = Coarsen (g, cmap);
+    if (gc.Size() > 0.9 * n)
+      {
+        // coarsening stalls, e.g. star-like graphs
+        InitialBisection (g, part);
+        return;
+      }
+
+    Array<int> partc;
+    Bisect (gc, partc);
+    part.SetSize (n);
+    for (size_t v = 0; v < n; v++)
+      part[v] = partc[cmap[v]];
+    Refine (g, part);
+  }
+
+
+  // subgraph of all vertices with part[v] == p
+  static NDGraph SubGraph (const NDGraph & g, FlatArray<int> part, int p,
+                    FlatArray<int> loc, FlatArray<int> verts, Array<int> & subverts)
+  {
+    NDGraph sub;
+    subverts.SetSize (0);
+    for (size_t v = 0; v < g.Size(); v++)
+      if (part[v] == p)
+        subverts.Append (verts[v]);
+    sub.vwgt.SetSize (subverts.Size());
+    sub.vwgt = 1;
+    sub.firstedge.SetSize (0);
+    for (size_t v = 0; v < g.Size(); v++)
+      if (part[v] == p)
+        {
+          sub.firstedge.Append (sub.adj.Size());
+          for (auto k : g.Edges(v))
+            if (part[g.adj[k]] == p)
+              sub.adj.Append (loc[g.adj[k]]);
+        }
+    sub.firstedge.Append (sub.adj.Size());
+    sub.ewgt.SetSize (sub.adj.Size());
+    sub.ewgt = 1;
+    return sub;
+  }
+
+
+  // writes the elimination order of the vertices verts to order
+  static void Dissect (const NDGraph & g, FlatArray<int> verts, FlatArray<int> order, int leafsize)
+  {
+    size_t n = g.Size();
+    if (n <= size_t(leafsize))
+      {
+        order = verts;
+        return;
+      }
+
+    Array<int> part;
+    Bisect (g, part);
+
+    // boundary of the smaller side becomes the separator
+    size_t nb[2] = { 0, 0 };
+    Array<bool> boundary(n);
+    for (size_t v = 0; v < n; v++)
+      {
+        boundary[v] = false;
+        for (int u : g.adj.Range(g.Edges(v)))
+          if (part[u] != part[v])
+            boundary[v] = true;
+        if (boundary[v]) nb[part[v]]++;
+      }
+    int sside = (nb[0] <= nb[1]) ? 0 : 1;
+    for (size_t v = 0; v < n; v++)
+      if (boundary[v] && part[v] == sside)
+        part[v] = 2;
+
+    // separator vertices without neighbours on the separator side are not needed
+    for (size_t v = 0; v < n; v++)
+      if (part[v] == 2)
+        {
+          bool needed = false;
+          for (int u : g.adj.Range(g.Edges(v)))
+            if (part[u] == sside)
+              needed = true;
+          if (!needed)
+            part[v] = 1-sside;
+        }
+
+    size_t cnt[3] = { 0, 0, 0 };
+    Array<int> loc(n);
+    for (size_t v = 0; v < n; v++)
+      loc[v] = cnt[part[v]]++;
+
+    if (cnt[0] == 0 || cnt[1] == 0)
+      {
+        // no separation possible, e.g. dense graph
+        order = verts;
+        return;
+      }
+
+    // separator is eliminated last
+    auto sep = order.Range (cnt[0]+cnt[1], n);
+    for (size_t v = 0; v < n; v++)
+      if (part[v] == 2)
+        sep[loc[v]] = verts[v];
+
+    auto dissect_part = [&] (int p)
+      {
+        Array<int> subverts;
+        NDGraph sub = SubGraph (g, part, p, loc, verts, subverts);
+        auto suborder = (p == 0) ? order.Range(0, cnt[0]) : order.Range(cnt[0], cnt[0]+cnt[1]);
+        Dissect (sub, subverts, suborder, leafsize);
+      };
+
+    if (n > 5000)
+      ParallelFor (2, dissect_part);
+    else
+      for (int p = 0; p < 2; p++)
+        dissect_part (p);
+  }
+
+
+  Array<int> NestedDissectionOrdering (FlatTable<int> graph, int leafsize)
+  {
+    static Timer t("NestedDissectionOrdering"); RegionTimer reg(t);
+
+    size_t n = graph.Size();
+    NDGraph g;
+    g.vwgt.SetSize (n);
+    g.vwgt = 1;
+    g.firstedge.SetSize (n+1);
+    for (size_t v = 0; v < n; v++)
+      {
+        g.firstedge[v] = g.adj.Size();
+        for (int u : graph[v])
+          if (u != int(v))
+            g.adj.Append (u);
+      }
+    g.firstedge[n] = g.adj.Size();
+    g.ewgt.SetSize (g.adj.Size());
+    g.ewgt = 1;
+
+    Array<int> verts(n), order(n);
+    for (size_t v = 0; v < n; v++)
+      verts[v] = v;
+    Dissect (g, verts, order, leafsize);
+    return order;
+  }
+
+
 }
@@ -137,6 +137,8 @@ namespace ngla
     MDOPriorityQueue priqueue;
     ///
     ngstd::BlockAllocator ball;
+    /// keep degrees up to date (not needed for a given elimination sequence)
+    bool calc_degrees = true;
   public:
     ///
     MinimumDegreeOrdering (int an);
@@ -152,6 +154,10 @@ namespace ngla
     void EliminateSlaveVertex (int v);
     ///
     void Order();
+    /// eliminate master vertices in the given sequence, slaves follow their masters
+    void Order (FlatArray<int> sequence);
+    /// sequence from nested dissection of the current graph
+    void OrderNestedDissection ();
     /// 
     ~MinimumDegreeOrdering();
 
@@ -199,6 +205,14 @@ namespace ngla
   };
 
 
+
+  /**
+     Nested dissection ordering by multilevel graph bisection.
+     Returns the vertices in elimination order, separators last.
+     Subgraphs up to leafsize vertices are not dissected further.
+  */
+  NGS_DLL_HEADER Array<int> NestedDissectionOrdering (FlatTable<int> graph, int leafsize = 64);
+
 }
 
 
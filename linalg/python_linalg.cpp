@@ -343,6 +343,31 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
                                               return py::cast (InnerProduct (self, other));
                                           }, py::arg("other"), py::arg("conjugate")=py::cast(true), "Computes (complex) InnerProduct"         
          )
+    .def("SetLinearCombination", [](BaseVector & self, py::list coefs, py::list vecs, bool add)
+         {
+           if (py::len(coefs) != py::len(vecs))
+             throw Exception ("SetLinearCombination: need as many coefficients as vectors");
+           Array<const BaseVector*> v;
+           for (auto vi : vecs)
+             v.Append (&py::cast<BaseVector&> (vi));
+           bool real = true;
+           for (auto ci : coefs)
+             if (!py::isinstance<py::float_> (ci) && !py::isinstance<py::int_> (ci))
+               real = false;
+           if (real)
+             {
+               Array<double> c;
+               for (auto ci : coefs) c.Append (py::cast<double> (ci));
+               self.SetLinearCombination (c, v, add);
+             }
+           else
+             {
+               Array<Complex> c;
+               for (auto ci : coefs) c.Append (py::cast<Complex> (ci));
+               self.SetLinearCombination (c, v, add);
+             }
+         }, py::arg("coefs"), py::arg("vecs"), py::arg("add")=false,
+         "Sets (or adds to) self the sum of coefs[i]*vecs[i] in one sweep, self may be among vecs")
     .def("Norm",  [](BaseVector & self) { return self.L2Norm(); }, "Calculate Norm")
     .def("Range", [](BaseVector & self, int from, int to) -> shared_ptr<BaseVector>
                                    {
@@ -365,6 +390,33 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
            [] (py::object x, py::object y) -> py::object
          { return py::handle(x.attr("InnerProduct")) (y); }, py::arg("x"), py::arg("y"), "Computes InnerProduct of given objects");
   ;
+
+  m.def ("InnerProducts", [] (py::list x, py::list y, bool conjugate) -> py::list
+         {
+           if (py::len(x) != py::len(y))
+             throw Exception ("InnerProducts: need lists of the same length");
+           Array<const BaseVector*> a, b;
+           for (auto xi : x) a.Append (&py::cast<BaseVector&> (xi));
+           for (auto yi : y) b.Append (&py::cast<BaseVector&> (yi));
+           py::list res;
+           if (a.Size() && a[0]->IsComplex())
+             {
+               Vector<Complex> ips(a.Size());
+               if (conjugate)
+                 S_InnerProducts<ComplexConjugate> (a, b, ips);
+               else
+                 S_InnerProducts<Complex> (a, b, ips);
+               for (auto ip : ips) res.append (py::cast (ip));
+             }
+           else
+             {
+               Vector<double> ips(a.Size());
+               S_InnerProducts<double> (a, b, ips);
+               for (auto ip : ips) res.append (py::cast (ip));
+             }
+           return res;
+         }, py::arg("x"), py::arg("y"), py::arg("conjugate")=true,
+         "Computes the inner products of x[i] and y[i] in one sweep over the vectors");
   
 
   py::class_<BlockVector, BaseVector, shared_ptr<BlockVector>> (m, "BlockVector")
@@ -528,6 +580,26 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
   
 
 
+  py::class_<MultiVector, shared_ptr<MultiVector>> (m, "MultiVector",
+                                                   "A set of vectors of the same layout, e.g. several right hand sides")
+    .def(py::init([] (shared_ptr<BaseVector> vec, size_t cnt)
+                  { return make_shared<MultiVector> (vec, cnt); }),
+         py::arg("vector"), py::arg("count"), "count new vectors of the same type as vector")
+    .def(py::init([] (py::list vecs)
+                  {
+                    Array<shared_ptr<BaseVector>> avecs;
+                    for (auto v : vecs)
+                      avecs.Append (py::cast<shared_ptr<BaseVector>> (v));
+                    return make_shared<MultiVector> (avecs);
+                  }), py::arg("vectors"), "use the given vectors (no copy)")
+    .def("__len__", [] (MultiVector & self) { return self.Size(); })
+    .def("__getitem__", [] (MultiVector & self, size_t i)
+         {
+           if (i >= self.Size()) throw py::index_error();
+           return self.Get(i);
+         })
+    ;
+
   py::class_<BaseMatrix, shared_ptr<BaseMatrix>, BaseMatrixTrampoline>(m, "BaseMatrix")
     /*
     .def("__init__", [](BaseMatrix *instance) { 
@@ -559,6 +631,9 @@ void NGS_DLL_HEADER ExportNgla(py::module &m) {
 
     .def("Mult",         [](BaseMatrix &m, BaseVector &x, BaseVector &y) { m.Mult(x, y); }, py::call_guard<py::gil_scoped_release>(), py::arg("x"), py::arg("y"))
     .def("MultAdd",      [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { m.MultAdd (s, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
+    .def("Mult",         [](BaseMatrix &m, MultiVector &x, MultiVector &y) { m.Mult(x, y); }, py::call_guard<py::gil_scoped_release>(), py::arg("x"), py::arg("y"),
+         "y[i] = mat * x[i] for all vectors, with one sweep through the matrix where supported")
+    .def("MultAdd",      [](BaseMatrix &m, double s, MultiVector &x, MultiVector &y) { m.MultAdd (s, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
     .def("MultTrans",    [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { y=0; m.MultTransAdd (1.0, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
     .def("MultTransAdd",  [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y) { m.MultTransAdd (s, x, y); }, py::arg("value"), py::arg("x"), py::arg("y"), py::call_guard<py::gil_scoped_release>())
     .def("MultScale",    [](BaseMatrix &m, double s, BaseVector &x, BaseVector &y)
@@ -658,6 +733,38 @@ inverse : string
   py::class_<S_BaseMatrix<Complex>, shared_ptr<S_BaseMatrix<Complex>>, BaseMatrix>
     (m, "S_BaseMatrixC", "base sparse matrix");
 
+  py::class_<SELLMatrix, shared_ptr<SELLMatrix>, S_BaseMatrix<double>>
+    (m, "SELLMatrix", "SELL-C-sigma copy of a real sparse matrix for fast matrix-vector products")
+    .def(py::init<> ([] (shared_ptr<SparseMatrix<double>> mat, size_t sigma)
+                     { return make_shared<SELLMatrix> (mat, sigma); }),
+         py::arg("mat"), py::arg("sigma")=256,
+         "convert sparse matrix, rows are sorted by length within windows of sigma rows")
+    .def("UpdateValues", &SELLMatrix::UpdateValues, "copy values again from the original matrix")
+    .def_property_readonly("nstored", &SELLMatrix::NumStored, "stored entries including padding")
+    .def("__timing__", &SELLMatrix::Timing)
+    ;
+
+  py::class_<SparseMatrixFloat, shared_ptr<SparseMatrixFloat>, BaseSparseMatrix, S_BaseMatrix<double>>
+    (m, "SparseMatrixFloat", "single precision copy of a real sparse matrix, accumulating in double")
+    .def(py::init<> ([] (shared_ptr<SparseMatrix<double>> mat)
+                     { return make_shared<SparseMatrixFloat> (mat); }),
+         py::arg("mat"),
+         "convert sparse matrix, symmetric matrices are expanded to the full pattern")
+    .def("UpdateValues", &SparseMatrixFloat::UpdateValues, "copy values again from the original matrix")
+    .def("__timing__", &SparseMatrixFloat::Timing)
+    ;
+
+  py::class_<BaseBSRMatrix, shared_ptr<BaseBSRMatrix>, BaseSparseMatrix, S_BaseMatrix<double>>
+    (m, "BSRMatrix", "sparse matrix of dense blocks, acting on vectors numbered component by component")
+    .def_property_readonly("blocksize", &BaseBSRMatrix::BlockSize)
+    .def("CreateSparseMatrix", [] (BaseBSRMatrix & self) -> shared_ptr<BaseMatrix>
+         { return self.CreateSparseMatrix(); },
+         "scalar sparse matrix with the same values")
+    .def("__timing__", &BaseBSRMatrix::Timing)
+    ;
+  py::class_<BSRMatrix<2>, shared_ptr<BSRMatrix<2>>, BaseBSRMatrix> (m, "BSRMatrix2");
+  py::class_<BSRMatrix<3>, shared_ptr<BSRMatrix<3>>, BaseBSRMatrix> (m, "BSRMatrix3");
+
 
   py::class_<BlockMatrix, BaseMatrix, shared_ptr<BlockMatrix>> (m, "BlockMatrix")
     .def(py::init<> ([] (vector<vector<shared_ptr<BaseMatrix>>> mats)
@@ -751,6 +858,33 @@ inverse : string
 
   py::class_<SparseCholesky<double>, shared_ptr<SparseCholesky<double>>, SparseFactorization> (m, "SparseCholesky_d");
   py::class_<SparseCholesky<Complex>, shared_ptr<SparseCholesky<Complex>>, SparseFactorization> (m, "SparseCholesky_c");
+
+  m.def("SetSparseCholeskyOptions", [] (py::object multifrontal, py::object nested_dissection,
+                                        py::object reuse_symbolic)
+        {
+          if (!multifrontal.is_none())
+            SparseCholeskyOptions::multifrontal = py::cast<bool> (multifrontal);
+          if (!nested_dissection.is_none())
+            SparseCholeskyOptions::nested_dissection = py::cast<bool> (nested_dissection);
+          if (!reuse_symbolic.is_none())
+            SparseCholeskyOptions::reuse_symbolic = py::cast<bool> (reuse_symbolic);
+        }, py::arg("multifrontal")=py::none(), py::arg("nested_dissection")=py::none(),
+        py::arg("reuse_symbolic")=py::none(),
+        docu_string(R"raw_string(Settings for sparse Cholesky factorizations created afterwards.
+Options not given are left unchanged.
+
+Parameters:
+
+multifrontal : bool
+  Factor with dense frontal matrices, in parallel over the elimination tree (real matrices only)
+
+nested_dissection : bool
+  Order the unknowns by nested dissection (multilevel graph bisection) instead of minimum degree
+
+reuse_symbolic : bool
+  A new factorization of a matrix with the same graph and the same free dofs skips the
+  symbolic phase, as long as an earlier inverse of that graph is still alive (default True)
+)raw_string"));
   
   py::class_<Projector, shared_ptr<Projector>, BaseMatrix> (m, "Projector")
     .def(py::init<shared_ptr<BitArray>,bool>(),
@@ -771,12 +905,27 @@ inverse : string
 
   m.def("CGSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
                                           bool iscomplex, bool printrates, 
-                                          double precision, int maxsteps)
+                                          double precision, int maxsteps,
+                                          bool pipelined, int sstep)
                                        {
                                          KrylovSpaceSolver * solver;
                                          if(mat.IsComplex()) iscomplex = true;
                                          
-                                         if (iscomplex)
+                                         if (pipelined)
+                                           {
+                                             if (iscomplex)
+                                               solver = new PipelinedCGSolver<Complex> (mat, pre);
+                                             else
+                                               solver = new PipelinedCGSolver<double> (mat, pre);
+                                           }
+                                         else if (sstep > 1)
+                                           {
+                                             if (iscomplex)
+                                               solver = new SStepCGSolver<Complex> (mat, pre, sstep);
+                                             else
+                                               solver = new SStepCGSolver<double> (mat, pre, sstep);
+                                           }
+                                         else if (iscomplex)
                                            solver = new CGSolver<Complex> (mat, pre);
                                          else
                                            solver = new CGSolver<double> (mat, pre);
@@ -786,7 +935,8 @@ inverse : string
                                          return shared_ptr<KrylovSpaceSolver>(solver);
                                        },
            py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("printrates")=true,
-        py::arg("precision")=1e-8, py::arg("maxsteps")=200, docu_string(R"raw_string(
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200,
+        py::arg("pipelined")=false, py::arg("sstep")=1, docu_string(R"raw_string(
 A CG Solver.
 
 Parameters:
@@ -809,15 +959,30 @@ precision : float
 maxsteps : int
   input maximal steps. CGSolver stops after this steps.
 
+pipelined : bool
+  input pipelined, overlap the global reduction of the inner products
+  with preconditioner and matrix-vector product
+
+sstep : int
+  input sstep, if larger than 1 use s-step CG with one global reduction
+  per sstep iterations
+
 )raw_string"))
     ;
 
   m.def("GMRESSolver", [](const BaseMatrix & mat, const BaseMatrix & pre,
                                            bool printrates, 
-                                           double precision, int maxsteps)
+                                           double precision, int maxsteps, int sstep)
                                         {
                                           KrylovSpaceSolver * solver;
-                                          if (!mat.IsComplex())
+                                          if (sstep > 1)
+                                            {
+                                              if (!mat.IsComplex())
+                                                solver = new SStepGMRESSolver<double> (mat, pre, sstep);
+                                              else
+                                                solver = new SStepGMRESSolver<Complex> (mat, pre, sstep);
+                                            }
+                                          else if (!mat.IsComplex())
                                             solver = new GMRESSolver<double> (mat, pre);
                                           else
                                             solver = new GMRESSolver<Complex> (mat, pre);                                            
@@ -827,7 +992,8 @@ maxsteps : int
                                           return shared_ptr<KrylovSpaceSolver>(solver);
                                         },
            py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
-           py::arg("precision")=1e-8, py::arg("maxsteps")=200, docu_string(R"raw_string(
+           py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("sstep")=1,
+           docu_string(R"raw_string(
 A General Minimal Residuum (GMRES) Solver.
 
 Parameters:
@@ -847,6 +1013,10 @@ precision : float
 maxsteps : int
   input maximal steps. GMRESSolver stops after this steps.
 
+sstep : int
+  input sstep, if larger than 1 the Krylov basis grows by blocks of
+  sstep vectors with two global reductions per block
+
 )raw_string"))
     ;
 
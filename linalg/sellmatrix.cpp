@@ -0,0 +1,196 @@
+/*********************************************************************/
+/* File:   sellmatrix.cpp                                            */
+/* Date:   17. Oct. 2026                                             */
+/*********************************************************************/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  SELLMatrix :: SELLMatrix (shared_ptr<SparseMatrixTM<double>> amat, size_t asigma)
+    : mat(amat), height(amat->Height()), width(amat->Width())
+  {
+    static Timer t("SELLMatrix - convert");
+    RegionTimer reg(t);
+
+    // sort windows must not split chunks
+    sigma = max2 (size_t(1), (asigma+C-1) / C) * C;
+
+    // symmetric storage has only the lower triangle, take the upper from there
+    bool symmetric = dynamic_pointer_cast<SparseMatrixSymmetric<double>> (mat) != nullptr;
+
+    TableCreator<size_t> creator(height);
+    TableCreator<int> creator_cols(height);
+    for ( ; !creator.Done(); creator++, creator_cols++)
+      for (size_t i = 0; i < height; i++)
+        {
+          auto cols = mat->GetRowIndices(i);
+          size_t first = mat->First(i);
+          for (size_t j = 0; j < cols.Size(); j++)
+            {
+              creator.Add (i, first+j);
+              creator_cols.Add (i, cols[j]);
+              if (symmetric && cols[j] != int(i))
+                {
+                  creator.Add (cols[j], first+j);
+                  creator_cols.Add (cols[j], i);
+                }
+            }
+        }
+    Table<size_t> rowpos = creator.MoveTable();
+    Table<int> rowcols = creator_cols.MoveTable();
+
+
+    // sort rows by length within the sigma-windows
+    size_t nchunks = (height+C-1) / C;
+    perm.SetSize (nchunks*C);
+    perm = -1;
+    for (size_t i = 0; i < height; i++)
+      perm[i] = i;
+
+    ParallelFor (Range((height+sigma-1)/sigma), [&] (size_t w)
+                 {
+                   auto win = perm.Range(w*sigma, min2(height, (w+1)*sigma));
+                   QuickSort (win, [&] (int a, int b)
+                              {
+                                if (rowpos[a].Size() != rowpos[b].Size())
+                                  return rowpos[a].Size() > rowpos[b].Size();
+                                return a < b;
+                              });
+                 });
+
+    firstinchunk.SetSize (nchunks+1);
+    firstinchunk[0] = 0;
+    for (size_t k = 0; k < nchunks; k++)
+      {
+        // first row of chunk is the longest one
+        size_t chunkwidth = rowpos[perm[k*C]].Size();
+        firstinchunk[k+1] = firstinchunk[k] + C * chunkwidth;
+      }
+
+    size_t nstored = firstinchunk[nchunks];
+    colnr.SetSize (nstored);
+    values.SetSize (nstored);
+    origpos.SetSize (nstored);
+
+    // the last chunk may contain non-existing rows
+    ParallelFor (Range(nchunks), [&] (size_t k)
+                 {
+                   size_t first = firstinchunk[k];
+                   size_t chunkwidth = (firstinchunk[k+1]-first) / C;
+                   for (int r = 0; r < C; r++)
+                     {
+                       int row = perm[k*C+r];
+                       size_t len = (row >= 0) ? rowpos[row].Size() : 0;
+                       for (size_t j = 0; j < chunkwidth; j++)
+                         {
+                           size_t ii = first + j*C + r;
+                           if (j < len)
+                             {
+                               colnr[ii] = rowcols[row][j];
+                               origpos[ii] = rowpos[row][j];
+                             }
+                           else
+                             {
+                               colnr[ii] = 0;
+                               origpos[ii] = numeric_limits<size_t>::max();
+                             }
+                         }
+                     }
+                 });
+
+    UpdateValues();
+  }
+
+
+  void SELLMatrix :: UpdateValues ()
+  {
+    FlatVector<double> data = mat->AsVector().FV<double>();
+    ParallelForRange (values.Size(), [&] (IntRange r)
+                      {
+                        for (size_t i : r)
+                          values[i] = (origpos[i] != numeric_limits<size_t>::max())
+                            ? data(origpos[i]) : 0.0;
+                      });
+  }
+
+
+  template <bool ADD>
+  void SELLMatrix :: MultAddImpl (double s, FlatVector<double> fx, FlatVector<double> fy) const
+  {
+    if (width == 0)
+      {
+        if (!ADD) fy = 0.0;
+        return;
+      }
+
+    ParallelForRange (NumChunks(), [&] (IntRange r)
+                      {
+                        const double * px = &fx(0);
+                        for (size_t k : r)
+                          {
+                            SIMD<double> sum(0.0);
+                            for (size_t j = firstinchunk[k]; j < firstinchunk[k+1]; j += C)
+                              sum += SIMD<double> (&values[j]) * SIMDGather<C> (px, &colnr[j]);
+
+                            for (int i = 0; i < C; i++)
+                              {
+                                int row = perm[k*C+i];
+                                if (row < 0) break;
+                                if (ADD)
+                                  fy(row) += s * sum[i];
+                                else
+                                  fy(row) = s * sum[i];
+                              }
+                          }
+                      }, TasksPerThread(4));
+  }
+
+
+  void SELLMatrix :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SELLMatrix::Mult"); RegionTimer reg(t);
+    t.AddFlops (NumStored());
+    MultAddImpl<false> (1, x.FV<double>(), y.FV<double>());
+  }
+
+  void SELLMatrix :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SELLMatrix::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (NumStored());
+    MultAddImpl<true> (s, x.FV<double>(), y.FV<double>());
+  }
+
+
+  Array<MemoryUsage> SELLMatrix :: GetMemoryUsage () const
+  {
+    return { MemoryUsage ("SELL-C-sigma",
+                          values.Size()*(sizeof(double)+sizeof(int)+sizeof(size_t))
+                          + perm.Size()*sizeof(int), 1) };
+  }
+
+  ostream & SELLMatrix :: Print (ostream & ost) const
+  {
+    ost << "SELL-" << C << "-" << sigma << " matrix, h = " << height << ", w = " << width
+        << ", nze = " << NZE() << ", stored = " << NumStored() << endl;
+    return ost;
+  }
+
+
+  list<tuple<string,double>> SELLMatrix :: Timing () const
+  {
+    list<tuple<string,double>> results;
+    auto x = CreateRowVector();
+    auto y = CreateColVector();
+    x.FV<double>() = 1.0;
+
+    double time = RunTiming ([&] () { mat->Mult (x, y); });
+    results.push_back (make_tuple ("CSR Mult, per nze", 1e9 * time / max2(NZE(),size_t(1))));
+    time = RunTiming ([&] () { Mult (x, y); });
+    results.push_back (make_tuple ("SELL Mult, per nze", 1e9 * time / max2(NZE(),size_t(1))));
+    results.push_back (make_tuple ("SELL stored / nze", double(NumStored()) / max2(NZE(),size_t(1))));
+    return results;
+  }
+
+}
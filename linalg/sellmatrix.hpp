@@ -0,0 +1,73 @@
+#ifndef FILE_NGS_SELLMATRIX
+#define FILE_NGS_SELLMATRIX
+
+/**************************************************************************/
+/* File:   sellmatrix.hpp                                                 */
+/* Date:   17. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     SELL-C-sigma (sliced ELLPACK) copy of a real sparse matrix.
+
+     Rows are sorted by length within windows of sigma rows, and packed
+     into chunks of C = SIMD<double>::Size() rows. A chunk is stored
+     column by column, padded to its longest row, so the matrix-vector
+     product runs one SIMD lane per row.
+
+     Convert once after assembly; UpdateValues copies new values of the
+     same matrix graph. Transposed products go to the original matrix.
+  */
+  class NGS_DLL_HEADER SELLMatrix : public S_BaseMatrix<double>
+  {
+    shared_ptr<SparseMatrixTM<double>> mat;
+    size_t height, width;
+    size_t sigma;
+    static constexpr int C = SIMD<double>::Size();
+
+    // row in chunk storage -> matrix row, -1 for padding
+    Array<int> perm;
+    // chunk k uses entries [firstinchunk[k], firstinchunk[k+1])
+    Array<size_t> firstinchunk;
+    Array<int> colnr;
+    Array<double> values;
+    // position of the value in the original matrix, -1 for padding
+    Array<size_t> origpos;
+
+  public:
+    SELLMatrix (shared_ptr<SparseMatrixTM<double>> amat, size_t asigma = 256);
+
+    virtual int VHeight() const override { return height; }
+    virtual int VWidth() const override { return width; }
+    virtual AutoVector CreateRowVector () const override { return mat->CreateRowVector(); }
+    virtual AutoVector CreateColVector () const override { return mat->CreateColVector(); }
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override
+    { mat->MultTransAdd (s, x, y); }
+
+    /// copy values again from the original matrix (graph unchanged)
+    void UpdateValues ();
+    virtual void Update() override { UpdateValues(); }
+
+    size_t NumChunks () const { return firstinchunk.Size()-1; }
+    /// stored entries including padding
+    size_t NumStored () const { return values.Size(); }
+    virtual size_t NZE () const override { return mat->NZE(); }
+    virtual Array<MemoryUsage> GetMemoryUsage () const override;
+    virtual ostream & Print (ostream & ost) const override;
+
+    /// compares CSR and SELL matrix-vector products
+    list<tuple<string,double>> Timing () const;
+
+  private:
+    template <bool ADD>
+    void MultAddImpl (double s, FlatVector<double> fx, FlatVector<double> fy) const;
+  };
+
+}
+
+#endif
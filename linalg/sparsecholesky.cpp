@@ -8,114 +8,125 @@
 
 #include <la.hpp>
 
-#include "concurrentqueue.h" 
+namespace ngla
+{
 
+  template <class TM>
+  void SetIdentity( TM &identity )
+  {
+    for (int i=0; i<identity.Width(); i++ ) identity(i,i) = 1;
+  }
+  void SetIdentity( double &identity ) { identity = 1; }
+  void SetIdentity( Complex &identity ) { identity = 1; }
 
-typedef moodycamel::ConcurrentQueue<int> TQueue; 
-typedef moodycamel::ProducerToken TPToken; 
-typedef moodycamel::ConsumerToken TCToken; 
 
+  bool SparseCholeskyOptions :: multifrontal = false;
+  bool SparseCholeskyOptions :: nested_dissection = false;
+  bool SparseCholeskyOptions :: reuse_symbolic = true;
 
-namespace ngstd
-{
-  bool ProcessTask();
-}
-
-namespace ngla
-{
-  
-  static TQueue queue;
 
+  void SparseCholeskySymbolic :: 
+  SetKey (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster)
+  {
+    height = graph.Size();
+    graph_nze = graph.NZE();
+    key_inner = inner ? make_shared<BitArray> (*inner) : nullptr;
+    if (cluster)
+      key_cluster = *cluster;
+    else
+      key_cluster.SetSize0();
+    key_nested_dissection = SparseCholeskyOptions::nested_dissection;
+  }
 
-  template <typename TFUNC>
-  void RunParallelDependency (const Table<int> & dag,
-                              const Table<int> & trans_dag, // transposed dag
-                              TFUNC func)
+  bool SparseCholeskySymbolic :: 
+  Matches (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster) const
   {
-    Array<atomic<int>> cnt_dep(dag.Size());
-    for (auto i : Range(cnt_dep))
-      cnt_dep[i].store (trans_dag[i].Size(), memory_order_relaxed);
-    
-    Array<int> ready(dag.Size());
-    ready.SetSize0();
-    int num_final = 0;
+    if (!valid || height != graph.Size() || graph_nze != graph.NZE()) return false;
+    if (key_nested_dissection != SparseCholeskyOptions::nested_dissection) return false;
 
-    for (int j : Range(cnt_dep))
+    if (bool(inner) != bool(key_inner)) return false;
+    if (inner)
       {
-        if (cnt_dep[j] == 0) ready.Append(j);
-        if (dag[j].Size() == 0) num_final++;
+        if (inner->Size() != key_inner->Size()) return false;
+        for (size_t i = 0; i < inner->Size(); i++)
+          if (inner->Test(i) != key_inner->Test(i)) return false;
       }
 
+    if (bool(cluster) != (key_cluster.Size() > 0)) return false;
+    if (cluster)
+      {
+        if (cluster->Size() != key_cluster.Size()) return false;
+        for (size_t i = 0; i < cluster->Size(); i++)
+          if ((*cluster)[i] != key_cluster[i]) return false;
+      }
+    return true;
+  }
 
-    if (!task_manager)
+  void SparseCholeskySymbolic :: 
+  CalcFillPositions (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster)
+  {
+    static Timer t("SparseCholesky - fill positions");
+    RegionTimer reg(t);
+
+    fillpos.SetSize (graph.NZE());
+    ParallelFor (Range(graph.Size()), [&] (int i)
       {
-        while (ready.Size())
+        auto cols = graph.GetRowIndices(i);
+        auto pos = fillpos.Range (graph.First(i), graph.First(i)+cols.Size());
+        for (size_t j = 0; j < cols.Size(); j++)
           {
-            int size = ready.Size();
-            int nr = ready[size-1];
-            ready.SetSize(size-1);
-            
-            func(nr);
-            
-            for (int j : dag[nr])
+            int col = cols[j];
+            pos[j] = numeric_limits<size_t>::max();
+
+            bool used = col <= i;
+            if (inner)
+              used = used && inner->Test(i) && inner->Test(col);
+            else if (cluster)
+              used = used && (*cluster)[i] == (*cluster)[col] && (*cluster)[i];
+            if (!used) continue;
+
+            int oi = order[i], oj = order[col];
+            if (oi == oj)
               {
-                cnt_dep[j]--;
-                if (cnt_dep[j] == 0)
-                  ready.Append(j);
+                pos[j] = nze + oi;
+                continue;
               }
-          }
-        return;
-      }
-
-    atomic<int> cnt_final(0);
-    SharedLoop sl(Range(ready));
-
-    task_manager -> CreateJob 
-      ([&] (const TaskInfo & ti)
-       {
-        TPToken ptoken(queue); 
-        TCToken ctoken(queue); 
-        
-        for (int i : sl)
-          queue.enqueue (ptoken, ready[i]);
-
-        while (1)
-           {
-             if (cnt_final >= num_final) break;
 
-             while (ProcessTask()); // do the nested tasks
-             
-             int nr;
-             if(!queue.try_dequeue_from_producer(ptoken, nr)) 
-               if(!queue.try_dequeue(ctoken, nr))  
-                 continue; 
-             
-             func(nr);
-
-             if (dag[nr].Size() == 0)
-               cnt_final++;
-
-             for (int j : dag[nr])
-               {
-                 if (--cnt_dep[j] == 0)
-                   queue.enqueue (ptoken, j);
-               }
-           }
-       });
+            // column indices of a row are sorted
+            int lo = min2 (oi, oj), hi = max2 (oi, oj);
+            size_t first = firstinrow[lo], last = firstinrow[lo+1];
+            const int * ri = &rowindex2[firstinrow_ri[lo]];
+            size_t l = 0, r = last-first;
+            while (l < r)
+              {
+                size_t mid = (l+r)/2;
+                if (ri[mid] < hi) l = mid+1; else r = mid;
+              }
+            if (l < last-first && ri[l] == hi)
+              pos[j] = first + l;
+            else
+              cerr << "Position " << lo << ", " << hi << " not found" << endl;
+          }
+      }, TasksPerThread(5));
   }
 
 
+  // guards the symbolic factorization referenced by matrix graphs
+  static mutex symbolic_mutex;
 
-
-
-
-  template <class TM>
-  void SetIdentity( TM &identity )
+  // symbolic factorization referenced by the graph, if it is alive and fits
+  static shared_ptr<SparseCholeskySymbolic>
+  FindSymbolic (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster)
   {
-    for (int i=0; i<identity.Width(); i++ ) identity(i,i) = 1;
+    shared_ptr<SparseCholeskySymbolic> symb;
+    {
+      lock_guard<mutex> guard(symbolic_mutex);
+      symb = graph.CholeskySymbolic().lock();
+    }
+    if (SparseCholeskyOptions::reuse_symbolic && symb && symb->Matches (graph, inner, cluster))
+      return symb;
+    return make_shared<SparseCholeskySymbolic> ();
   }
-  void SetIdentity( double &identity ) { identity = 1; }
-  void SetIdentity( Complex &identity ) { identity = 1; }
 
 
 
@@ -126,11 +137,18 @@ namespace ngla
                     shared_ptr<BitArray> ainner,
                     shared_ptr<const Array<int>> acluster,
                     bool allow_refactor)
-    : SparseFactorization (a, ainner, acluster), mat(a)
+    : SparseFactorization (a, ainner, acluster),
+      symbolic(FindSymbolic (a, ainner.get(), acluster.get())),
+      order(symbolic->order), inv_order(symbolic->inv_order),
+      firstinrow(symbolic->firstinrow), rowindex2(symbolic->rowindex2),
+      firstinrow_ri(symbolic->firstinrow_ri), blocknrs(symbolic->blocknrs),
+      blocks(symbolic->blocks), block_dependency(symbolic->block_dependency),
+      microtasks(symbolic->microtasks), micro_dependency(symbolic->micro_dependency),
+      micro_dependency_trans(symbolic->micro_dependency_trans),
+      mat(a),
+      multifrontal(SparseCholeskyOptions::multifrontal)
   { 
     static Timer t("SparseCholesky - total");
-    static Timer ta("SparseCholesky - allocate");
-    static Timer tf("SparseCholesky - fill factor");
     RegionTimer reg(t);
     // (*testout) << "matrix = " << a << endl;
     // (*testout) << "diag a = ";
@@ -138,14 +156,83 @@ namespace ngla
 
     int n = a.Height();
     height = n;
+    mdo = nullptr;
 
     int printstat = 0;
-    
+    clock_t starttime, endtime;
+    starttime = clock();
+
+    if (symbolic->valid)
+      {
+        // same graph and dofs as before, only new values
+        nused = symbolic->nused;
+        nze = symbolic->nze;
+        maxrow = symbolic->maxrow;
+      }
+    else
+      SymbolicFactorization (a);
+
+    diag.SetSize(nused);
+    // lfact.SetSize (nze);
+    lfact = NumaInterleavedArray<TM> (nze);
+    FillValues (a);
+
     if (printstat)
-      cout << IM(4) << "Minimal degree ordering: N = " << n << endl;
+      cout << IM(4) << "do factor " << flush;
+
+    FactorSPD();
+    /*
+#ifdef LAPACK
+    if (a.IsSPD())
+      FactorSPD();
+    else
+#endif
+      Factor(); 
+    */
+
+    /*
+    for (int i = 0; i < n; i++)
+      if (a.GetPositionTest (i,i) == numeric_limits<size_t>::max())
+	diag[order[i]] = TM(0.0);
+
+    if (inner)
+      {
+	for (int i = 0; i < n; i++)
+	  if (!inner->Test(i))
+	    diag[order[i]] = TM(0.0);
+      }
+
+    if (cluster)
+      {
+	for (int i = 0; i < n; i++)
+	  if (!(*cluster)[i])
+	    diag[order[i]] = TM(0.0);
+      }
+    */
+
+    if (printstat)
+      cout << IM(4) << "done" << endl;
     
+    endtime = clock();
+
+    if (printstat)
+      (cout) << " factoring time = " << double(endtime - starttime) / CLOCKS_PER_SEC << " sec" << endl;
+  }
+  
+
+  
+  template <class TM>
+  void SparseCholeskyTM<TM> :: 
+  SymbolicFactorization (const SparseMatrixTM<TM> & a)
+  {
+    static Timer ta("SparseCholesky - allocate");
+    int n = a.Height();
+    int printstat = 0;
     clock_t starttime, endtime;
     starttime = clock();
+
+    if (printstat)
+      cout << IM(4) << "Minimal degree ordering: N = " << n << endl;
     
     mdo = new MinimumDegreeOrdering (n);
 
@@ -217,7 +304,10 @@ namespace ngla
       cout << IM(4) << "start ordering" << endl;
     
     // mdo -> PrintCliques ();
-    mdo->Order();
+    if (SparseCholeskyOptions::nested_dissection)
+      mdo->OrderNestedDissection();
+    else
+      mdo->Order();
     nused = mdo->nused;
     endtime = clock();
     if (printstat)
@@ -233,136 +323,28 @@ namespace ngla
     Allocate (mdo->order,  mdo->vertices, &mdo->blocknr[0]);
     ta.Stop();
 
-    tf.Start();
     delete mdo;
     mdo = 0;
 
-    diag.SetSize(nused);
-    // lfact.SetSize (nze);
-    lfact = NumaInterleavedArray<TM> (nze);
-
-    // lfact = TM(0.0);     // first touch
-    ParallelForRange (nze, [&] (IntRange r)
-                      {
-                        lfact.Range(r) = TM(0.0);
-                      });
-    
-    endtime = clock();
-    if (printstat)
-      (cout) << "allocation time = "
-	     << double (endtime - starttime) / CLOCKS_PER_SEC << " secs" << endl;
-    
-    starttime = endtime;
-
-    /*
-    TM id;
-    id = 0.0;
-    SetIdentity(id);
-    
-    for (int i = 0; i < n; i++)
-      if (a.GetPositionTest (i,i) == numeric_limits<size_t>::max())
-	SetOrig (i, i, id);
-    */
-
-    if (!inner && !cluster)
-      // for (int i = 0; i < n; i++)
-      ParallelFor 
-        (Range(n), [&](int i)
-         {
-           for (int j = 0; j < a.GetRowIndices(i).Size(); j++)
-             {
-               int col = a.GetRowIndices(i)[j];
-               if (col <= i)
-                 SetOrig (i, col, a.GetRowValues(i)[j]);
-             }
-         });
-    
-    else if (inner)
-      // for (int i = 0; i < n; i++)
-      ParallelFor 
-        (Range(n), [&](int i)
-         {
-           if (inner->Test(i))
-             for (int j = 0; j < a.GetRowIndices(i).Size(); j++)
-               {
-                 int col = a.GetRowIndices(i)[j];
-                 if (col <= i)
-                   {
-                     if (inner->Test(col))
-                       SetOrig (i, col, a.GetRowValues(i)[j]);
-                     /*
-                       else
-                       if (i==col)
-                       SetOrig (i, col, id);
-                     */
-                   }
-               }
-         }, TasksPerThread(5));
-    else
-      for (int i = 0; i < n; i++)
-	{
-	  FlatArray<int> row = a.GetRowIndices(i);
-	  for (int j = 0; j < row.Size(); j++)
-	    {
-	      int col = row[j];
-	      if (col <= i)
-		if ( ( (*cluster)[i] == (*cluster)[col] && (*cluster)[i])
-                     // || i == col 
-                     )
-                  SetOrig (i, col, a.GetRowValues(i)[j]);
-              /*
-              if (col == i && (*cluster)[i] == 0)
-                SetOrig (i, i, id);
-              */
-	    }
-	}
-
-    tf.Stop();
-    
-    if (printstat)
-      cout << IM(4) << "do factor " << flush;
-
-    FactorSPD();
-    /*
-#ifdef LAPACK
-    if (a.IsSPD())
-      FactorSPD();
-    else
-#endif
-      Factor(); 
-    */
-
-    /*
-    for (int i = 0; i < n; i++)
-      if (a.GetPositionTest (i,i) == numeric_limits<size_t>::max())
-	diag[order[i]] = TM(0.0);
-
-    if (inner)
-      {
-	for (int i = 0; i < n; i++)
-	  if (!inner->Test(i))
-	    diag[order[i]] = TM(0.0);
-      }
-
-    if (cluster)
+    symbolic->nused = nused;
+    symbolic->nze = nze;
+    symbolic->maxrow = maxrow;
+    symbolic->CalcFillPositions (a, inner.get(), cluster.get());
+    symbolic->SetKey (a, inner.get(), cluster.get());
+    symbolic->valid = true;
+    if (SparseCholeskyOptions::reuse_symbolic)
       {
-	for (int i = 0; i < n; i++)
-	  if (!(*cluster)[i])
-	    diag[order[i]] = TM(0.0);
+        lock_guard<mutex> guard(symbolic_mutex);
+        a.CholeskySymbolic() = symbolic;
       }
-    */
 
-    if (printstat)
-      cout << IM(4) << "done" << endl;
-    
     endtime = clock();
-
     if (printstat)
-      (cout) << " factoring time = " << double(endtime - starttime) / CLOCKS_PER_SEC << " sec" << endl;
+      (cout) << "allocation time = "
+	     << double (endtime - starttime) / CLOCKS_PER_SEC << " secs" << endl;
   }
   
 
-  
   template <class TM>
   void SparseCholeskyTM<TM> :: 
   Allocate (const Array<int> & aorder, 
@@ -610,6 +592,14 @@ namespace ngla
     id = 0.0;
     SetIdentity(id);
 
+    // same graph: positions in the factor are known
+    if (a.NZE() == mat.NZE() && (height == 0 || a.GetRowIndices(0).Addr(0) == mat.GetRowIndices(0).Addr(0)))
+      {
+        FillValues (a);
+        FactorSPD();
+        return;
+      }
+
     // for (size_t i = 0; i < nze; i++) lfact[i] = 0.0;
     lfact = TM(0.0);
 
@@ -650,6 +640,48 @@ namespace ngla
 
 
 
+  template <class TM>
+  void SparseCholeskyTM<TM> :: 
+  FillValues (const SparseMatrixTM<TM> & a)
+  {
+    static Timer t("SparseCholesky - fill factor");
+    RegionTimer reg(t);
+
+    FlatArray<size_t> fillpos = symbolic->fillpos;
+    TM * hdiag = diag.Addr(0);
+    size_t hnze = nze;
+
+    // first touch
+    ParallelForRange (nze, [&] (IntRange r)
+                      {
+                        lfact.Range(r) = TM(0.0);
+                      });
+    ParallelForRange (diag.Size(), [&] (IntRange r)
+                      {
+                        diag.Range(r) = TM(0.0);
+                      });
+
+    ParallelFor (Range(height), [&] (int i)
+      {
+        auto cols = a.GetRowIndices(i);
+        auto vals = a.GetRowValues(i);
+        auto pos = fillpos.Range (a.First(i), a.First(i)+cols.Size());
+        for (size_t j = 0; j < cols.Size(); j++)
+          {
+            size_t p = pos[j];
+            if (p == numeric_limits<size_t>::max()) continue;
+            if (p >= hnze)
+              hdiag[p-hnze] = vals(j);
+            else if (order[i] > order[cols[j]])
+              lfact[p] = Trans (vals(j));
+            else
+              lfact[p] = vals(j);
+          }
+      }, TasksPerThread(5));
+  }
+
+
+
   template <class TM>
   void SparseCholeskyTM<TM> :: Factor () 
   {
@@ -983,10 +1015,16 @@ namespace ngla
     Factor();
   }
 
+  template <>
+  void SparseCholeskyTM<double> :: FactorMultifrontal ();
+
   template <>
   void SparseCholeskyTM<double> :: FactorSPD ()
   {
-    FactorSPD1(5.3);
+    if (multifrontal)
+      FactorMultifrontal();
+    else
+      FactorSPD1(5.3);
   }
 
   template <>
@@ -1574,6 +1612,176 @@ namespace ngla
 
 
 
+  /*
+    Multifrontal factorization:
+
+    The parent of a block in the supernodal elimination tree is the
+    block of its first external dof. Every block assembles its frontal
+    matrix from its own entries and the update matrices of its children,
+    factors the leading part and leaves the Schur complement for the
+    parent. No locks are needed, independent subtrees run in parallel.
+  */
+  template <class TM>
+  void SparseCholeskyTM<TM> :: FactorMultifrontal ()
+  {
+    throw Exception ("SparseCholesky: multifrontal factorization only available for real matrices");
+  }
+
+  template <>
+  void SparseCholeskyTM<double> :: FactorMultifrontal ()
+  {
+    if (!task_manager)
+      {
+        RunWithTaskManager ([&] ()
+                            {
+                              FactorMultifrontal();
+                            });
+        return;
+      }
+
+    static Timer factor_timer("SparseCholesky::Factor multifrontal");
+    static Timer timer_front("SparseCholesky::Factor multifrontal - assemble front", 2);
+    static Timer timer_dense("SparseCholesky::Factor multifrontal - dense factor", 2);
+    RegionTimer reg (factor_timer);
+
+    size_t n = nused;
+    if (n == 0) return;
+    if (n > 2000)
+      cout << IM(4) << " factor multifrontal " << flush;
+
+    size_t nblocks = blocks.Size()-1;
+    Array<int> block_of_dof(n);
+    for (size_t i = 0; i < nblocks; i++)
+      block_of_dof[BlockDofs(i)] = i;
+
+    // elimination tree, child -> parent, and its transpose
+    TableCreator<int> creator(nblocks);
+    TableCreator<int> creator_trans(nblocks);
+    for ( ; !creator.Done(); creator++, creator_trans++)
+      for (size_t i = 0; i < nblocks; i++)
+        {
+          auto ext = BlockExtDofs(i);
+          if (ext.Size())
+            {
+              creator.Add (i, block_of_dof[ext[0]]);
+              creator_trans.Add (block_of_dof[ext[0]], i);
+            }
+        }
+    Table<int> tree = creator.MoveTable();
+    Table<int> children = creator_trans.MoveTable();
+
+    // fronts of finished blocks, the trailing block is the update for the parent
+    Array<Array<double>> updates(nblocks);
+
+    RunParallelDependency
+      (tree, children, [&] (int blocknr)
+       {
+         IntRange block = BlockDofs(blocknr);
+         FlatArray<int> ext = BlockExtDofs(blocknr);
+         size_t i1 = block.First();
+         size_t mi = block.Size();
+         size_t nu = ext.Size();
+         size_t nk = mi + nu;
+
+         Array<double> frontmem(nk*nk);
+         FlatMatrix<double,ColMajor> front(nk, nk, frontmem.Addr(0));
+         {
+           ThreadRegionTimer regfront(timer_front, TaskManager::GetThreadId());
+           // only the lower triangle is used
+           for (size_t j = 0; j < mi; j++)
+             {
+               front(j,j) = diag[i1+j];
+               front.Col(j).Range(j+1,nk) = FlatVector<double>(nk-j-1, lfact.Addr(firstinrow[i1+j]));
+             }
+           for (size_t j = mi; j < nk; j++)
+             front.Col(j).Range(j,nk) = 0.0;
+
+           // extend-add the update matrices of the children
+           for (int child : children[blocknr])
+             {
+               FlatArray<int> cext = BlockExtDofs(child);
+               size_t nc = cext.Size();
+               size_t mc = BlockDofs(child).Size();
+               auto upd = FlatMatrix<double,ColMajor>(mc+nc, mc+nc, updates[child].Addr(0)).Rows(mc,mc+nc).Cols(mc,mc+nc);
+
+               ArrayMem<int,100> pos(nc);
+               for (size_t k = 0, l = 0; k < nc; k++)
+                 {
+                   int dof = cext[k];
+                   if (dof < block.Next())
+                     pos[k] = dof - i1;
+                   else
+                     {
+                       while (l < nu && ext[l] < dof) l++;
+                       if (l == nu || ext[l] != dof)
+                         throw Exception ("SparseCholesky: update of child block does not fit into front");
+                       pos[k] = mi + l;
+                     }
+                 }
+
+               // pos is increasing, contiguous runs are added as vectors
+               for (size_t j = 0; j < nc; j++)
+                 {
+                   auto col = front.Col(pos[j]);
+                   auto ucol = upd.Col(j);
+                   for (size_t k = j, k2; k < nc; k = k2)
+                     {
+                       for (k2 = k+1; k2 < nc && pos[k2] == pos[k2-1]+1; k2++) ;
+                       col.Range(pos[k], pos[k]+k2-k) += ucol.Range(k, k2);
+                     }
+                 }
+               updates[child] = Array<double>();
+             }
+         }
+
+         // right-looking LDL^t in panels of the leading mi columns,
+         // the Schur complement updates of the front are ngblas calls
+         ThreadRegionTimer regdense(timer_dense, TaskManager::GetThreadId());
+         constexpr size_t PW = 64;    // panel width
+         constexpr size_t BW = 128;   // column blocks of the update
+         for (size_t k0 = 0; k0 < mi; k0 += PW)
+           {
+             size_t k1 = min2 (k0+PW, mi);
+             auto D = front.Rows(k0,k1).Cols(k0,k1);
+             auto P = front.Rows(k1,nk).Cols(k0,k1);
+             CalcLDL (D);
+             if (k1 == nk) break;
+             CalcLDL_SolveL (D, P);
+             // lower part of front(k1:nk,k1:nk) -= P diag(D) P^t
+             for (size_t j0 = k1; j0 < nk; j0 += BW)
+               {
+                 size_t j1 = min2 (j0+BW, nk);
+                 ngbla::SubADBt<double> (P.Rows(j0-k1, nk-k1), D.Diag(),
+                                         P.Rows(j0-k1, j1-k1),
+                                         front.Rows(j0,nk).Cols(j0,j1));
+               }
+           }
+         auto A11 = front.Rows(0,mi).Cols(0,mi);
+
+         for (size_t j = 0; j < mi; j++)
+           {
+             diag[i1+j] = A11(j,j);
+             FlatVector<double>(nk-j-1, lfact.Addr(firstinrow[i1+j])) = front.Col(j).Range(j+1,nk);
+           }
+
+         // the trailing block is the update matrix for the parent
+         if (nu)
+           updates[blocknr] = move(frontmem);
+       });
+
+    ParallelFor (n, [&] (size_t i)
+      {
+        double ai = diag[i];
+        for (auto j : Range(firstinrow[i], firstinrow[i+1]))
+          lfact[j] *= ai;
+      }, TasksPerThread(5));
+
+    if (n > 2000)
+      cout << IM(4) << endl;
+  }
+
+
+
 
 
   
@@ -2059,6 +2267,175 @@ namespace ngla
   
 
 
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  Mult (const MultiVector & x, MultiVector & y) const
+  {
+    y = 0.0;
+    MultAdd (1, x, y);
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    BaseMatrix::MultAdd (s, x, y);
+  }
+
+  template <class TM, class TV_ROW, class TV_COL>
+  void SparseCholesky<TM, TV_ROW, TV_COL> :: 
+  SolveReordered (FlatMatrix<TVX> hy) const
+  {
+    throw Exception ("SparseCholesky::SolveReordered for multiple vectors only for double");
+  }
+
+
+  template <>
+  void SparseCholesky<double, double, double> :: 
+  SolveReordered (FlatMatrix<double> hy) const
+  {
+    static Timer timer1("SparseCholesky<d,d,d>::MultAdd multi fac1");
+    static Timer timer2("SparseCholesky<d,d,d>::MultAdd multi fac2");
+
+    // same task graph as for a single vector, every row operation is for all rhs
+    size_t k = hy.Width();
+
+    timer1.Start();
+    RunParallelDependency (micro_dependency, micro_dependency_trans,
+                           [&,hy] (int nr) 
+                           {
+                             auto task = microtasks[nr];
+                             auto range = BlockDofs (task.blocknr);
+                             if (range.Size()==0) return;
+
+                             if (task.type != MicroTask::B_BLOCK)
+                               for (auto i : range)
+                                 {
+                                   size_t size = range.end()-i-1;
+                                   FlatVector<> vlfact(size, &lfact[firstinrow[i]]);
+                                   for (size_t j = 0; j < size; j++)
+                                     hy.Row(i+1+j) -= vlfact(j) * hy.Row(i);
+                                 }
+
+                             if (task.type == MicroTask::L_BLOCK) return;
+
+                             auto all_extdofs = BlockExtDofs (task.blocknr);
+                             if (all_extdofs.Size() == 0) return;
+                             IntRange myr = (task.type == MicroTask::LB_BLOCK) ? IntRange(0, all_extdofs.Size())
+                               : Range(all_extdofs).Split (task.bblock, task.nbblocks);
+                             auto extdofs = all_extdofs.Range(myr);
+
+                             Matrix<> temp(extdofs.Size(), k);
+                             temp = 0.0;
+                             for (auto i : range)
+                               {
+                                 size_t first = firstinrow[i] + range.end()-i-1 + myr.First();
+                                 FlatVector<> ext_lfact (extdofs.Size(), &lfact[first]);
+                                 for (size_t j = 0; j < extdofs.Size(); j++)
+                                   temp.Row(j) += ext_lfact(j) * hy.Row(i);
+                               }
+
+                             for (size_t j : Range(extdofs))
+                               for (size_t l = 0; l < k; l++)
+                                 MyAtomicAdd (hy(extdofs[j], l), -temp(j,l));
+                           });
+    timer1.Stop();
+
+    ParallelFor (hy.Height(), [&] (size_t i)
+                 {
+                   hy.Row(i) *= diag[i];
+                 });
+
+    timer2.Start();
+    RunParallelDependency (micro_dependency_trans, micro_dependency,
+                           [&,hy] (int nr) 
+                           {
+                             auto task = microtasks[nr];
+                             auto range = BlockDofs (task.blocknr);
+                             if (range.Size()==0) return;
+
+                             auto all_extdofs = BlockExtDofs (task.blocknr);
+                             if (task.type != MicroTask::L_BLOCK && all_extdofs.Size())
+                               {
+                                 IntRange myr = (task.type == MicroTask::LB_BLOCK) ? IntRange(0, all_extdofs.Size())
+                                   : Range(all_extdofs).Split (task.bblock, task.nbblocks);
+                                 auto extdofs = all_extdofs.Range(myr);
+
+                                 Matrix<> temp(extdofs.Size(), k);
+                                 for (size_t j : Range(extdofs))
+                                   temp.Row(j) = hy.Row(extdofs[j]);
+
+                                 Vector<> val(k);
+                                 for (auto i : range)
+                                   {
+                                     size_t first = firstinrow[i] + range.end()-i-1 + myr.First();
+                                     FlatVector<> ext_lfact (extdofs.Size(), &lfact[first]);
+                                     val = 0.0;
+                                     for (size_t j = 0; j < extdofs.Size(); j++)
+                                       val += ext_lfact(j) * temp.Row(j);
+                                     if (task.type == MicroTask::LB_BLOCK)
+                                       hy.Row(i) -= val;
+                                     else
+                                       for (size_t l = 0; l < k; l++)
+                                         MyAtomicAdd (hy(i,l), -val(l));
+                                   }
+                               }
+
+                             if (task.type == MicroTask::B_BLOCK) return;
+
+                             for (size_t i = range.end()-1; i-- > range.begin(); )
+                               {
+                                 size_t size = range.end()-i-1;
+                                 FlatVector<> vlfact(size, &lfact[firstinrow[i]]);
+                                 for (size_t j = 0; j < size; j++)
+                                   hy.Row(i) -= vlfact(j) * hy.Row(i+1+j);
+                               }
+                           });
+    timer2.Stop();
+  }
+
+
+  template <>
+  void SparseCholesky<double, double, double> :: 
+  MultAdd (double s, const MultiVector & x, MultiVector & y) const
+  {
+    static Timer timer("SparseCholesky<d,d,d>::MultAdd multi");
+    RegionTimer reg (timer);
+
+    size_t k = x.Size();
+    if (y.Size() != k)
+      throw Exception ("SparseCholesky::MultAdd: MultiVectors of different size");
+    if (k == 0) return;
+    timer.AddFlops (2.0*k*lfact.Size());
+
+    Array<double*> fx(k), fy(k);
+    for (size_t l = 0; l < k; l++)
+      {
+        fx[l] = x[l].FV<double>().Data();
+        fy[l] = y[l].FV<double>().Data();
+      }
+
+    // the reordered right hand sides of one dof are consecutive
+    Matrix<> hy(this->nused, k);
+    ParallelFor (Range(height), [&] (int i)
+                 {
+                   if (order[i] != -1)
+                     for (size_t l = 0; l < k; l++)
+                       hy(order[i], l) = fx[l][i];
+                 });
+
+    SolveReordered (hy);
+
+    ParallelFor (Range(height), [&] (int i)
+                 {
+                   bool use = inner ? inner->Test(i) : cluster ? (*cluster)[i] != 0 : order[i] != -1;
+                   if (use)
+                     for (size_t l = 0; l < k; l++)
+                       fy[l][i] += s * hy(order[i], l);
+                 });
+  }
+
+
   template <class TM, class TV_ROW, class TV_COL>
   void SparseCholesky<TM, TV_ROW, TV_COL> :: 
   Smooth (BaseVector & u, const BaseVector & f, BaseVector & y) const
@@ -47,10 +47,87 @@ namespace ngla
 
 
 
+  /**
+     Settings for newly created sparse Cholesky factorizations.
+  */
+  class NGS_DLL_HEADER SparseCholeskyOptions
+  {
+  public:
+    /// numeric factorization with dense frontal matrices along the elimination tree
+    static bool multifrontal;
+    /// nested dissection instead of minimum degree ordering
+    static bool nested_dissection;
+    /// reuse the symbolic factorization of an existing inverse with the same graph
+    static bool reuse_symbolic;
+  };
+
+
+
+  /**
+     The symbolic part of a sparse Cholesky factorization: ordering,
+     non-zero pattern of the factor, supernodes and task graphs.
+
+     It depends only on the matrix graph, the used dofs and the ordering
+     options. The matrix graph keeps a weak reference to it, and further
+     factorizations of matrices with the same graph just fill in new values
+     as long as an inverse holding the symbolic factorization is alive.
+  */
+  class NGS_DLL_HEADER SparseCholeskySymbolic
+  {
+  public:
+    class MicroTask
+    {
+    public:
+      int blocknr;
+      enum BT { L_BLOCK, B_BLOCK, LB_BLOCK };
+      BT type;
+      int bblock;
+      int nbblocks;
+    };
+
+    int nused = 0;
+    size_t nze = 0;
+    int maxrow = 0;
+    /// analysis is complete
+    bool valid = false;
+
+    Array<int> order;
+    Array<int> inv_order;
+    Array<size_t> firstinrow;
+    Array<int> rowindex2;
+    Array<size_t> firstinrow_ri;
+    Array<int> blocknrs;
+    Array<int> blocks;
+    Table<int> block_dependency;
+    Array<MicroTask> microtasks;
+    Table<int> micro_dependency;
+    Table<int> micro_dependency_trans;
+
+    /// position of the matrix entry in the factor, nze+i for diagonal i,
+    /// size_t(-1) for entries not used
+    Array<size_t> fillpos;
+
+    /// dofs, clusters and options of the analysis
+    void SetKey (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster);
+    bool Matches (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster) const;
+
+    /// positions of the lower triangular matrix entries in the factor
+    void CalcFillPositions (const MatrixGraph & graph, const BitArray * inner, const Array<int> * cluster);
+
+  private:
+    int height = -1;
+    size_t graph_nze = 0;
+    shared_ptr<BitArray> key_inner;
+    Array<int> key_cluster;
+    bool key_nested_dissection = false;
+  };
+
+
+
   /**
      A sparse cholesky factorization.
      The unknowns are reordered by the minimum degree
-     ordering algorithm
+     ordering algorithm, or by nested dissection
 
      computs A = L D L^t
      L is stored column-wise
@@ -62,6 +139,9 @@ namespace ngla
   class NGS_DLL_HEADER SparseCholeskyTM : public SparseFactorization
   {
   protected:
+    // ordering and structure, may be shared with other factorizations
+    shared_ptr<SparseCholeskySymbolic> symbolic;
+
     // height of the matrix
     int height;
     // number of real unknowns
@@ -70,15 +150,15 @@ namespace ngla
     size_t nze;
 
     // the reordering (original dofnr i -> order[i])
-    Array<int> order;
-    Array<int> inv_order;
+    Array<int> & order;
+    Array<int> & inv_order;
     
     // L-factor in compressed storage
     // Array<TM, size_t> lfact;
     NumaInterleavedArray<TM> lfact;
 
     // index-array to lfact
-    Array<size_t> firstinrow;
+    Array<size_t> & firstinrow;
 
     // diagonal 
     Array<TM> diag;
@@ -86,34 +166,26 @@ namespace ngla
 
     // row-indices of non-zero entries
     // all row-indices within one block are identic, and stored just once
-    Array<int> rowindex2;
+    Array<int> & rowindex2;
     // index-array to rowindex
-    Array<size_t> firstinrow_ri;
+    Array<size_t> & firstinrow_ri;
     
     // blocknr of dof
-    Array<int> blocknrs;
+    Array<int> & blocknrs;
 
     // block i has dofs  [blocks[i], blocks[i+1])
-    Array<int> blocks; 
+    Array<int> & blocks; 
 
     // dependency graph for elimination
-    Table<int> block_dependency; 
+    Table<int> & block_dependency; 
 
   public:      // needed for gcc 4.9, why  ??? 
-    class MicroTask
-    {
-    public:
-      int blocknr;
-      enum BT { L_BLOCK, B_BLOCK, LB_BLOCK };
-      BT type;
-      int bblock;
-      int nbblocks;
-    };
+    typedef SparseCholeskySymbolic::MicroTask MicroTask;
   protected:
     
-    Array<MicroTask> microtasks;
-    Table<int> micro_dependency;     
-    Table<int> micro_dependency_trans;     
+    Array<MicroTask> & microtasks;
+    Table<int> & micro_dependency;     
+    Table<int> & micro_dependency_trans;     
 
 
     //
@@ -125,6 +197,9 @@ namespace ngla
     // the original matrix
     const SparseMatrixTM<TM> & mat;
 
+    // use the multifrontal factorization (real matrices only)
+    bool multifrontal;
+
   public:
     typedef typename mat_traits<TM>::TSCAL TSCAL_MAT;
 
@@ -139,6 +214,8 @@ namespace ngla
     int VHeight() const { return height; }
     ///
     int VWidth() const { return height; }
+    /// ordering, structure of the factor and task graphs
+    void SymbolicFactorization (const SparseMatrixTM<TM> & a);
     ///
     void Allocate (const Array<int> & aorder, 
 		   const Array<MDOVertex> & vertices,
@@ -149,6 +226,7 @@ namespace ngla
     void FactorSPD (); 
     template <typename T>
     void FactorSPD1 (T dummy); 
+    void FactorMultifrontal ();
 #endif
 
     virtual bool SupportsUpdate() const { return true; }     
@@ -160,6 +238,8 @@ namespace ngla
     }
     ///
     void FactorNew (const SparseMatrix<TM> & a);
+    /// copy matrix values into the factor storage
+    void FillValues (const SparseMatrixTM<TM> & a);
 
     /**
        A = L+D+L^T
@@ -248,6 +328,10 @@ namespace ngla
 
     virtual void MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const;
 
+    /// one forward/backward sweep for all right hand sides (real matrices only, else column by column)
+    virtual void Mult (const MultiVector & x, MultiVector & y) const;
+    virtual void MultAdd (double s, const MultiVector & x, MultiVector & y) const;
+
     virtual AutoVector CreateVector () const
     {
       return make_shared<VVector<TV>> (height);
@@ -259,6 +343,8 @@ namespace ngla
     void SolveBlockT (int i, FlatVector<TV> hy) const;
   private:
     void SolveReordered(FlatVector<TVX> hy) const;
+    /// rows are the reordered dofs, columns the right hand sides
+    void SolveReordered(FlatMatrix<TVX> hy) const;
   };
 
 
@@ -1507,7 +1507,12 @@ namespace ngla
     ar & this->nze;
     ar & firsti;
     ar & colnr;
-    ar & data;
+    // matrix entries as one array of scalars, same sequence as element-wise
+    size_t n = data.Size();
+    ar & n;
+    if (ar.Input()) data.SetSize(n);
+    constexpr size_t ndouble = sizeof(TM) / sizeof(double);
+    if (n) ar.Do (reinterpret_cast<double*> (&data[0]), n*ndouble);
     cout << "sparsemat, doarch, sizeof (firstint) = " << firsti.Size() << endl;
   }
 
@@ -70,6 +70,8 @@ namespace ngla
 #endif
 
 
+  class SparseCholeskySymbolic;
+
   /** 
       The graph of a sparse matrix.
   */
@@ -99,6 +101,9 @@ namespace ngla
     /// owner of arrays ?
     bool owner;
 
+    /// symbolic factorization of a living inverse, reused for new values
+    mutable weak_ptr<SparseCholeskySymbolic> cholesky_symbolic;
+
   public:
     /// arbitrary number of els/row
     MatrixGraph (const Array<int> & elsperrow, int awidth);
@@ -144,6 +149,8 @@ namespace ngla
     void CalcBalancing ();
     const Partitioning & GetBalancing() const { return balance; } 
 
+    weak_ptr<SparseCholeskySymbolic> & CholeskySymbolic() const { return cholesky_symbolic; }
+
     ostream & Print (ostream & ost) const;
 
     virtual Array<MemoryUsage> GetMemoryUsage () const;    
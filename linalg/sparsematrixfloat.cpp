@@ -0,0 +1,187 @@
+/*********************************************************************/
+/* File:   sparsematrixfloat.cpp                                     */
+/* Date:   17. Oct. 2026                                             */
+/*********************************************************************/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  SparseMatrixFloat :: SparseMatrixFloat (shared_ptr<SparseMatrixTM<double>> amat)
+    : BaseSparseMatrix (*amat, false), mat(amat), data(nze)
+  {
+    static Timer t("SparseMatrixFloat - convert");
+    RegionTimer reg(t);
+
+    SetParallelDofs (mat->GetParallelDofs());
+    symmetric = dynamic_pointer_cast<SparseMatrixSymmetric<double>> (mat) != nullptr;
+    UpdateValues();
+  }
+
+  SparseMatrixFloat :: ~SparseMatrixFloat ()
+  { ; }
+
+
+  void SparseMatrixFloat :: UpdateValues ()
+  {
+    FlatVector<double> vals = mat->AsVector().FV<double>();
+    ParallelForRange (balance, [&] (IntRange r)
+                      {
+                        for (size_t j = firsti[r.First()]; j < firsti[r.Next()]; j++)
+                          data[j] = vals(j);
+                      });
+  }
+
+
+  AutoVector SparseMatrixFloat :: CreateVector () const
+  {
+    if (size == width)
+      return make_shared<VVector<double>> (size);
+    throw Exception ("SparseMatrixFloat::CreateVector for rectangular does not make sense, use either CreateColVector or CreateRowVector");
+  }
+
+  AutoVector SparseMatrixFloat :: CreateRowVector () const
+  {
+    return make_shared<VVector<double>> (width);
+  }
+
+  AutoVector SparseMatrixFloat :: CreateColVector () const
+  {
+    return make_shared<VVector<double>> (size);
+  }
+
+
+  void SparseMatrixFloat :: Mult (const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixFloat::Mult"); RegionTimer reg(t);
+    t.AddFlops (NZE());
+
+    if (symmetric)
+      {
+        y = 0.0;
+        MultAdd (1, x, y);
+        return;
+      }
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    ParallelForRange (balance, [&] (IntRange r)
+                      {
+                        for (auto row : r)
+                          fy(row) = RowTimesVector (row, fx);
+                      });
+  }
+
+  void SparseMatrixFloat :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixFloat::MultAdd"); RegionTimer reg(t);
+    t.AddFlops (NZE());
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+
+    if (symmetric)
+      {
+        for (int i = 0; i < size; i++)
+          {
+            fy(i) += s * RowTimesVector (i, fx);
+            AddRowTransToVectorNoDiag (i, s * fx(i), fy);
+          }
+        return;
+      }
+
+    ParallelForRange (balance, [&] (IntRange r)
+                      {
+                        for (auto row : r)
+                          fy(row) += s * RowTimesVector (row, fx);
+                      });
+  }
+
+  void SparseMatrixFloat :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("SparseMatrixFloat::MultTransAdd"); RegionTimer reg(t);
+    t.AddFlops (NZE());
+
+    if (symmetric)
+      {
+        MultAdd (s, x, y);
+        return;
+      }
+
+    FlatVector<double> fx = x.FV<double>();
+    FlatVector<double> fy = y.FV<double>();
+    for (int i = 0; i < size; i++)
+      AddRowTransToVector (i, s*fx(i), fy);
+  }
+
+
+  shared_ptr<BaseJacobiPrecond>
+  SparseMatrixFloat :: CreateJacobiPrecond (shared_ptr<BitArray> inner) const
+  {
+    return make_shared<JacobiPrecondFloat> (*this, inner);
+  }
+
+  shared_ptr<BaseBlockJacobiPrecond>
+  SparseMatrixFloat :: CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
+                                                 const BaseVector * constraint,
+                                                 bool parallel,
+                                                 shared_ptr<BitArray> freedofs) const
+  {
+    if (constraint)
+      throw Exception ("SparseMatrixFloat::CreateBlockJacobiPrecond: constraint not supported");
+
+    if (freedofs)
+      {
+        // keep only the free dofs of every block
+        TableCreator<int> creator(blocks->Size());
+        for ( ; !creator.Done(); creator++)
+          for (size_t i = 0; i < blocks->Size(); i++)
+            for (int d : (*blocks)[i])
+              if (freedofs->Test(d))
+                creator.Add (i, d);
+        blocks = make_shared<Table<int>> (creator.MoveTable());
+      }
+
+    return make_shared<BlockJacobiPrecondFloat> (*this, blocks, parallel);
+  }
+
+
+  Array<MemoryUsage> SparseMatrixFloat :: GetMemoryUsage () const
+  {
+    Array<MemoryUsage> mu = MatrixGraph::GetMemoryUsage();
+    mu += { "SparseMatrixFloat", nze*sizeof(float), 1 };
+    return mu;
+  }
+
+  ostream & SparseMatrixFloat :: Print (ostream & ost) const
+  {
+    for (int i = 0; i < size; i++)
+      {
+        ost << "Row " << i << ":";
+        auto cols = GetRowIndices(i);
+        auto vals = GetRowValues(i);
+        for (size_t j = 0; j < cols.Size(); j++)
+          ost << "   " << cols[j] << ": " << vals(j);
+        ost << "\n";
+      }
+    return ost;
+  }
+
+
+  list<tuple<string,double>> SparseMatrixFloat :: Timing () const
+  {
+    list<tuple<string,double>> results;
+    auto x = CreateRowVector();
+    auto y = CreateColVector();
+    x.FV<double>() = 1.0;
+
+    size_t nzefull = max2 (nze, size_t(1));
+    double time = RunTiming ([&] () { mat->Mult (x, y); });
+    results.push_back (make_tuple ("double Mult, per nze", 1e9 * time / nzefull));
+    time = RunTiming ([&] () { Mult (x, y); });
+    results.push_back (make_tuple ("float Mult, per nze", 1e9 * time / nzefull));
+    return results;
+  }
+
+}
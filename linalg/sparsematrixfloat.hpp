@@ -0,0 +1,125 @@
+#ifndef FILE_NGS_SPARSEMATRIXFLOAT
+#define FILE_NGS_SPARSEMATRIXFLOAT
+
+/**************************************************************************/
+/* File:   sparsematrixfloat.hpp                                          */
+/* Date:   17. Oct. 2026                                                  */
+/**************************************************************************/
+
+namespace ngla
+{
+
+  /**
+     Single precision copy of a real sparse matrix.
+
+     Values are stored as float, products are accumulated in double, so
+     a matrix-vector product streams 8 (float value + column index)
+     instead of 12 bytes per stored non-zero. Meant for preconditioners
+     and inner solvers, where the reduced accuracy of the entries does
+     not matter.
+
+     Symmetric matrices keep the lower triangle of the original graph,
+     products and smoothers use the transposed row like
+     SparseMatrixSymmetric, so they stream the same number of stored
+     non-zeros as the double version.
+  */
+  class NGS_DLL_HEADER SparseMatrixFloat : public BaseSparseMatrix,
+                                           public S_BaseMatrix<double>
+  {
+    shared_ptr<SparseMatrixTM<double>> mat;
+    bool symmetric;
+    NumaDistributedArray<float> data;
+
+  public:
+    SparseMatrixFloat (shared_ptr<SparseMatrixTM<double>> amat);
+    virtual ~SparseMatrixFloat ();
+
+    int Height() const { return size; }
+    int Width() const { return width; }
+    virtual int VHeight() const override { return size; }
+    virtual int VWidth() const override { return width; }
+    /// only the lower triangle is stored
+    bool IsSymmetric() const { return symmetric; }
+
+    virtual AutoVector CreateVector () const override;
+    virtual AutoVector CreateRowVector () const override;
+    virtual AutoVector CreateColVector () const override;
+
+    FlatVector<float> GetRowValues (int i) const
+    { return FlatVector<float> (firsti[i+1]-firsti[i], &data[firsti[i]]); }
+
+    double operator() (int row, int col) const
+    {
+      if (symmetric && col > row) swap (row, col);
+      size_t pos = GetPositionTest (row, col);
+      return (pos != numeric_limits<size_t>::max()) ? data[pos] : 0.0;
+    }
+
+    double RowTimesVector (int row, FlatVector<double> vec) const
+    {
+      size_t last = firsti[row+1];
+      double sum = 0;
+      for (size_t j = firsti[row]; j < last; j++)
+        sum += double(data[j]) * vec(colnr[j]);
+      return sum;
+    }
+
+    double RowTimesVectorNoDiag (int row, FlatVector<double> vec) const
+    {
+      size_t first = firsti[row];
+      size_t last = firsti[row+1];
+      if (last == first) return 0;
+      if (colnr[last-1] == row) last--;
+
+      double sum = 0;
+      for (size_t j = first; j < last; j++)
+        sum += double(data[j]) * vec(colnr[j]);
+      return sum;
+    }
+
+    void AddRowTransToVector (int row, double el, FlatVector<double> vec) const
+    {
+      size_t last = firsti[row+1];
+      for (size_t j = firsti[row]; j < last; j++)
+        vec(colnr[j]) += el * double(data[j]);
+    }
+
+    void AddRowTransToVectorNoDiag (int row, double el, FlatVector<double> vec) const
+    {
+      size_t first = firsti[row];
+      size_t last = firsti[row+1];
+      if (last == first) return;
+      if (colnr[last-1] == row) last--;
+
+      for (size_t j = first; j < last; j++)
+        vec(colnr[j]) += el * double(data[j]);
+    }
+
+    virtual void Mult (const BaseVector & x, BaseVector & y) const override;
+    virtual void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    virtual void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    /// copy values again from the original matrix (graph unchanged)
+    void UpdateValues ();
+    virtual void Update() override { UpdateValues(); }
+
+    virtual shared_ptr<BaseJacobiPrecond>
+      CreateJacobiPrecond (shared_ptr<BitArray> inner = nullptr) const override;
+
+    virtual shared_ptr<BaseBlockJacobiPrecond>
+      CreateBlockJacobiPrecond (shared_ptr<Table<int>> blocks,
+                                const BaseVector * constraint = 0,
+                                bool parallel  = 1,
+                                shared_ptr<BitArray> freedofs = NULL) const override;
+
+    virtual size_t NZE () const override { return nze; }
+    virtual Array<MemoryUsage> GetMemoryUsage () const override;
+    virtual ostream & Print (ostream & ost) const override;
+
+    /// compares double and float matrix-vector products
+    list<tuple<string,double>> Timing () const;
+  };
+
+}
+
+#endif
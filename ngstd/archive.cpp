@@ -6,6 +6,17 @@
 
 #include <ngstd.hpp>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
 
 namespace ngstd
 {
@@ -371,5 +382,292 @@ namespace ngstd
     return *this;
   }
 
-  
+
+
+  /* ******************* CheckpointOutArchive ******************* */
+
+  static const char checkpoint_magic[8] = { 'N','G','S','C','H','K','P','T' };
+
+  CheckpointOutArchive :: CheckpointOutArchive (string filename, bool acompress,
+                                                size_t abulk_size)
+    : CheckpointArchive(true), compress(acompress), bulk_size(abulk_size)
+  {
+    file = fopen (filename.c_str(), "wb");
+    if (!file)
+      throw Exception ("CheckpointOutArchive: cannot open " + filename);
+#ifndef USE_ZLIB
+    if (compress)
+      cout << IM(3) << "CheckpointOutArchive: compiled without zlib, not compressing" << endl;
+    compress = false;
+#endif
+
+    // header is written again by Finish, when the toc is known
+    Header header = { };
+    fwrite (&header, sizeof(header), 1, file);
+    pos = sizeof(header);
+  }
+
+  CheckpointOutArchive :: ~CheckpointOutArchive ()
+  {
+    Finish();
+  }
+
+  Archive & CheckpointOutArchive :: operator & (string & str)
+  {
+    size_t len = str.length();
+    Put (len);
+    PutBytes (str.data(), len);
+    return *this;
+  }
+
+  Archive & CheckpointOutArchive :: operator & (char *& str)
+  {
+    size_t len = strlen (str);
+    Put (len);
+    PutBytes (str, len);
+    return *this;
+  }
+
+  void CheckpointOutArchive :: FlushStream ()
+  {
+    if (stream.Size() == 0) return;
+    WriteChunk (STREAM, &stream[0], stream.Size(), 1);
+    stream.SetSize0();
+  }
+
+  void CheckpointOutArchive :: WriteChunk (CHUNK_TYPE type, const void * p,
+                                           size_t n, size_t elsize)
+  {
+    static Timer t("CheckpointOutArchive::WriteChunk"); RegionTimer reg(t);
+    if (!file)
+      throw Exception ("CheckpointOutArchive: archive already finished");
+
+    // keep the order of data in the file
+    if (type == BULK) FlushStream();
+
+    ChunkInfo info = { };
+    info.type = type;
+    info.size = n;
+    info.stored_size = n;
+    info.elsize = elsize;
+    info.compression = COMPRESS_NONE;
+
+    const char * out = (const char*)p;
+#ifdef USE_ZLIB
+    Array<char> compressed;
+    if (compress && n > 0)
+      {
+        uLongf csize = compressBound (n);
+        compressed.SetSize (csize);
+        if (compress2 ((Bytef*)&compressed[0], &csize, (const Bytef*)p, n, Z_BEST_SPEED) == Z_OK
+            && csize < n)
+          {
+            out = &compressed[0];
+            info.stored_size = csize;
+            info.compression = COMPRESS_ZLIB;
+          }
+      }
+#endif
+
+    // uncompressed bulk data is page aligned, to use it from the mapped file
+    if (type == BULK && info.compression == COMPRESS_NONE)
+      {
+        size_t aligned = (pos + ALIGNMENT-1) / ALIGNMENT * ALIGNMENT;
+        static const char zeros[ALIGNMENT] = { };
+        fwrite (zeros, 1, aligned-pos, file);
+        pos = aligned;
+      }
+
+    info.offset = pos;
+    if (fwrite (out, 1, info.stored_size, file) != info.stored_size)
+      throw Exception ("CheckpointOutArchive: write error");
+    pos += info.stored_size;
+    toc.Append (info);
+  }
+
+  void CheckpointOutArchive :: Finish ()
+  {
+    if (!file) return;
+    FlushStream();
+
+    Header header = { };
+    memcpy (header.magic, checkpoint_magic, 8);
+    header.version = VERSION;
+    header.flags = compress ? 1 : 0;
+    header.toc_offset = pos;
+    header.nchunks = toc.Size();
+
+    if (toc.Size())
+      fwrite (&toc[0], sizeof(ChunkInfo), toc.Size(), file);
+    fseek (file, 0, SEEK_SET);
+    fwrite (&header, sizeof(header), 1, file);
+    fclose (file);
+    file = nullptr;
+  }
+
+
+
+  /* ******************* CheckpointInArchive ******************* */
+
+  CheckpointInArchive :: MappedFile :: MappedFile (string filename)
+  {
+#ifndef WIN32
+    int fd = open (filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw Exception ("CheckpointInArchive: cannot open " + filename);
+    struct stat st;
+    fstat (fd, &st);
+    size = st.st_size;
+    if (size > 0)
+      {
+        void * p = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+          {
+            close (fd);
+            throw Exception ("CheckpointInArchive: cannot map " + filename);
+          }
+        mem = (char*)p;
+      }
+    close (fd);
+#else
+    ifstream in(filename, ios::binary | ios::ate);
+    if (!in)
+      throw Exception ("CheckpointInArchive: cannot open " + filename);
+    size = in.tellg();
+    mem = new char[size];
+    in.seekg (0);
+    in.read (mem, size);
+#endif
+  }
+
+  CheckpointInArchive :: MappedFile :: ~MappedFile ()
+  {
+#ifndef WIN32
+    if (mem) munmap (mem, size);
+#else
+    delete [] mem;
+#endif
+  }
+
+
+  CheckpointInArchive :: CheckpointInArchive (string filename)
+    : CheckpointArchive(false), file(filename)
+  {
+    if (file.size < sizeof(Header))
+      throw Exception ("CheckpointInArchive: " + filename + " is not a checkpoint file");
+    memcpy (&header, file.mem, sizeof(Header));
+    if (memcmp (header.magic, checkpoint_magic, 8) != 0)
+      throw Exception ("CheckpointInArchive: " + filename + " is not a checkpoint file");
+    if (header.version > VERSION)
+      throw Exception ("CheckpointInArchive: " + filename + " has version " + ToString(header.version)
+                       + ", supported up to version " + ToString(int(VERSION)));
+    if (header.toc_offset + header.nchunks*sizeof(ChunkInfo) > file.size)
+      throw Exception ("CheckpointInArchive: " + filename + " is truncated");
+
+    toc.SetSize (header.nchunks);
+    if (toc.Size())
+      memcpy (&toc[0], file.mem+header.toc_offset, toc.Size()*sizeof(ChunkInfo));
+  }
+
+  CheckpointInArchive :: ~CheckpointInArchive ()
+  { ; }
+
+  const char * CheckpointInArchive :: LoadChunk (size_t nr)
+  {
+    const ChunkInfo & info = toc[nr];
+    if (info.offset + info.stored_size > file.size)
+      throw Exception ("CheckpointInArchive: chunk exceeds file");
+
+    switch (info.compression)
+      {
+      case COMPRESS_NONE:
+        return file.mem + info.offset;
+#ifdef USE_ZLIB
+      case COMPRESS_ZLIB:
+        {
+          static Timer t("CheckpointInArchive::Uncompress"); RegionTimer reg(t);
+          uncompressed.push_back (unique_ptr<char[]> (new char[info.size]));
+          uLongf size = info.size;
+          if (uncompress ((Bytef*)uncompressed.back().get(), &size,
+                          (const Bytef*)file.mem + info.offset, info.stored_size) != Z_OK
+              || size != info.size)
+            throw Exception ("CheckpointInArchive: corrupt compressed chunk");
+          return uncompressed.back().get();
+        }
+#endif
+      default:
+        throw Exception ("CheckpointInArchive: unsupported compression "
+                         + ToString(info.compression));
+      }
+  }
+
+  const char * CheckpointInArchive :: GetBytes (size_t n, size_t elsize)
+  {
+    if (n == 0) return data;
+    if (pos == size && chunk < toc.Size())
+      {
+        if (toc[chunk].type == BULK)
+          {
+            if (elsize == 0 || toc[chunk].size != n || toc[chunk].elsize != elsize)
+              throw Exception ("CheckpointInArchive: data does not match archive");
+            return LoadChunk (chunk++);
+          }
+        data = LoadChunk (chunk);
+        size = toc[chunk].size;
+        pos = 0;
+        chunk++;
+      }
+    if (pos+n > size)
+      throw Exception ("CheckpointInArchive: read beyond end of archive");
+
+    const char * p = data+pos;
+    pos += n;
+    return p;
+  }
+
+  Archive & CheckpointInArchive :: operator & (string & str)
+  {
+    size_t len;
+    Get (len);
+    str.assign (GetBytes (len, 0), len);
+    return *this;
+  }
+
+  Archive & CheckpointInArchive :: operator & (char *& str)
+  {
+    size_t len;
+    Get (len);
+    str = new char[len+1];
+    memcpy (str, GetBytes (len, 0), len);
+    str[len] = '\0';
+    return *this;
+  }
+
+  template <typename T>
+  Archive & CheckpointInArchive :: DoBulk (T * p, size_t n)
+  {
+    if (n == 0) return *this;
+    size_t bytes = n*sizeof(T);
+    const char * src = GetBytes (bytes, sizeof(T));
+
+    // pages of the mapped file are touched in parallel
+    size_t npages = (bytes+ALIGNMENT-1) / ALIGNMENT;
+    ParallelForRange (npages, [&] (IntRange r)
+                      {
+                        size_t first = r.First()*ALIGNMENT;
+                        size_t next = min2(r.Next()*ALIGNMENT, bytes);
+                        memcpy ((char*)p+first, src+first, next-first);
+                      });
+    return *this;
+  }
+
+  Archive & CheckpointInArchive :: Do (double * d, size_t n) { return DoBulk (d, n); }
+  Archive & CheckpointInArchive :: Do (int * i, size_t n) { return DoBulk (i, n); }
+  Archive & CheckpointInArchive :: Do (long * i, size_t n) { return DoBulk (i, n); }
+  Archive & CheckpointInArchive :: Do (size_t * i, size_t n) { return DoBulk (i, n); }
+  Archive & CheckpointInArchive :: Do (short * i, size_t n) { return DoBulk (i, n); }
+  Archive & CheckpointInArchive :: Do (unsigned char * i, size_t n) { return DoBulk (i, n); }
+  Archive & CheckpointInArchive :: Do (bool * b, size_t n) { return DoBulk (b, n); }
+
+
 }
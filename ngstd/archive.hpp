@@ -108,6 +108,172 @@ namespace ngstd
 
 
 
+  /*
+    Checkpoint file format:
+
+    header | chunk | chunk | ... | table of contents
+
+    Scalars and small arrays are collected in stream chunks, large
+    arrays get bulk chunks of their own, aligned to pages such that
+    they can be used directly from the memory mapped file.  Every chunk
+    may be compressed (if compiled with zlib).
+  */
+  class NGS_DLL_HEADER CheckpointArchive : public Archive
+  {
+  public:
+    enum { VERSION = 1 };
+    enum { ALIGNMENT = 4096 };
+    enum CHUNK_TYPE { STREAM = 0, BULK = 1 };
+    enum { COMPRESS_NONE = 0, COMPRESS_ZLIB = 1 };
+
+    struct Header
+    {
+      char magic[8];       // "NGSCHKPT"
+      uint32_t version;
+      uint32_t flags;
+      uint64_t toc_offset;
+      uint64_t nchunks;
+      uint64_t reserved[4];
+    };
+
+    struct ChunkInfo
+    {
+      uint64_t offset;       // position in file
+      uint64_t stored_size;  // bytes in file, maybe compressed
+      uint64_t size;         // bytes uncompressed
+      uint32_t type;         // STREAM or BULK
+      uint32_t compression;
+      uint32_t elsize;       // size of array elements
+      uint32_t reserved;
+    };
+
+    CheckpointArchive (bool ais_output) : Archive(ais_output) { ; }
+  };
+
+
+  class NGS_DLL_HEADER CheckpointOutArchive : public CheckpointArchive
+  {
+    FILE * file;
+    bool compress;
+    size_t bulk_size;     // arrays with at least that many bytes get bulk chunks
+    size_t pos;           // current position in file
+    Array<char> stream;
+    Array<ChunkInfo> toc;
+  public:
+    CheckpointOutArchive (string filename, bool acompress = false,
+                          size_t abulk_size = 1<<16);
+    virtual ~CheckpointOutArchive ();
+
+    using Archive::operator&;
+    virtual Archive & operator & (double & d) { return Put(d); }
+    virtual Archive & operator & (int & i) { return Put(i); }
+    virtual Archive & operator & (short & i) { return Put(i); }
+    virtual Archive & operator & (long & i) { return Put(i); }
+    virtual Archive & operator & (size_t & i) { return Put(i); }
+    virtual Archive & operator & (unsigned char & i) { return Put(i); }
+    virtual Archive & operator & (bool & b) { return Put(b); }
+    virtual Archive & operator & (string & str);
+    virtual Archive & operator & (char *& str);
+
+    virtual Archive & Do (double * d, size_t n) { return DoBulk(d, n); }
+    virtual Archive & Do (int * i, size_t n) { return DoBulk(i, n); }
+    virtual Archive & Do (long * i, size_t n) { return DoBulk(i, n); }
+    virtual Archive & Do (size_t * i, size_t n) { return DoBulk(i, n); }
+    virtual Archive & Do (short * i, size_t n) { return DoBulk(i, n); }
+    virtual Archive & Do (unsigned char * i, size_t n) { return DoBulk(i, n); }
+    virtual Archive & Do (bool * b, size_t n) { return DoBulk(b, n); }
+
+    /// writes pending data and the table of contents, called by the destructor
+    void Finish ();
+
+  private:
+    template <typename T>
+    Archive & Put (T x)
+    {
+      PutBytes (&x, sizeof(T));
+      return *this;
+    }
+    void PutBytes (const void * p, size_t n)
+    {
+      size_t old = stream.Size();
+      stream.SetSize (old+n);
+      memcpy (&stream[old], p, n);
+    }
+
+    template <typename T>
+    Archive & DoBulk (T * p, size_t n)
+    {
+      if (n*sizeof(T) < bulk_size)
+        PutBytes (p, n*sizeof(T));
+      else
+        WriteChunk (BULK, p, n*sizeof(T), sizeof(T));
+      return *this;
+    }
+    void FlushStream ();
+    void WriteChunk (CHUNK_TYPE type, const void * p, size_t n, size_t elsize);
+  };
+
+
+  class NGS_DLL_HEADER CheckpointInArchive : public CheckpointArchive
+  {
+    // the whole file, memory mapped, released also if the constructor throws
+    class MappedFile
+    {
+    public:
+      char * mem = nullptr;
+      size_t size = 0;
+      MappedFile (string filename);
+      ~MappedFile ();
+      MappedFile (const MappedFile &) = delete;
+      MappedFile & operator= (const MappedFile &) = delete;
+    };
+    MappedFile file;
+    Header header;
+    Array<ChunkInfo> toc;
+    size_t chunk = 0;       // next chunk to read
+    const char * data = nullptr;   // current stream chunk, uncompressed
+    size_t size = 0, pos = 0;
+    std::vector<unique_ptr<char[]>> uncompressed;
+  public:
+    CheckpointInArchive (string filename);
+    virtual ~CheckpointInArchive ();
+
+    int Version() const { return header.version; }
+
+    using Archive::operator&;
+    virtual Archive & operator & (double & d) { return Get(d); }
+    virtual Archive & operator & (int & i) { return Get(i); }
+    virtual Archive & operator & (short & i) { return Get(i); }
+    virtual Archive & operator & (long & i) { return Get(i); }
+    virtual Archive & operator & (size_t & i) { return Get(i); }
+    virtual Archive & operator & (unsigned char & i) { return Get(i); }
+    virtual Archive & operator & (bool & b) { return Get(b); }
+    virtual Archive & operator & (string & str);
+    virtual Archive & operator & (char *& str);
+
+    virtual Archive & Do (double * d, size_t n);
+    virtual Archive & Do (int * i, size_t n);
+    virtual Archive & Do (long * i, size_t n);
+    virtual Archive & Do (size_t * i, size_t n);
+    virtual Archive & Do (short * i, size_t n);
+    virtual Archive & Do (unsigned char * i, size_t n);
+    virtual Archive & Do (bool * b, size_t n);
+
+  private:
+    template <typename T>
+    Archive & Get (T & x)
+    {
+      memcpy (&x, GetBytes (sizeof(T), 0), sizeof(T));
+      return *this;
+    }
+    template <typename T>
+    Archive & DoBulk (T * p, size_t n);
+    // next n bytes, from a bulk chunk if elsize > 0 and there is one
+    const char * GetBytes (size_t n, size_t elsize);
+    const char * LoadChunk (size_t nr);
+  };
+
+
 
 
 
@@ -40,6 +40,122 @@ namespace ngstd
     return LocalHeap (p + i * size_of_piece, size_of_piece, name);
   }
 
+  /**
+     Chunks released by the heaps of one thread.  They are reused before
+     new memory is touched, no locking is needed.
+  */
+  class LocalHeapChunkPool
+  {
+    LocalHeapChunk * first = nullptr;
+    int cnt = 0;
+  public:
+    enum { MAXCHUNKS = 16 };
+    static thread_local bool destroyed;
+
+    ~LocalHeapChunkPool ()
+    {
+      while (first)
+        {
+          LocalHeapChunk * prev = first->prev;
+          delete [] (char*)first;
+          first = prev;
+        }
+      destroyed = true;
+    }
+
+    /// the smallest pooled chunk of at least minsize bytes
+    LocalHeapChunk * Get (size_t minsize)
+    {
+      LocalHeapChunk ** best = nullptr;
+      for (LocalHeapChunk ** pc = &first; *pc; pc = &(*pc)->prev)
+        if ((*pc)->size >= minsize && (!best || (*pc)->size < (*best)->size))
+          best = pc;
+      if (!best) return nullptr;
+      LocalHeapChunk * c = *best;
+      *best = c->prev;
+      cnt--;
+      return c;
+    }
+
+    void Put (LocalHeapChunk * c)
+    {
+      if (cnt >= MAXCHUNKS)
+        {
+          delete [] (char*)c;
+          return;
+        }
+      c->prev = first;
+      first = c;
+      cnt++;
+    }
+  };
+
+  thread_local bool LocalHeapChunkPool :: destroyed = false;
+  static thread_local LocalHeapChunkPool chunkpool;
+
+
+  void * LocalHeap :: AllocChunk (char * oldp, size_t size)
+  {
+    p = oldp;
+
+    // chunks grow geometrically, starting at 1 MB
+    size_t minsize = sizeof(LocalHeapChunk) + size + 2*ALIGN;
+    size_t chunksize = max2 (minsize, min2 (max2 (2*totsize, size_t(1) << 20),
+                                            size_t(1) << 28));
+
+    LocalHeapChunk * c = LocalHeapChunkPool::destroyed ? nullptr : chunkpool.Get (minsize);
+    if (!c)
+      {
+        char * mem;
+        try
+          {
+            mem = new char[chunksize];
+          }
+        catch (bad_alloc &)
+          {
+            ThrowException();
+          }
+        // first touch by the allocating thread places the pages on its NUMA node
+        for (size_t i = 0; i < chunksize; i += 4096)
+          mem[i] = 0;
+        c = reinterpret_cast<LocalHeapChunk*> (mem);
+        c->size = chunksize;
+      }
+
+    c->prev = chunk;
+    c->prevdata = data;
+    c->prevnext = next;
+    c->prevtotsize = totsize;
+    chunk = c;
+
+    data = reinterpret_cast<char*> (c+1);
+    totsize = c->size - sizeof(LocalHeapChunk);
+    next = data + totsize;
+    p = data + (ALIGN - (size_t(data) & (ALIGN-1)));
+
+    char * newp = p;
+    p += size;
+    return newp;
+  }
+
+  void LocalHeap :: ReleaseChunks (char * addr)
+  {
+    while (chunk && (addr == nullptr || addr < data || addr > next))
+      {
+        LocalHeapChunk * c = chunk;
+        data = c->prevdata;
+        next = c->prevnext;
+        totsize = c->prevtotsize;
+        chunk = c->prev;
+        if (LocalHeapChunkPool::destroyed)
+          delete [] (char*)c;
+        else
+          chunkpool.Put (c);
+      }
+    p = addr ? addr : data;
+  }
+
+
   void LocalHeap :: ThrowException() // throw (LocalHeapOverflow)
   {
     /*
@@ -35,12 +35,31 @@ namespace ngstd
  
 
 
+  /**
+     Header of a memory chunk chained to a LocalHeap.
+     Stores the block below, which is restored when the chunk is released.
+  */
+  struct LocalHeapChunk
+  {
+    LocalHeapChunk * prev;
+    char * prevdata;
+    char * prevnext;
+    size_t prevtotsize;
+    /// bytes of the chunk, including the header
+    size_t size;
+  };
+
+
   /**
      Optimized memory handler.
      One block of data is organized as stack memory. 
      One can allocate memory out of it. This increases the stack pointer.
      With \Ref{CleanUp}, the pointer is reset to the beginning or to a
      specific position. 
+
+     If the block is exhausted, further chunks are chained on demand.
+     They are allocated and first touched by the allocating thread, and
+     returned to a pool of that thread when the heap is reset below them.
   */
   class LocalHeap : public Allocator
   {
@@ -48,6 +67,8 @@ namespace ngstd
     char * next;
     char * p;
     size_t totsize;
+    /// current chunk, nullptr for the initial block
+    LocalHeapChunk * chunk = nullptr;
   public:
     bool owner;
     const char * name;
@@ -89,11 +110,12 @@ namespace ngstd
     INLINE LocalHeap (const LocalHeap & lh2) = delete;
 
     INLINE LocalHeap (LocalHeap && lh2)
-      : data(lh2.data), p(lh2.p), totsize(lh2.totsize), owner(lh2.owner),
-        name(lh2.name)
+      : data(lh2.data), p(lh2.p), totsize(lh2.totsize), chunk(lh2.chunk),
+        owner(lh2.owner), name(lh2.name)
     {
       next = data + totsize;
       lh2.owner = false;
+      lh2.chunk = nullptr;
     }
     
     INLINE LocalHeap Borrow() 
@@ -104,17 +126,21 @@ namespace ngstd
 
     INLINE LocalHeap & operator= (LocalHeap && lh2)
     {
+      if (chunk)
+        ReleaseChunks (nullptr);
       if (owner)
         delete [] data;
       
       data = lh2.data;
       p = lh2.p;
       totsize = lh2.totsize;
+      chunk = lh2.chunk;
       owner = lh2.owner;
       name = lh2.name;
 
       next = data + totsize;
       lh2.owner = false;
+      lh2.chunk = nullptr;
       return *this;
     }
 
@@ -125,6 +151,8 @@ namespace ngstd
     /// free memory
     INLINE virtual ~LocalHeap ()
     {
+      if (chunk)
+        ReleaseChunks (nullptr);
       if (owner)
 	delete [] data;
     }
@@ -132,6 +160,8 @@ namespace ngstd
     /// delete all memory on local heap
     INLINE void CleanUp() throw ()
     {
+      if (unlikely(chunk != nullptr))
+        ReleaseChunks (nullptr);
       p = data;
       // p += (16 - (long(p) & 15) );
       p += (ALIGN - (size_t(p) & (ALIGN-1) ) );
@@ -146,6 +176,8 @@ namespace ngstd
     /// deletes memory back to heap-pointer
     INLINE void CleanUp (void * addr) throw ()
     {
+      if (unlikely(chunk != nullptr) && (addr < data || addr > next))
+        ReleaseChunks ((char*)addr);
       p = (char*)addr;
     }
 
@@ -160,8 +192,8 @@ namespace ngstd
 
       // if ( size_t(p - data) >= totsize )
 #ifndef FULLSPEED
-      if (likely(p >= next))
-        ThrowException();
+      if (unlikely(p >= next))
+        return AllocChunk (oldp, size);
 #endif
       return oldp;
     }
@@ -178,8 +210,8 @@ namespace ngstd
       p += size;
 
 #ifndef FULLSPEED
-      if (likely(p >= next))
-	ThrowException();
+      if (unlikely(p >= next))
+	return reinterpret_cast<T*> (AllocChunk (oldp, size));
 #endif
 
       return reinterpret_cast<T*> (oldp);
@@ -189,8 +221,14 @@ namespace ngstd
     ///
 #ifndef __CUDA_ARCH__
     [[noreturn]] NGS_DLL_HEADER void ThrowException(); 
+    /// chains a new chunk and allocates size bytes from it
+    NGS_DLL_HEADER void * AllocChunk (char * oldp, size_t size);
+    /// releases chunks until addr is in the current block, all for nullptr
+    NGS_DLL_HEADER void ReleaseChunks (char * addr);
 #else
     INLINE void ThrowException() { ; }
+    INLINE void * AllocChunk (char * oldp, size_t size) { return oldp; }
+    INLINE void ReleaseChunks (char * addr) { ; }
 #endif
 
   public:
@@ -200,7 +238,7 @@ namespace ngstd
       ;
     }
 
-    /// available memory on LocalHeap
+    /// available memory in the current block, more is chained on demand
     INLINE size_t Available () const throw () { return (totsize - (p-data)); }
 
     /// Split free memory on heap into pieces for each thread
@@ -278,6 +278,23 @@ namespace ngstd
     return global_d;
   }
   
+  /// non-blocking all-reduce, the result is valid after MyMPI_Wait
+  template <typename T, NGSMPI_ENABLE_FOR_STD>
+  INLINE MPI_Request MyMPI_IAllReduce (FlatArray<T> d, FlatArray<T> global_d,
+                                       const MPI_Op & op = MPI_SUM, MPI_Comm comm = ngs_comm)
+  {
+    MPI_Request request;
+    MPI_Iallreduce (&d[0], &global_d[0], d.Size(), MyGetMPIType<T>(), op, comm, &request);
+    return request;
+  }
+
+  INLINE void MyMPI_Wait (MPI_Request & request)
+  {
+    static Timer t("dummy - wait");
+    RegionTimer r(t);
+    MPI_Wait (&request, MPI_STATUS_IGNORE);
+  }
+  
   template <typename T, NGSMPI_ENABLE_FOR_STD>
   INLINE void MyMPI_Gather (T d, FlatArray<T> recv = FlatArray<T>(0, NULL),
 			    MPI_Comm comm = ngs_comm, int root = 0)
@@ -146,6 +146,7 @@ namespace ngstd
 #include "xbool.hpp"
 
 #include "table.hpp"
+#include "taskgraph.hpp"
 #include "symboltable.hpp"
 #include "hashtable.hpp"
 #include "bitarray.hpp"
@@ -19,6 +19,18 @@ namespace ngstd
   // increases trace by a factor of two
   bool PajeTrace::trace_thread_counter = true;
   bool PajeTrace::trace_threads = true;
+  bool PajeTrace::ring_buffer = false;
+  bool PajeTrace::chrome_format = false;
+
+  void PajeTrace::SetTraceFormat( std::string format )
+    {
+      if(format == "chrome")
+        chrome_format = true;
+      else if(format == "paje")
+        chrome_format = false;
+      else
+        throw Exception("PajeTrace: unknown trace format " + format);
+    }
 
   string Demangle(string mangled_name)
   {
@@ -38,6 +50,10 @@ namespace ngstd
   PajeTrace :: PajeTrace(int anthreads, std::string aname)
   {
     start_time = GetTime();
+    start_steady = std::chrono::steady_clock::now();
+    // the system clock epoch is the unix epoch, the same on all ranks
+    start_epoch_us = std::chrono::duration<double, std::micro>
+      (std::chrono::system_clock::now().time_since_epoch()).count();
     
     nthreads = anthreads;
     tracefile_name = aname;
@@ -65,6 +81,10 @@ namespace ngstd
     links.resize(nthreads);
     for(auto & l : links)
       l.reserve(reserve_size);
+
+    task_count.assign(nthreads, 0);
+    link_count.assign(nthreads, 0);
+    task_seq.assign(nthreads, 0);
     
     jobs.reserve(reserve_size);
     timer_events.reserve(reserve_size);
@@ -72,13 +92,6 @@ namespace ngstd
     tracing_enabled = true;
   }
   
-  PajeTrace :: ~PajeTrace()
-  {
-    if(tracefile_name.size()>0)
-      Write(tracefile_name);
-  }
-  
-  
   void PajeTrace::StopTracing()
     {
       if(tracing_enabled && max_num_events_per_thread>0)
@@ -90,6 +103,132 @@ namespace ngstd
     }
 
   using std::string;
+
+  void JSONString (ostream & ost, const string & str)
+  {
+    ost << '"';
+    for (char c : str)
+      switch (c)
+        {
+        case '"': ost << "\\\""; break;
+        case '\\': ost << "\\\\"; break;
+        case '\n': ost << "\\n"; break;
+        case '\t': ost << "\\t"; break;
+        default:
+          if ((unsigned char)(c) < 0x20)
+            {
+              char buf[8];
+              snprintf (buf, sizeof(buf), "\\u%04x", int(c));
+              ost << buf;
+            }
+          else
+            ost << c;
+        }
+    ost << '"';
+  }
+
+  ChromeTraceWriter :: ChromeTraceWriter (ostream & aost, int apid)
+    : ost(aost), pid(apid)
+  {
+    ost << "{\"traceEvents\": [\n";
+  }
+
+  ChromeTraceWriter :: ~ChromeTraceWriter ()
+  {
+    ost << "\n], \"displayTimeUnit\": \"ms\"}" << endl;
+  }
+
+  void ChromeTraceWriter :: Begin (const string & name, char ph, int tid, double ts)
+  {
+    char buf[100];
+    ost << (first ? "" : ",\n") << "{\"name\": ";
+    JSONString (ost, name);
+    snprintf (buf, sizeof(buf), ", \"ph\": \"%c\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f", ph, pid, tid, ts);
+    ost << buf;
+    first = false;
+  }
+
+  void ChromeTraceWriter :: Metadata (int tid, string name, string value)
+  {
+    bool index = name.find("sort_index") != string::npos;
+    ost << (first ? "" : ",\n") << "{\"name\": \"" << name << "\", \"ph\": \"M\", \"pid\": " << pid;
+    if (tid >= 0)
+      ost << ", \"tid\": " << tid;
+    ost << ", \"args\": {\"" << (index ? "sort_index" : "name") << "\": ";
+    if (index)
+      ost << value;
+    else
+      JSONString (ost, value);
+    ost << "}}";
+    first = false;
+  }
+
+  void ChromeTraceWriter :: Complete (const string & name, const char * cat, int tid, double ts, double dur,
+                                      int id, int value)
+  {
+    char buf[100];
+    Begin (name, 'X', tid, ts);
+    snprintf (buf, sizeof(buf), ", \"dur\": %.3f, \"cat\": \"%s\"", dur, cat);
+    ost << buf;
+    if (id >= 0 || value >= 0)
+      ost << ", \"args\": {\"id\": " << id << ", \"value\": " << value << "}";
+    ost << "}";
+  }
+
+  void ChromeTraceWriter :: Duration (const string & name, bool start, int tid, double ts)
+  {
+    Begin (name, start ? 'B' : 'E', tid, ts);
+    ost << ", \"cat\": \"timer\"}";
+  }
+
+  void ChromeTraceWriter :: Counter (const string & name, double ts, double value)
+  {
+    char buf[100];
+    Begin (name, 'C', 0, ts);
+    snprintf (buf, sizeof(buf), ", \"args\": {\"value\": %g}}", value);
+    ost << buf;
+  }
+
+  void ChromeTraceWriter :: Flow (bool start, int tid, double ts, size_t id)
+  {
+    Begin ("link", start ? 's' : 'f', tid, ts);
+    ost << ", \"cat\": \"link\", \"id\": " << id << (start ? "" : ", \"bp\": \"e\"") << "}";
+  }
+
+
+  // trace file of one MPI rank, written by PajeTrace::Flush
+  class ChromeTraceFile
+    {
+      ofstream file;
+    public:
+      ChromeTraceWriter writer;
+      bool names_written = false;
+
+      ChromeTraceFile( string filename, int pid )
+        : file(filename), writer(Opened(file, filename), pid)
+        {
+          writer.Metadata(-1, "process_name", "rank " + ToString(pid));
+          writer.Metadata(-1, "process_sort_index", ToString(pid));
+        }
+
+    private:
+      static ostream & Opened( ofstream & file, string filename )
+        {
+          if(!file)
+            throw Exception("PajeTrace: cannot open " + filename);
+          return file;
+        }
+    };
+
+
+  PajeTrace :: ~PajeTrace()
+  {
+    if(tracefile_name.size()>0)
+      Write(tracefile_name);
+    delete chrome;
+  }
+
+
   class PajeFile
     {
     public:
@@ -362,6 +501,184 @@ namespace ngstd
 
   NGS_DLL_HEADER PajeTrace *trace;
 
+  void PajeTrace::Unwrap()
+    {
+      auto rotate = [] (auto * data, size_t size, size_t count)
+        {
+          if(count > size)
+            std::rotate(data, data + count % size, data + size);
+        };
+      rotate(jobs.data(), jobs.size(), job_count);
+      rotate(timer_events.data(), timer_events.size(), timer_count);
+      for(int i = 0; i < nthreads; i++)
+        {
+          rotate(tasks[i]+0, tasks[i].Size(), task_count[i]);
+          rotate(links[i].data(), links[i].size(), link_count[i]);
+        }
+      job_count = jobs.size();
+      timer_count = timer_events.size();
+      for(int i = 0; i < nthreads; i++)
+        {
+          task_count[i] = tasks[i].Size();
+          link_count[i] = links[i].size();
+        }
+      current_job = -1;
+    }
+
+  void PajeTrace::Clear()
+    {
+      jobs.clear();
+      timer_events.clear();
+      for(int i = 0; i < nthreads; i++)
+        {
+          tasks[i].SetSize0();
+          links[i].clear();
+          task_count[i] = link_count[i] = 0;
+        }
+      job_count = timer_count = 0;
+      current_job = -1;
+    }
+
+  void PajeTrace::Flush()
+    {
+      if(!chrome_format || tracefile_name.size() == 0) return;
+      if(!chrome)
+        chrome = new ChromeTraceFile(tracefile_name, MyMPI_GetId());
+      Unwrap();
+      WriteChromeEvents();
+      Clear();
+      chrome->writer.Flush();
+    }
+
+  void PajeTrace::WriteChromeEvents()
+    {
+      // time stamps in microseconds since the unix epoch
+      size_t ticks = GetTime() - start_time;
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_steady).count();
+      double us_per_tick = ticks ? 1e6 * seconds / ticks : 0;
+      auto ts = [&] (TTimePoint t) { return start_epoch_us + (double(t) - double(start_time)) * us_per_tick; };
+      ChromeTraceWriter & writer = chrome->writer;
+      auto dur = [&] (TTimePoint t0, TTimePoint t1) { return t1 > t0 ? (t1-t0) * us_per_tick : 0.0; };
+
+      // thread tracks, followed by the tracks of jobs and timers
+      const int tid_jobs = nthreads;
+      const int tid_timers = nthreads+1;
+      if(!chrome->names_written)
+        {
+          for(int i = 0; i < nthreads; i++)
+            {
+              writer.Metadata(i, "thread_name", "Thread " + ToString(i));
+              writer.Metadata(i, "thread_sort_index", ToString(i));
+            }
+          writer.Metadata(tid_jobs, "thread_name", "Jobs");
+          writer.Metadata(tid_jobs, "thread_sort_index", "-2");
+          writer.Metadata(tid_timers, "thread_name", "Timers");
+          writer.Metadata(tid_timers, "thread_sort_index", "-1");
+          chrome->names_written = true;
+        }
+
+      std::map<const std::type_info *, string> type_names;
+      std::map<int, string> job_names;
+      for(Job & j : jobs)
+        {
+          if(type_names.find(j.type) == type_names.end())
+            type_names[j.type] = Demangle(j.type->name());
+          job_names[j.job_id] = type_names[j.type];
+          writer.Complete(job_names[j.job_id], "job", tid_jobs, ts(j.start_time),
+                           dur(j.start_time, j.stop_time), j.job_id);
+        }
+
+      for(auto & event : timer_events)
+        writer.Duration(NgProfiler::GetName(event.timer_id), event.is_start, tid_timers, ts(event.time));
+
+      std::vector<std::pair<TTimePoint,int>> active;
+      for(auto & vtasks : tasks)
+        for(Task & t : vtasks)
+          {
+            if(t.stop_time < t.start_time) continue;   // still running
+            switch(t.id_type)
+              {
+              case Task::ID_JOB:
+                if(trace_thread_counter)
+                  {
+                    active.push_back( { t.start_time, 1 } );
+                    active.push_back( { t.stop_time, -1 } );
+                  }
+                if(trace_threads)
+                  writer.Complete(job_names.count(t.id) ? job_names[t.id] : "job", "task", t.thread_id,
+                                   ts(t.start_time), dur(t.start_time, t.stop_time), t.id, t.additional_value);
+                break;
+              case Task::ID_TIMER:
+                writer.Complete(NgProfiler::GetName(t.id), "timer", t.thread_id,
+                                 ts(t.start_time), dur(t.start_time, t.stop_time), t.id, t.additional_value);
+                break;
+              default:
+                writer.Complete("task " + ToString(t.id), "task", t.thread_id,
+                                 ts(t.start_time), dur(t.start_time, t.stop_time), t.id, t.additional_value);
+              }
+          }
+
+      std::sort(active.begin(), active.end());
+      int nactive = 0;
+      for(auto & a : active)
+        writer.Counter("Active threads", ts(a.first), nactive += a.second);
+
+      // links between different threads, matched by key as for Paje
+      std::vector<ThreadLink> links_merged;
+      for(auto & l : links)
+        links_merged.insert(links_merged.end(), l.begin(), l.end());
+      std::stable_sort(links_merged.begin(), links_merged.end());
+
+      static size_t flow_id = 0;
+      std::vector<ThreadLink> started_links;
+      for(auto & l : links_merged)
+        {
+          if(l.is_start)
+            {
+              started_links.push_back(l);
+              continue;
+            }
+          for(size_t i = 0; i < started_links.size(); )
+            if(started_links[i].key == l.key)
+              {
+                if(started_links[i].thread_id != l.thread_id)
+                  {
+                    writer.Flow(true, started_links[i].thread_id, ts(started_links[i].time), flow_id);
+                    writer.Flow(false, l.thread_id, ts(l.time), flow_id);
+                    flow_id++;
+                  }
+                started_links.erase(started_links.begin()+i);
+              }
+            else
+              i++;
+        }
+    }
+
+  void PajeTrace::MergeChromeTraces( const std::vector<std::string> & filenames,
+                                     std::string filename )
+    {
+      // the writer puts the header and the footer on lines of their own
+      ofstream out(filename);
+      out << "{\"traceEvents\": [" << endl;
+      bool first = true;
+      for(auto & name : filenames)
+        {
+          ifstream in(name);
+          if(!in)
+            throw Exception("MergeChromeTraces: cannot open " + name);
+          string line;
+          std::getline(in, line);
+          while(std::getline(in, line))
+            {
+              if(line.size() == 0 || line[0] == ']') continue;
+              if(line.back() == ',') line.pop_back();
+              out << (first ? "" : ",\n") << line;
+              first = false;
+            }
+        }
+      out << endl << "], \"displayTimeUnit\": \"ms\"}" << endl;
+    }
+
   void PajeTrace::Write( string filename )
     {
       int n_events = jobs.size() + timer_events.size();
@@ -370,6 +687,22 @@ namespace ngstd
 
       cout << n_events << " events traced." << endl;
 
+      if(chrome_format)
+        {
+          if(filename != tracefile_name)
+            {
+              delete chrome;
+              chrome = nullptr;
+              tracefile_name = filename;
+            }
+          if(n_events > 0 || chrome)
+            Flush();
+          delete chrome;
+          chrome = nullptr;
+          tracefile_name = "";
+          return;
+        }
+
       if(n_events==0)
         {
           cout << "Skip writing trace file." << endl;
@@ -386,6 +719,7 @@ namespace ngstd
           cout << "max_size=0 disables tracing" << endl << endl;
         }
 
+      Unwrap();
       PajeFile paje(filename, start_time);
 
       const int container_type_task_manager = paje.DefineContainerType( 0, "Task Manager" );
@@ -422,6 +756,10 @@ namespace ngstd
       std::map<const std::type_info *, int> job_map;
       std::map<const std::type_info *, int> job_task_map;
 
+      std::map<int, const std::type_info *> job_types;
+      for(Job & j : jobs)
+        job_types[j.job_id] = j.type;
+
       for(Job & j : jobs)
         if(job_map.find(j.type) == job_map.end())
           {
@@ -451,6 +789,7 @@ namespace ngstd
       for(auto id : timer_ids)
         timer_aliases[id] = paje.DefineEntityValue( state_type_timer, NgProfiler::GetName(id).c_str(), -1 );
 
+      // stops without start (the start was overwritten in the ring buffer) are skipped
       int timerdepth = 0;
       int maxdepth = 0;
       for(auto & event : timer_events)
@@ -460,7 +799,7 @@ namespace ngstd
               timerdepth++;
               maxdepth = timerdepth>maxdepth ? timerdepth : maxdepth;
             }
-          else
+          else if(timerdepth > 0)
             timerdepth--;
         }
 
@@ -478,7 +817,7 @@ namespace ngstd
         {
           if(event.is_start)
             paje.PushState( event.time, state_type_timer, timer_container_aliases[timerdepth++], timer_aliases[event.timer_id] );
-          else
+          else if(timerdepth > 0)
             paje.PopState( event.time, state_type_timer, timer_container_aliases[--timerdepth] );
         }
 
@@ -490,7 +829,9 @@ namespace ngstd
               switch(t.id_type)
                 {
                 case Task::ID_JOB:
-                  value_id = job_task_map[jobs[t.id-1].type];
+                  // the job may have been overwritten in the ring buffer
+                  if(job_types.find(t.id) == job_types.end()) break;
+                  value_id = job_task_map[job_types[t.id]];
                   if(trace_thread_counter)
                     {
                       paje.AddVariable( t.start_time, variable_type_active_threads, container_jobs, 1.0 );
@@ -15,7 +15,43 @@ namespace ngstd
 
   string Demangle(string mangled_name);
 
+  /// writes str as JSON string literal, control characters as \u00XX
+  NGS_DLL_HEADER void JSONString (ostream & ost, const string & str);
+
+  /**
+     Streaming writer of the JSON trace event format, as read by
+     chrome://tracing and Perfetto. The header, every event and the
+     footer are written on lines of their own, time stamps are in
+     microseconds.
+  */
+  class NGS_DLL_HEADER ChromeTraceWriter
+    {
+      ostream & ost;
+      bool first = true;
+    public:
+      int pid;
+
+      ChromeTraceWriter (ostream & aost, int apid);
+      /// writes the footer
+      ~ChromeTraceWriter ();
+
+      /// names and sort indices of processes (tid < 0) and threads
+      void Metadata (int tid, string name, string value);
+      void Complete (const string & name, const char * cat, int tid, double ts, double dur,
+                     int id = -1, int value = -1);
+      void Duration (const string & name, bool start, int tid, double ts);
+      void Counter (const string & name, double ts, double value);
+      /// flow arrow from start to end, bound to the enclosing slices
+      void Flow (bool start, int tid, double ts, size_t id);
+      void Flush () { ost.flush(); }
+
+    private:
+      // starts a new event, with name, phase, thread and time stamp
+      void Begin (const string & name, char ph, int tid, double ts);
+    };
+
   extern NGS_DLL_HEADER class PajeTrace *trace;
+  class ChromeTraceFile;
   class PajeTrace
     {
     public:
@@ -29,11 +65,26 @@ namespace ngstd
       NGS_DLL_HEADER static size_t max_tracefile_size;
       static bool trace_thread_counter;
       static bool trace_threads;
+      // overwrite the oldest events instead of stopping when the buffers are full
+      static bool ring_buffer;
+      static bool chrome_format;
 
       bool tracing_enabled;
       TTimePoint start_time;
+      std::chrono::steady_clock::time_point start_steady;
+      // start in microseconds since the unix epoch, common to all MPI ranks
+      double start_epoch_us;
       int nthreads;
 
+      // number of events recorded, exceeds the buffer size in ring buffer mode
+      std::vector<size_t> task_count, link_count;
+      // number of tasks started per thread, never reset
+      std::vector<size_t> task_seq;
+      size_t job_count = 0, timer_count = 0;
+      int current_job = -1;
+
+      ChromeTraceFile * chrome = nullptr;
+
     public:
 
       // Approximate number of events to trace. Tracing will
@@ -55,6 +106,15 @@ namespace ngstd
           max_tracefile_size = max_size;
         }
 
+      static void SetRingBuffer( bool aring_buffer )
+        {
+          ring_buffer = aring_buffer;
+        }
+
+      /// "paje" for ViTE, or "chrome" for chrome://tracing and Perfetto
+      NGS_DLL_HEADER static void SetTraceFormat( std::string format );
+      static bool ChromeFormat() { return chrome_format; }
+
       std::string tracefile_name;
 
       struct Job
@@ -76,6 +136,8 @@ namespace ngstd
 
           TTimePoint start_time;
           TTimePoint stop_time;
+          // identifies the task if the slot is reused in ring buffer mode
+          size_t seq;
 
           static constexpr int ID_NONE = -1;
           static constexpr int ID_JOB = 1;
@@ -119,78 +181,149 @@ namespace ngstd
       PajeTrace(int anthreads, std::string aname = "");
       ~PajeTrace();
 
+      // slot of the event to overwrite if the buffer is full, -1 otherwise
+      INLINE int RingSlot (size_t size, size_t & count)
+        {
+          if(likely(size < max_num_events_per_thread)) return -1;
+          if(ring_buffer && max_num_events_per_thread > 0)
+            return count++ % max_num_events_per_thread;
+          StopTracing();
+          return -1;
+        }
+
+      void AddTimerEvent(const TimerEvent & event)
+        {
+          int slot = RingSlot(timer_events.size(), timer_count);
+          if(slot >= 0)
+            timer_events[slot] = event;
+          else
+            {
+              timer_events.push_back(event);
+              timer_count++;
+            }
+        }
+
       void StartTimer(int timer_id)
         {
           if(!tracing_enabled) return;
-          if(unlikely(timer_events.size() == max_num_events_per_thread))
-            StopTracing();
-          timer_events.push_back(TimerEvent{timer_id, GetTime(), true});
+          AddTimerEvent(TimerEvent{timer_id, GetTime(), true});
         }
 
       void StopTimer(int timer_id)
         {
           if(!tracing_enabled) return;
-          if(unlikely(timer_events.size() == max_num_events_per_thread))
-            StopTracing();
-          timer_events.push_back(TimerEvent{timer_id, GetTime(), false});
+          AddTimerEvent(TimerEvent{timer_id, GetTime(), false});
+        }
+
+      /// slot and sequence number of a started task
+      struct TaskHandle
+        {
+          int slot = -1;
+          size_t seq = 0;
+        };
+
+      INLINE TaskHandle StartTask(int thread_id, int id, int id_type = Task::ID_NONE, int additional_value = -1)
+        {
+          if(!tracing_enabled) return TaskHandle();
+          if(!trace_threads && !trace_thread_counter) return TaskHandle();
+          size_t seq = task_seq[thread_id]++;
+          int task_num = RingSlot(tasks[thread_id].Size(), task_count[thread_id]);
+          if(task_num >= 0)
+            {
+              tasks[thread_id][task_num] = Task{thread_id, id, id_type, additional_value, GetTime(), 0, seq};
+              return TaskHandle{task_num, seq};
+            }
+          task_num = tasks[thread_id].Size();
+          tasks[thread_id].Append( Task{thread_id, id, id_type, additional_value, GetTime(), 0, seq} );
+          task_count[thread_id]++;
+          return TaskHandle{task_num, seq};
         }
 
-      INLINE int StartTask(int thread_id, int id, int id_type = Task::ID_NONE, int additional_value = -1)
+      // the task, or nullptr if its slot was overwritten or flushed
+      INLINE Task * GetTask(int thread_id, TaskHandle handle)
         {
-          if(!tracing_enabled) return -1;
-          if(!trace_threads && !trace_thread_counter) return -1;
-	  if(unlikely(tasks[thread_id].Size() == max_num_events_per_thread))
-            StopTracing();
-          int task_num = tasks[thread_id].Size();
-          tasks[thread_id].Append( Task{thread_id, id, id_type, additional_value, GetTime()} );
-          return task_num;
+          if(handle.slot < 0 || handle.slot >= int(tasks[thread_id].Size())) return nullptr;
+          Task & task = tasks[thread_id][handle.slot];
+          return task.seq == handle.seq ? &task : nullptr;
         }
 
-      void StopTask(int thread_id, int task_num)
+      void StopTask(int thread_id, TaskHandle handle)
         {
           if(!trace_threads && !trace_thread_counter) return;
-          if(task_num>=0)
-            tasks[thread_id][task_num].stop_time = GetTime();
+          if(Task * task = GetTask(thread_id, handle))
+            task->stop_time = GetTime();
         }
 
-      void SetTask(int thread_id, int task_num, int additional_value) {
+      void SetTask(int thread_id, TaskHandle handle, int additional_value) {
           if(!trace_threads && !trace_thread_counter) return;
-          if(task_num>=0)
-            tasks[thread_id][task_num].additional_value = additional_value;
+          if(Task * task = GetTask(thread_id, handle))
+            task->additional_value = additional_value;
       }
 
       void StartJob(int job_id, const std::type_info & type)
         {
           if(!tracing_enabled) return;
-          if(jobs.size() == max_num_events_per_thread)
-            StopTracing();
-          jobs.push_back( Job{job_id, &type, GetTime()} );
+          current_job = RingSlot(jobs.size(), job_count);
+          if(current_job >= 0)
+            jobs[current_job] = Job{job_id, &type, GetTime()};
+          else
+            {
+              current_job = jobs.size();
+              jobs.push_back( Job{job_id, &type, GetTime()} );
+              job_count++;
+            }
         }
 
       void StopJob()
         {
-          if(tracing_enabled)
-            jobs.back().stop_time = GetTime();
+          if(tracing_enabled && current_job >= 0 && current_job < int(jobs.size()))
+            jobs[current_job].stop_time = GetTime();
+        }
+
+      void AddLink(const ThreadLink & link)
+        {
+          int thread_id = link.thread_id;
+          int slot = RingSlot(links[thread_id].size(), link_count[thread_id]);
+          if(slot >= 0)
+            links[thread_id][slot] = link;
+          else
+            {
+              links[thread_id].push_back(link);
+              link_count[thread_id]++;
+            }
         }
 
       void StartLink(int thread_id, int key)
         {
           if(!tracing_enabled) return;
-          if(links[thread_id].size() == max_num_events_per_thread)
-            StopTracing();
-          links[thread_id].push_back( ThreadLink{thread_id, key, GetTime(), true} );
+          AddLink( ThreadLink{thread_id, key, GetTime(), true} );
         }
 
       void StopLink(int thread_id, int key)
         {
           if(!tracing_enabled) return;
-          if(links[thread_id].size() == max_num_events_per_thread)
-            StopTracing();
-          links[thread_id].push_back( ThreadLink{thread_id, key, GetTime(), false} );
+          AddLink( ThreadLink{thread_id, key, GetTime(), false} );
         }
 
       void Write( std::string filename );
 
+      /**
+         Chrome format: append the recorded events to the trace file and
+         clear the buffers. Call outside of parallel jobs. In Paje format
+         all events are written at the end, and Flush does nothing.
+      */
+      NGS_DLL_HEADER void Flush();
+
+      /// concatenate the chrome traces of several MPI ranks into one file
+      NGS_DLL_HEADER static void MergeChromeTraces( const std::vector<std::string> & filenames,
+                                                   std::string filename );
+
+    private:
+      // bring ring buffers into chronological order
+      void Unwrap();
+      void Clear();
+      void WriteChromeEvents();
+
     };
 
   class TraceDisabler
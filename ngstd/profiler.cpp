@@ -5,6 +5,14 @@
 /**************************************************************************/
 
 #include <ngstd.hpp>
+#include <map>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif
+
 /*
 #ifdef PARALLEL
 #include <mpi.h>
@@ -179,6 +187,490 @@ namespace ngstd
 
 
 
+  bool HierarchicalProfiler::enabled = false;
+
+  namespace
+  {
+    /// a group of hardware counters of the calling thread, read with one syscall
+    class PerfGroup
+    {
+      int leader = -1;
+      std::vector<int> fds;
+      std::vector<int> counter;
+      std::vector<double> weight;
+    public:
+      bool Add (uint32_t type, uint64_t config, int acounter, double aweight)
+      {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset (&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = (leader == -1);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP |
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        int fd = syscall (__NR_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd < 0) return false;
+        if (leader == -1) leader = fd;
+        fds.push_back (fd);
+        counter.push_back (acounter);
+        weight.push_back (aweight);
+        return true;
+#else
+        return false;
+#endif
+      }
+
+      bool Empty () const { return fds.size() == 0; }
+
+      void Enable ()
+      {
+#ifdef __linux__
+        if (leader == -1) return;
+        ioctl (leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl (leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+      }
+
+      /// adds the counter values, scaled up if the group was multiplexed
+      void Read (double * values)
+      {
+        if (leader == -1) return;
+        uint64_t buf[3+8];
+        if (read (leader, buf, sizeof(buf)) < ssize_t(3*sizeof(uint64_t))) return;
+        double scale = buf[2] ? double(buf[1]) / buf[2] : 0;
+        for (size_t i = 0; i < buf[0] && i < fds.size(); i++)
+          values[counter[i]] += weight[i] * scale * buf[3+i];
+      }
+
+      void Close ()
+      {
+        for (int fd : fds) close (fd);
+        fds.clear(); counter.clear(); weight.clear();
+        leader = -1;
+      }
+    };
+
+    struct CallNode
+    {
+      int timer;
+      int parent;
+      /// top-level node of a worker: node of the main thread running at start, else -1
+      int link;
+      int first_child = -1;
+      int next_sibling = -1;
+      int event = -1;
+      size_t calls = 0;
+      size_t ticks = 0;
+      size_t start = 0;
+      double counters[HierarchicalProfiler::NCOUNTERS] = { 0 };
+      double counterstart[HierarchicalProfiler::NCOUNTERS] = { 0 };
+
+      CallNode (int atimer, int aparent, int alink)
+        : timer(atimer), parent(aparent), link(alink) { ; }
+    };
+
+    struct TraceEvent
+    {
+      int timer;
+      size_t start, stop;
+    };
+
+    struct CallTree
+    {
+      int id;
+      std::vector<CallNode> nodes;
+      /// running node, read by workers attaching to the main thread
+      atomic<int> current;
+      std::vector<TraceEvent> events;
+      PerfGroup perf[2];
+      bool perf_opened = false;
+
+      CallTree (int aid) : id(aid), current(0) { Clear(); }
+
+      void Clear ()
+      {
+        nodes.clear();
+        nodes.push_back (CallNode(-1, -1, -1));
+        current = 0;
+        events.clear();
+      }
+
+      void OpenCounters ();
+      void ReadCounters (double * values)
+      {
+        for (int i = 0; i < HierarchicalProfiler::NCOUNTERS; i++)
+          values[i] = 0;
+        perf[0].Read (values);
+        perf[1].Read (values);
+      }
+    };
+
+    mutex trees_mutex;
+    // trees outlive their threads, the thread_local pointer is all a thread owns
+    std::vector<unique_ptr<CallTree>> trees;
+    CallTree * main_tree = nullptr;
+    thread_local CallTree * my_tree = nullptr;
+
+    bool use_counters = false;
+    bool use_trace = false;
+    size_t max_events = 0;
+    bool have_counter[HierarchicalProfiler::NCOUNTERS] = { false };
+
+    size_t start_ticks = 0;
+    std::chrono::steady_clock::time_point start_time;
+
+    void CallTree :: OpenCounters ()
+    {
+      perf_opened = true;
+#ifdef __linux__
+      typedef HierarchicalProfiler HP;
+      if (perf[0].Add (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, HP::CYCLES, 1))
+        {
+          if (perf[0].Add (PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, HP::INSTRUCTIONS, 1))
+            have_counter[HP::INSTRUCTIONS] = true;
+          if (perf[0].Add (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, HP::CACHE_MISSES, 1))
+            have_counter[HP::CACHE_MISSES] = true;
+          have_counter[HP::CYCLES] = true;
+        }
+#if defined(__GNUC__) && defined(__x86_64__)
+      // there is no generic flop event, Intel counts double precision
+      // arithmetic by vector width in FP_ARITH_INST_RETIRED (FMA counts twice)
+      if (__builtin_cpu_is ("intel") &&
+          perf[1].Add (PERF_TYPE_RAW, 0x01c7, HP::FLOPS, 1))
+        {
+          perf[1].Add (PERF_TYPE_RAW, 0x04c7, HP::FLOPS, 2);
+          perf[1].Add (PERF_TYPE_RAW, 0x10c7, HP::FLOPS, 4);
+          perf[1].Add (PERF_TYPE_RAW, 0x40c7, HP::FLOPS, 8);
+          have_counter[HP::FLOPS] = true;
+        }
+#endif
+      perf[0].Enable();
+      perf[1].Enable();
+#endif
+    }
+
+    CallTree & MyTree ()
+    {
+      if (!my_tree)
+        {
+          lock_guard<mutex> guard(trees_mutex);
+          trees.push_back (make_unique<CallTree> (trees.size()));
+          my_tree = trees.back().get();
+        }
+      return *my_tree;
+    }
+
+    void CloseNode (CallTree & tree, int nr, size_t now, double * values)
+    {
+      CallNode & node = tree.nodes[nr];
+      node.ticks += now - node.start;
+      if (use_counters)
+        for (int i = 0; i < HierarchicalProfiler::NCOUNTERS; i++)
+          node.counters[i] += values[i] - node.counterstart[i];
+      if (node.event != -1)
+        tree.events[node.event].stop = now;
+    }
+
+    double SecondsPerTick ()
+    {
+      size_t ticks = __rdtsc() - start_ticks;
+      double seconds = std::chrono::duration<double>
+        (std::chrono::steady_clock::now() - start_time).count();
+      return ticks ? seconds / ticks : 0;
+    }
+  }
+
+
+  void HierarchicalProfiler :: Enable (bool hwcounters, bool trace, size_t amax_events)
+  {
+    enabled = false;
+    Reset();
+    lock_guard<mutex> guard(trees_mutex);
+    use_counters = hwcounters;
+    use_trace = trace;
+    max_events = amax_events;
+    if (!my_tree)
+      {
+        trees.push_back (make_unique<CallTree> (trees.size()));
+        my_tree = trees.back().get();
+      }
+    main_tree = my_tree;
+    start_ticks = __rdtsc();
+    start_time = std::chrono::steady_clock::now();
+    enabled = true;
+  }
+
+  void HierarchicalProfiler :: Disable ()
+  {
+    enabled = false;
+  }
+
+  void HierarchicalProfiler :: Reset ()
+  {
+    lock_guard<mutex> guard(trees_mutex);
+    for (auto & tree : trees)
+      {
+        tree->Clear();
+        tree->perf[0].Close();
+        tree->perf[1].Close();
+        tree->perf_opened = false;
+      }
+    for (auto & have : have_counter)
+      have = false;
+  }
+
+  bool HierarchicalProfiler :: HaveCounter (int counter)
+  {
+    return have_counter[counter];
+  }
+
+  const char * HierarchicalProfiler :: CounterName (int counter)
+  {
+    static const char * names[NCOUNTERS] = { "cycles", "instructions", "cache misses", "flops" };
+    return names[counter];
+  }
+
+  void HierarchicalProfiler :: Start (int nr)
+  {
+    CallTree & tree = MyTree();
+    if (use_counters && !tree.perf_opened)
+      tree.OpenCounters();
+
+    int cur = tree.current;
+    int link = -1;
+    if (cur == 0 && &tree != main_tree && main_tree)
+      link = main_tree->current.load (memory_order_relaxed);
+
+    int child = tree.nodes[cur].first_child;
+    while (child != -1 && (tree.nodes[child].timer != nr || tree.nodes[child].link != link))
+      child = tree.nodes[child].next_sibling;
+    if (child == -1)
+      {
+        child = tree.nodes.size();
+        tree.nodes.push_back (CallNode(nr, cur, link));
+        tree.nodes[child].next_sibling = tree.nodes[cur].first_child;
+        tree.nodes[cur].first_child = child;
+      }
+
+    CallNode & node = tree.nodes[child];
+    node.calls++;
+    if (use_counters)
+      tree.ReadCounters (node.counterstart);
+    node.event = -1;
+    if (use_trace && tree.events.size() < max_events)
+      {
+        node.event = tree.events.size();
+        tree.events.push_back (TraceEvent { nr, 0, 0 });
+      }
+    tree.current.store (child, memory_order_relaxed);
+    node.start = __rdtsc();
+    if (node.event != -1)
+      tree.events[node.event].start = node.start;
+  }
+
+  void HierarchicalProfiler :: Stop (int nr)
+  {
+    size_t now = __rdtsc();
+    CallTree & tree = MyTree();
+
+    // closes the innermost running node of timer nr, and all nodes
+    // started within it. Stops without matching start are ignored
+    int cur = tree.current;
+    int n = cur;
+    while (n != 0 && tree.nodes[n].timer != nr)
+      n = tree.nodes[n].parent;
+    if (n == 0) return;
+
+    double values[NCOUNTERS];
+    if (use_counters)
+      tree.ReadCounters (values);
+    for (int m = cur; ; m = tree.nodes[m].parent)
+      {
+        CloseNode (tree, m, now, values);
+        if (m == n) break;
+      }
+    tree.current.store (tree.nodes[n].parent, memory_order_relaxed);
+  }
+
+
+  std::vector<HierarchicalProfiler::Entry> HierarchicalProfiler :: Report ()
+  {
+    lock_guard<mutex> guard(trees_mutex);
+    double sec_per_tick = SecondsPerTick();
+
+    std::vector<Entry> entries(1);
+    entries[0].timer = -1;
+    entries[0].name = "total";
+
+    std::map<std::pair<int,int>, int> index;   // (parent entry, timer) -> entry
+    std::vector<std::vector<double>> threadtimes(1);
+    std::vector<CallTree*> order;
+    if (main_tree) order.push_back (main_tree);
+    for (auto & tree : trees)
+      if (tree.get() != main_tree)
+        order.push_back (tree.get());
+
+    auto GetEntry = [&] (int parent, int timer)
+      {
+        auto it = index.find (std::make_pair (parent, timer));
+        if (it != index.end()) return it->second;
+        int nr = entries.size();
+        index[std::make_pair (parent, timer)] = nr;
+        entries.push_back (Entry());
+        entries[nr].timer = timer;
+        entries[nr].name = NgProfiler::GetName (timer);
+        entries[parent].children.push_back (nr);
+        threadtimes.push_back (std::vector<double> (order.size(), -1));
+        return nr;
+      };
+
+    // running nodes of the calling thread count up to now
+    size_t now = __rdtsc();
+    std::vector<int> maingnode;
+    for (size_t ti = 0; ti < order.size(); ti++)
+      {
+        CallTree & tree = *order[ti];
+        std::vector<int> gnode(tree.nodes.size());
+        gnode[0] = 0;
+        // parents are created before their children
+        for (size_t i = 1; i < tree.nodes.size(); i++)
+          {
+            const CallNode & node = tree.nodes[i];
+            int gparent = gnode[node.parent];
+            if (node.parent == 0 && node.link > 0 && size_t(node.link) < maingnode.size())
+              gparent = maingnode[node.link];
+            int g = GetEntry (gparent, node.timer);
+            gnode[i] = g;
+
+            size_t ticks = node.ticks;
+            if (&tree == my_tree)
+              for (int n = tree.current; n != 0; n = tree.nodes[n].parent)
+                if (size_t(n) == i) ticks += now - node.start;
+
+            Entry & entry = entries[g];
+            entry.calls += node.calls;
+            for (int j = 0; j < NCOUNTERS; j++)
+              entry.counters[j] += node.counters[j];
+            double & time = threadtimes[g][ti];
+            time = max2 (time, 0.0) + ticks * sec_per_tick;
+          }
+        if (&tree == main_tree)
+          maingnode = gnode;
+      }
+
+    for (size_t g = 1; g < entries.size(); g++)
+      {
+        Entry & entry = entries[g];
+        entry.min = std::numeric_limits<double>::max();
+        for (double t : threadtimes[g])
+          if (t >= 0)
+            {
+              entry.threads++;
+              entry.total += t;
+              entry.min = min2 (entry.min, t);
+              entry.max = max2 (entry.max, t);
+            }
+        entry.mean = entry.total / entry.threads;
+        entry.time = entry.max;
+        entry.imbalance = entry.mean > 0 ? entry.max / entry.mean : 1;
+      }
+
+    Entry & root = entries[0];
+    root.threads = 0;
+    for (auto & tree : order)
+      if (tree->nodes.size() > 1) root.threads++;
+    for (int c : root.children)
+      {
+        root.time += entries[c].time;
+        root.total += entries[c].total;
+        for (int j = 0; j < NCOUNTERS; j++)
+          root.counters[j] += entries[c].counters[j];
+      }
+    root.min = root.mean = root.max = root.time;
+    return entries;
+  }
+
+
+  void HierarchicalProfiler :: Print (ostream & ost)
+  {
+    auto entries = Report();
+    std::function<void(int,int)> PrintEntry = [&] (int nr, int depth)
+      {
+        const Entry & entry = entries[nr];
+        ost << string(2*depth, ' ') << entry.name
+            << ", calls " << entry.calls
+            << ", time " << entry.time << " sec";
+        if (nr > 0 && entry.threads > 1)
+          ost << ", threads " << entry.threads
+              << ", min/mean/max " << entry.min << "/" << entry.mean << "/" << entry.max
+              << ", imbalance " << entry.imbalance;
+        for (int j = 0; j < NCOUNTERS; j++)
+          if (have_counter[j])
+            ost << ", " << CounterName(j) << " " << entry.counters[j];
+        ost << endl;
+        for (int c : entry.children)
+          PrintEntry (c, depth+1);
+      };
+    PrintEntry (0, 0);
+  }
+
+  void HierarchicalProfiler :: WriteJSON (ostream & ost)
+  {
+    auto entries = Report();
+    std::function<void(int)> WriteEntry = [&] (int nr)
+      {
+        const Entry & entry = entries[nr];
+        ost << "{\"name\": ";
+        JSONString (ost, entry.name);
+        ost << ", \"calls\": " << entry.calls
+            << ", \"time\": " << entry.time
+            << ", \"total\": " << entry.total
+            << ", \"threads\": " << entry.threads
+            << ", \"min\": " << entry.min
+            << ", \"mean\": " << entry.mean
+            << ", \"max\": " << entry.max
+            << ", \"imbalance\": " << entry.imbalance;
+        for (int j = 0; j < NCOUNTERS; j++)
+          if (have_counter[j])
+            ost << ", \"" << CounterName(j) << "\": " << entry.counters[j];
+        ost << ", \"children\": [";
+        for (size_t i = 0; i < entry.children.size(); i++)
+          {
+            if (i) ost << ", ";
+            WriteEntry (entry.children[i]);
+          }
+        ost << "]}";
+      };
+    auto prec = ost.precision (10);
+    WriteEntry (0);
+    ost << endl;
+    ost.precision (prec);
+  }
+
+  void HierarchicalProfiler :: WriteChromeTrace (ostream & ost)
+  {
+    lock_guard<mutex> guard(trees_mutex);
+    double us_per_tick = 1e6 * SecondsPerTick();
+    ChromeTraceWriter writer(ost, 0);
+    for (auto & tree : trees)
+      {
+        if (tree->nodes.size() == 1) continue;
+        writer.Metadata (tree->id, "thread_name", "thread " + ToString(tree->id));
+        for (auto & ev : tree->events)
+          if (ev.stop != 0)
+            writer.Complete (NgProfiler::GetName (ev.timer), "timer", tree->id,
+                             (long long)(ev.start - start_ticks) * us_per_tick,
+                             (ev.stop - ev.start) * us_per_tick);
+      }
+  }
+
+
+
+
 #ifdef  VTRACE
 #ifdef PARALLEL
   Timer * Timer::stack_top = NULL;
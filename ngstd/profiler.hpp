@@ -249,6 +249,63 @@ namespace ngstd
 
 
 
+
+
+  /**
+     Call-tree profiler.
+
+     A timer started while another one is running on the same thread is
+     recorded as its child.  Every thread keeps its own tree, top-level
+     timers of worker threads are attached to the timer running on the
+     thread which enabled the profiler.  The report merges the trees by
+     timer path, with per-thread min/max/mean times.  On Linux, hardware
+     counters are read via perf_event_open if the kernel permits.
+
+     Disabled, it costs one branch per timer start and stop.
+     Enable, Reset and Disable must not be called within parallel regions.
+  */
+  class NGS_DLL_HEADER HierarchicalProfiler
+  {
+  public:
+    enum { CYCLES, INSTRUCTIONS, CACHE_MISSES, FLOPS, NCOUNTERS };
+
+    struct Entry
+    {
+      int timer;               // -1 for the root
+      string name;
+      size_t calls = 0;
+      int threads = 0;         // threads which called the timer
+      double time = 0;         // largest time of a single thread
+      double total = 0;        // sum over threads
+      double min = 0, mean = 0, max = 0;
+      double imbalance = 1;    // max / mean
+      double counters[NCOUNTERS] = { 0 };
+      std::vector<int> children;
+    };
+
+    static bool enabled;
+
+    /// resets and enables, optionally with hardware counters and a trace of all timer events
+    static void Enable (bool hwcounters = false, bool trace = false, size_t max_events = 1000000);
+    static void Disable ();
+    static void Reset ();
+
+    static void Start (int nr);
+    static void Stop (int nr);
+
+    /// are counters of this kind recorded ?
+    static bool HaveCounter (int counter);
+    static const char * CounterName (int counter);
+
+    /// merged call-tree, entry 0 is the root
+    static std::vector<Entry> Report ();
+
+    static void Print (ostream & ost);
+    static void WriteJSON (ostream & ost);
+    /// trace events for chrome://tracing, needs Enable with trace
+    static void WriteChromeTrace (ostream & ost);
+  };
+
   
 #ifndef VTRACE
   class Timer
@@ -268,14 +325,22 @@ namespace ngstd
     void Start () 
     {
       if (priority <= 2) 
-	NgProfiler::StartTimer (timernr);
+        {
+          NgProfiler::StartTimer (timernr);
+          if (unlikely(HierarchicalProfiler::enabled))
+            HierarchicalProfiler::Start (timernr);
+        }
       if (priority <= 1)
         if(trace) trace->StartTimer(timernr);
     }
     void Stop () 
     {
       if (priority <= 2) 
-	NgProfiler::StopTimer (timernr);
+        {
+          if (unlikely(HierarchicalProfiler::enabled))
+            HierarchicalProfiler::Stop (timernr);
+          NgProfiler::StopTimer (timernr);
+        }
       if (priority <= 1)
         if(trace) trace->StopTimer(timernr);
     }
@@ -315,15 +380,23 @@ namespace ngstd
   public:
     /// start timer
     ThreadRegionTimer (size_t _nr, size_t _tid) : nr(_nr), tid(_tid)
-    { NgProfiler::StartThreadTimer(nr, tid); }
+    {
+      NgProfiler::StartThreadTimer(nr, tid);
+      if (unlikely(HierarchicalProfiler::enabled))
+        HierarchicalProfiler::Start (nr);
+    }
     /// stop timer
     ~ThreadRegionTimer ()
-    { NgProfiler::StopThreadTimer(nr, tid); }
+    {
+      if (unlikely(HierarchicalProfiler::enabled))
+        HierarchicalProfiler::Stop (nr);
+      NgProfiler::StopThreadTimer(nr, tid);
+    }
   };
 
   class RegionTracer
     {
-      int nr;
+      PajeTrace::TaskHandle nr;
       int thread_id;
     public:
       static constexpr int ID_JOB = PajeTrace::Task::ID_JOB;
@@ -184,6 +184,20 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
     .def("SetTraceThreads", &PajeTrace::SetTraceThreads)
     .def("SetTraceThreadCounter", &PajeTrace::SetTraceThreadCounter)
     .def("SetMaxTracefileSize", &PajeTrace::SetMaxTracefileSize)
+    .def_static("SetRingBuffer", &PajeTrace::SetRingBuffer, py::arg("ring_buffer"),
+                "keep the latest events if the buffers are full, instead of stopping the trace")
+    .def_static("SetTraceFormat", &PajeTrace::SetTraceFormat, py::arg("format"),
+                "'paje' for ViTE, or 'chrome' for chrome://tracing and Perfetto")
+    .def_static("Flush", [] () { if (trace) trace->Flush(); },
+                "append the events recorded so far to the chrome trace file, call outside of parallel regions")
+    .def_static("MergeChromeTraces", [] (py::list files, string filename)
+                {
+                  std::vector<string> names;
+                  for (auto f : files)
+                    names.push_back (f.cast<string>());
+                  PajeTrace::MergeChromeTraces (names, filename);
+                }, py::arg("files"), py::arg("filename"),
+                "merge the chrome traces of MPI ranks into one file")
     ;
 
 
@@ -428,6 +442,64 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
 	   }, "Returns list of timers"
 	   );
 
+  m.def("EnableHierarchicalProfiler",
+        [](bool enable, bool hwcounters, bool trace, size_t max_events)
+        {
+          if (enable)
+            HierarchicalProfiler::Enable (hwcounters, trace, max_events);
+          else
+            HierarchicalProfiler::Disable();
+        },
+        py::arg("enable")=true, py::arg("hwcounters")=false,
+        py::arg("trace")=false, py::arg("max_events")=1000000,
+        "Reset and enable (or disable) the call-tree profiler\n"
+        "hwcounters: read cycles, instructions, cache misses and flops via perf_event_open, if permitted\n"
+        "trace: record timer events for WriteProfile(format='chrome'), at most max_events per thread");
+
+  m.def("HierarchicalTimers",
+        []()
+        {
+          auto entries = HierarchicalProfiler::Report();
+          std::function<py::dict(int)> ToDict = [&] (int nr)
+            {
+              auto & entry = entries[nr];
+              py::dict timer;
+              timer["name"] = py::str(entry.name);
+              timer["calls"] = py::int_(entry.calls);
+              timer["time"] = py::float_(entry.time);
+              timer["total"] = py::float_(entry.total);
+              timer["threads"] = py::int_(entry.threads);
+              timer["min"] = py::float_(entry.min);
+              timer["mean"] = py::float_(entry.mean);
+              timer["max"] = py::float_(entry.max);
+              timer["imbalance"] = py::float_(entry.imbalance);
+              for (int j = 0; j < HierarchicalProfiler::NCOUNTERS; j++)
+                if (HierarchicalProfiler::HaveCounter(j))
+                  timer[HierarchicalProfiler::CounterName(j)] = py::float_(entry.counters[j]);
+              py::list children;
+              for (int c : entry.children)
+                children.append (ToDict(c));
+              timer["children"] = children;
+              return timer;
+            };
+          return ToDict(0);
+        }, "Returns the call-tree of timers recorded since EnableHierarchicalProfiler");
+
+  m.def("WriteProfile",
+        [](string filename, string format)
+        {
+          ofstream out(filename);
+          if (format == "json")
+            HierarchicalProfiler::WriteJSON (out);
+          else if (format == "chrome")
+            HierarchicalProfiler::WriteChromeTrace (out);
+          else if (format == "text")
+            HierarchicalProfiler::Print (out);
+          else
+            throw Exception ("WriteProfile: unknown format " + format);
+        }, py::arg("filename"), py::arg("format")="json",
+        "Write the call-tree profile, format is 'json', 'text' or 'chrome' (trace events for chrome://tracing)");
+
   py::class_<Archive, shared_ptr<Archive>> (m, "Archive")
       /*
     .def("__init__", [](const string & filename, bool write,
@@ -468,6 +540,22 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
                                            *self & a; return self; }, py::arg("array"))
   ;
 
+  py::class_<CheckpointArchive, shared_ptr<CheckpointArchive>, Archive>
+    (m, "CheckpointArchive", "chunked binary archive with table of contents, large arrays are memory mapped on reading")
+    .def(py::init<> ([](const string & filename, bool write, bool compress) -> shared_ptr<CheckpointArchive>
+                     {
+                       if (write)
+                         return make_shared<CheckpointOutArchive> (filename, compress);
+                       return make_shared<CheckpointInArchive> (filename);
+                     }), py::arg("filename"), py::arg("write"), py::arg("compress")=false,
+         "compress chunks with zlib, if available")
+    .def("Close", [](shared_ptr<CheckpointArchive> & self)
+         {
+           if (auto out = dynamic_pointer_cast<CheckpointOutArchive> (self))
+             out->Finish();
+         }, "write the table of contents, the archive is complete afterwards")
+    ;
+
   m.def("RunWithTaskManager", 
           [](py::object lam)
                            {
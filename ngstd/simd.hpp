@@ -798,7 +798,35 @@ namespace ngstd
   { return SIMD<double,4>(sd1.Data(), sd2.Data(), sd3.Data(), sd4.Data()); }
 
 
-  
+
+  // indexed load p[ind[0]], ... p[ind[N-1]]
+  template <int N>
+  INLINE SIMD<double,N> SIMDGather (double const * p, int const * ind)
+  {
+    double tmp[N];
+    for (int i = 0; i < N; i++)
+      tmp[i] = p[ind[i]];
+    return SIMD<double,N> (&tmp[0]);
+  }
+
+#ifdef __AVX2__
+  template <>
+  INLINE SIMD<double,4> SIMDGather<4> (double const * p, int const * ind)
+  {
+    return _mm256_i32gather_pd (p, _mm_loadu_si128((__m128i const*)ind), 8);
+  }
+#endif
+
+#ifdef __AVX512F__
+  template <>
+  INLINE SIMD<double,8> SIMDGather<8> (double const * p, int const * ind)
+  {
+    return _mm512_i32gather_pd (_mm256_loadu_si256((__m256i const*)ind), p, 8);
+  }
+#endif
+
+
+
 
   INLINE void SIMDTranspose (SIMD<double,4> a1, SIMD<double,4> a2, SIMD <double,4> a3, SIMD<double,4> a4,
                              SIMD<double,4> & b1, SIMD<double,4> & b2, SIMD<double,4> & b3, SIMD<double,4> & b4)
@@ -0,0 +1,182 @@
+/********************************************************************/
+/* File:   taskgraph.cpp                                            */
+/* Date:   17. Oct. 2026                                            */
+/********************************************************************/
+
+#include <ngstd.hpp>
+#include "concurrentqueue.h"
+
+
+namespace ngstd
+{
+  bool ProcessTask();   // nested tasks, in taskmanager.cpp
+
+
+  // the state of one RunParallelDependency call
+  struct DependencyRun
+  {
+    FlatTable<int> dag;
+    const function<void(int)> * func;
+    FlatArray<atomic<int>> cnt_dep;
+    size_t num_final;
+    atomic<size_t> cnt_final{0};
+    // set by the first throwing task, the remaining tasks are skipped
+    atomic<bool> failed{false};
+    std::exception_ptr exception;
+  };
+
+  struct TDependencyTask
+  {
+    DependencyRun * run;
+    int nr;
+  };
+
+  typedef moodycamel::ConcurrentQueue<TDependencyTask> TQueue;
+  typedef moodycamel::ProducerToken TPToken;
+  typedef moodycamel::ConsumerToken TCToken;
+
+  // shared by all active runs, every entry knows its run
+  static TQueue depqueue;
+
+
+  static void ProcessDependencyTask (TDependencyTask task, TPToken & ptoken)
+  {
+    DependencyRun & run = *task.run;
+    // skipped tasks still pass through the queue and release their
+    // successors, so that all threads see the run finish
+    if (!run.failed.load(memory_order_relaxed))
+      try
+        {
+          (*run.func)(task.nr);
+        }
+      catch (...)
+        {
+          if (!run.failed.exchange(true))
+            run.exception = std::current_exception();
+        }
+
+    auto succ = run.dag[task.nr];
+    if (succ.Size() == 0)
+      {
+        run.cnt_final++;   // last access to run
+        return;
+      }
+
+    for (int j : succ)
+      if (--run.cnt_dep[j] == 0)
+        depqueue.enqueue (ptoken, TDependencyTask{ &run, j });
+  }
+
+
+  static void RunParallelDependency (DependencyRun & run)
+  {
+    auto dag = run.dag;
+    auto & cnt_dep = run.cnt_dep;
+
+    size_t num_ready = 0;
+    run.num_final = 0;
+    for (size_t i : Range(cnt_dep))
+      {
+        if (cnt_dep[i] == 0) num_ready++;
+        if (dag[i].Size() == 0) run.num_final++;
+      }
+
+    Array<int> ready(num_ready);
+    ready.SetSize0();
+    for (int j : Range(cnt_dep))
+      if (cnt_dep[j] == 0) ready.Append(j);
+
+    if (!task_manager)
+      {
+        while (ready.Size())
+          {
+            int nr = ready.Last();
+            ready.DeleteLast();
+
+            (*run.func)(nr);
+
+            for (int j : dag[nr])
+              if (--cnt_dep[j] == 0)
+                ready.Append(j);
+          }
+        return;
+      }
+
+    SharedLoop2 sl(Range(ready));
+
+    task_manager -> CreateJob
+      ([&] (const TaskInfo & ti)
+       {
+         TPToken ptoken(depqueue);
+         TCToken ctoken(depqueue);
+
+         for (size_t i : sl)
+           depqueue.enqueue (ptoken, TDependencyTask{ &run, ready[i] });
+
+         while (run.cnt_final < run.num_final)
+           {
+             TDependencyTask task;
+             if (depqueue.try_dequeue_from_producer(ptoken, task) ||
+                 depqueue.try_dequeue(ctoken, task))
+               // might belong to another (nested) run
+               ProcessDependencyTask (task, ptoken);
+             else
+               ProcessTask();   // help with nested ParallelFor
+           }
+       });
+
+    if (run.exception)
+      std::rethrow_exception (run.exception);
+  }
+
+
+  void RunParallelDependency (FlatTable<int> dag,
+                              const function<void(int)> & func)
+  {
+    static Timer t("RunParallelDependency");
+    RegionTimer reg(t);
+
+    Array<atomic<int>> cnt_dep(dag.Size());
+    for (auto & d : cnt_dep)
+      d.store (0, memory_order_relaxed);
+
+    ParallelFor (Range(dag),
+                 [&] (int i)
+                 {
+                   for (int j : dag[i])
+                     cnt_dep[j]++;
+                 });
+
+    DependencyRun run { dag, &func, cnt_dep };
+    RunParallelDependency (run);
+  }
+
+
+  void RunParallelDependency (FlatTable<int> dag,
+                              FlatTable<int> trans_dag,
+                              const function<void(int)> & func)
+  {
+    static Timer t("RunParallelDependency");
+    RegionTimer reg(t);
+
+    Array<atomic<int>> cnt_dep(dag.Size());
+    for (auto i : Range(cnt_dep))
+      cnt_dep[i].store (trans_dag[i].Size(), memory_order_relaxed);
+
+    DependencyRun run { dag, &func, cnt_dep };
+    RunParallelDependency (run);
+  }
+
+
+
+  void TaskGraph :: Run () const
+  {
+    TableCreator<int> creator(tasks.Size());
+    for ( ; !creator.Done(); creator++)
+      for (auto e : edges)
+        creator.Add (get<0>(e), get<1>(e));
+    Table<int> dag = creator.MoveTable();
+
+    RunParallelDependency (dag, [this] (int nr) { tasks[nr](); });
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef FILE_TASKGRAPH
+#define FILE_TASKGRAPH
+
+/*********************************************************************/
+/* File:   taskgraph.hpp                                             */
+/* Date:   17. Oct. 2026                                             */
+/*********************************************************************/
+
+/*
+  Dependency-driven execution on top of the TaskManager.
+
+  Ready tasks of all running graphs share one queue, so graphs can be
+  nested: a graph started from inside a ParallelJob, a ParallelFor or
+  another graph is served by all idle threads. Threads waiting for
+  their graph also process the nested ParallelFor tasks.
+*/
+
+namespace ngstd
+{
+
+  /*
+    Run func(i) for all nodes i of the DAG, such that func(i) is
+    completed before func(j) starts for all j in dag[i].
+
+    If func throws, the nodes not started yet are skipped, and the
+    first exception is rethrown when the running nodes are finished.
+  */
+  NGS_DLL_HEADER void RunParallelDependency (FlatTable<int> dag,
+                                             const function<void(int)> & func);
+
+  // same, with given transposed dag (the predecessors of every node)
+  NGS_DLL_HEADER void RunParallelDependency (FlatTable<int> dag,
+                                             FlatTable<int> trans_dag,
+                                             const function<void(int)> & func);
+
+
+
+  /*
+    Usage example:
+
+    TaskGraph graph;
+    auto assemble = graph.Add ( [&] () { bfa.Assemble(); } );
+    auto setup = graph.Add ( [&] () { mesh_stuff(); } );
+    auto pre = graph.Add ( [&] () { pre.Update(); }, { assemble, setup } );
+    pre.Then ( [&] () { cout << "done" << endl; } );
+    graph.Run();
+
+    Tasks may use ParallelFor, ParallelJob or run another TaskGraph.
+  */
+  class NGS_DLL_HEADER TaskGraph
+  {
+    Array<function<void()>> tasks;
+    Array<tuple<int,int>> edges;     // (before, after)
+
+  public:
+    class TaskHandle
+    {
+      TaskGraph * graph;
+      int nr;
+    public:
+      TaskHandle (TaskGraph * agraph, int anr) : graph(agraph), nr(anr) { ; }
+      int Nr() const { return nr; }
+      // add a task starting after this one is finished
+      TaskHandle Then (function<void()> func) const
+      { return graph->Add (move(func), { *this }); }
+    };
+
+    TaskHandle Add (function<void()> func)
+    {
+      tasks.Append (move(func));
+      return TaskHandle (this, tasks.Size()-1);
+    }
+
+    // add a task starting after all tasks in 'after'
+    TaskHandle Add (function<void()> func, std::initializer_list<TaskHandle> after)
+    {
+      auto handle = Add (move(func));
+      for (auto dep : after)
+        AddDependency (dep, handle);
+      return handle;
+    }
+
+    void AddDependency (TaskHandle before, TaskHandle after)
+    {
+      edges.Append (make_tuple(before.Nr(), after.Nr()));
+    }
+
+    size_t Size() const { return tasks.Size(); }
+
+    // execute all tasks, returns when all are done. The graph is kept
+    // and may be run again. If a task throws, the tasks not started
+    // yet are skipped and the exception is rethrown
+    void Run () const;
+  };
+
+}
+
+#endif
@@ -15,7 +15,7 @@
 #endif
 
 
-#include "../linalg/concurrentqueue.h"
+#include "concurrentqueue.h"
 
 
 
@@ -55,6 +55,10 @@ namespace ngstd
 
   TaskManager::NodeData *TaskManager::nodedata[8];
   int TaskManager::num_nodes;
+
+  WorkStealingDeque * TaskManager::deques = nullptr;
+  Array<int> * TaskManager::victims = nullptr;
+  atomic<bool> TaskManager::job_aborted{false};
   
   static mutex copyex_mutex;
 
@@ -152,6 +156,10 @@ namespace ngstd
       sleep_usecs = 1000;
       active_workers = 0;
 
+      deques = new WorkStealingDeque[num_threads];
+      victims = new Array<int>[num_threads];
+      SetupVictims();
+
       static int cnt = 0;
       char buf[100];
       if (use_paje_trace)
@@ -161,6 +169,8 @@ namespace ngstd
 #else
           sprintf(buf, "ng%d.trace", cnt++);
 #endif
+          if (PajeTrace::ChromeFormat())
+            strcat(buf, ".json");
         }
       else
         buf[0] = 0;
@@ -173,9 +183,88 @@ namespace ngstd
   {
     delete trace;
     trace = nullptr;
+    delete [] deques;
+    deques = nullptr;
+    delete [] victims;
+    victims = nullptr;
     num_threads = 1;
   }
 
+
+  void TaskManager :: SetupVictims ()
+  {
+    // threads on the own NUMA node first (cyclic, starting with the
+    // right neighbour), then the other nodes in increasing distance
+    int thds = num_threads;
+    for (int thd = 0; thd < thds; thd++)
+      {
+        int mynode = num_nodes * thd/thds;
+        Array<int> & myvictims = victims[thd];
+        myvictims.SetSize0();
+        for (int k = 0; k < num_nodes; k++)
+          {
+            int node = (mynode+k) % num_nodes;
+            for (int j = 1; j <= thds; j++)
+              {
+                int other = (thd+j) % thds;
+                if (other != thd && num_nodes * other/thds == node)
+                  myvictims.Append (other);
+              }
+          }
+      }
+  }
+
+
+  void TaskManager :: ProcessJobTasks (TaskInfo & ti)
+  {
+    WorkStealingDeque & mydeque = deques[ti.thread_nr];
+    FlatArray<int> myvictims = victims[ti.thread_nr];
+    size_t last_victim = 0;
+    
+    try
+      {
+        while (!job_aborted.load(memory_order_relaxed))
+          {
+            int task;
+            if (!mydeque.Pop(task))
+              {
+                // own work done, steal from the others.
+                // tasks are never added during a job, so one
+                // unsuccessful sweep over all victims finishes
+                bool found = false;
+                for (size_t k = 0; k < myvictims.Size(); k++)
+                  {
+                    size_t v = (last_victim+k) % myvictims.Size();
+                    if (deques[myvictims[v]].Steal(task))
+                      {
+                        last_victim = v;
+                        found = true;
+                        break;
+                      }
+                  }
+                if (!found) break;
+              }
+            
+            ti.task_nr = task;
+            ti.ntasks = ntasks;
+            
+            {
+              RegionTracer t(ti.thread_nr, jobnr, RegionTracer::ID_JOB, ti.task_nr);
+              (*func)(ti);
+            }
+          }
+      }
+    catch (Exception e)
+      {
+        {
+          lock_guard<mutex> guard(copyex_mutex);
+          delete ex;
+          ex = new Exception (e);
+          job_aborted = true;
+        }
+      }
+  }
+
   /*
   int TaskManager :: GetThreadId()
   {
@@ -351,9 +440,11 @@ namespace ngstd
 
     ntasks.store (antasks); // , memory_order_relaxed);
     ex = nullptr;
+    job_aborted.store (false, memory_order_relaxed);
 
-
-    nodedata[0]->start_cnt.store (0, memory_order_relaxed);
+    // all workers have left the previous job, nobody touches the deques
+    for (int i = 0; i < num_threads; i++)
+      deques[i].Reset (Range(antasks).Split (i, num_threads));
 
     jobnr++;
     
@@ -362,45 +453,13 @@ namespace ngstd
 
     if (startup_function) (*startup_function)();
     
-    int thd = 0;
-    int thds = GetNumThreads();
-    int mynode = num_nodes * thd/thds;
-
-    IntRange mytasks = Range(int(ntasks)).Split (mynode, num_nodes);
-    NodeData & mynode_data = *(nodedata[mynode]);
-
     TaskInfo ti;
-    ti.nthreads = thds;
-    ti.thread_nr = thd;
+    ti.nthreads = GetNumThreads();
+    ti.thread_nr = 0;
     // ti.nnodes = num_nodes;
     // ti.node_nr = mynode;
 
-    try
-      {
-        while (1)
-          {
-            int mytask = mynode_data.start_cnt++;
-            if (mytask >= mytasks.Size()) break;
-            
-            ti.task_nr = mytasks.First()+mytask;
-            ti.ntasks = ntasks;
-
-            {
-              RegionTracer t(ti.thread_nr, jobnr, RegionTracer::ID_JOB, ti.task_nr);
-              (*func)(ti); 
-            }
-          }
-
-      }
-    catch (Exception e)
-      {
-        {
-          lock_guard<mutex> guard(copyex_mutex);
-          delete ex;
-          ex = new Exception (e);
-          mynode_data.start_cnt = mytasks.Size();
-        }
-      }
+    ProcessJobTasks (ti);
 
     if (cleanup_function) (*cleanup_function)();
     
@@ -499,37 +558,7 @@ namespace ngstd
 
         if (startup_function) (*startup_function)();
         
-        IntRange mytasks = Range(int(ntasks)).Split (mynode, num_nodes);
-          
-        try
-          {
-            
-            while (1)
-              {
-                if (mynode_data.start_cnt >= mytasks.Size()) break;
-		int mytask = mynode_data.start_cnt.fetch_add(1, memory_order_relaxed);
-                if (mytask >= mytasks.Size()) break;
-                
-                ti.task_nr = mytasks.First()+mytask;
-                ti.ntasks = ntasks;
-                
-                {
-                  RegionTracer t(ti.thread_nr, jobnr, RegionTracer::ID_JOB, ti.task_nr);
-                  (*func)(ti);
-                }
-              }
-
-          }
-        catch (Exception e)
-          {
-            {
-              // cout << "got exception in TM" << endl; 
-              lock_guard<mutex> guard(copyex_mutex);
-              delete ex;
-              ex = new Exception (e);
-              mynode_data.start_cnt = mytasks.Size();
-            }
-          }
+        ProcessJobTasks (ti);
 
 #ifndef __MIC__
         atomic_thread_fence (memory_order_release);     
@@ -550,11 +579,7 @@ namespace ngstd
                   mynode_data.participate |= 1;                  
                 }
               else
-                {
-                  if (mynode != 0)
-                    mynode_data.start_cnt = 0;
-                  complete[mynode] = jobnr.load(); 
-                }
+                complete[mynode] = jobnr.load(); 
 	    }	      
 	}
       }
@@ -29,6 +29,81 @@ namespace ngstd
     // int nnodes;
   };
 
+
+
+  /*
+    Chase-Lev work-stealing deque of task numbers.
+
+    The owning thread pops from the bottom, other threads steal from
+    the top. Tasks are filled in by Reset while no thread works on the
+    deque (i.e. between two jobs), so the buffer is never written
+    concurrently and does not need to grow during a job.
+  */
+  class alignas(64) WorkStealingDeque : public AlignedAlloc<WorkStealingDeque>
+  {
+    atomic<int64_t> top{0};
+    atomic<int64_t> bottom{0};
+    Array<int> tasks;
+  public:
+    // fill with tasks r, the owner will process them in ascending order
+    void Reset (T_Range<int> r)
+    {
+      if (tasks.Size() < size_t(r.Size()))
+        tasks.SetSize (r.Size());
+      int64_t n = r.Size();
+      for (int64_t i = 0; i < n; i++)
+        tasks[i] = r.Next()-1-i;
+      top.store (0, memory_order_relaxed);
+      bottom.store (n, memory_order_release);
+    }
+
+    // owner only
+    bool Pop (int & task)
+    {
+      int64_t b = bottom.load(memory_order_relaxed) - 1;
+      bottom.store (b, memory_order_relaxed);
+      atomic_thread_fence (memory_order_seq_cst);
+      int64_t t = top.load(memory_order_relaxed);
+      if (t > b)
+        { // empty
+          bottom.store (b+1, memory_order_relaxed);
+          return false;
+        }
+      task = tasks[b];
+      if (t == b)
+        { // last one, race against thieves
+          bool won = top.compare_exchange_strong (t, t+1, memory_order_seq_cst,
+                                                  memory_order_relaxed);
+          bottom.store (b+1, memory_order_relaxed);
+          return won;
+        }
+      return true;
+    }
+
+    // any thread. returns false if the deque is (seen) empty,
+    // a lost race is retried
+    bool Steal (int & task)
+    {
+      while (true)
+        {
+          int64_t t = top.load(memory_order_acquire);
+          atomic_thread_fence (memory_order_seq_cst);
+          int64_t b = bottom.load(memory_order_acquire);
+          if (t >= b) return false;
+          task = tasks[t];
+          if (top.compare_exchange_strong (t, t+1, memory_order_seq_cst,
+                                           memory_order_relaxed))
+            return true;
+        }
+    }
+
+    bool Empty () const
+    {
+      return top.load(memory_order_acquire) >= bottom.load(memory_order_acquire);
+    }
+  };
+
+  
   NGS_DLL_HEADER extern class TaskManager * task_manager;
   
   class TaskManager
@@ -38,7 +113,6 @@ namespace ngstd
     class alignas(64) NodeData : public AlignedAlloc<NodeData>
     {
     public:
-      atomic<int> start_cnt{0};
       atomic<int> participate{0};
     };
     
@@ -60,6 +134,12 @@ namespace ngstd
 
     static NodeData *nodedata[8];
 
+    // one deque per thread, tasks of a job are pre-distributed in
+    // contiguous blocks, idle threads steal (same NUMA node first)
+    static WorkStealingDeque * deques;
+    static Array<int> * victims;     // steal order per thread
+    static atomic<bool> job_aborted;
+
     static int num_nodes;
     NGS_DLL_HEADER static int num_threads;
     NGS_DLL_HEADER static int max_threads;
@@ -110,6 +190,10 @@ namespace ngstd
     void Loop(int thread_num);
 
     static list<tuple<string,double>> Timing ();
+
+  private:
+    static void ProcessJobTasks (TaskInfo & ti);
+    static void SetupVictims ();
   };
 
 
@@ -4,7 +4,20 @@ from ngsolve import Projector, Norm
 from ngsolve.ngstd import Timer
 import ngsolve
 
-def CG(mat, rhs, pre=None, sol=None, tol=1e-12, maxsteps = 100, printrates = True, initialize = True, conjugate=False):
+def _IsComplex(vec):
+    return isinstance(vec.FV(), ngsolve.bla.FlatVectorC)
+
+def _SolveCorrection(solver, mat, rhs, sol, initialize):
+    """applies a solver, which starts from zero, to the residual of the start vector"""
+    u = sol if sol else rhs.CreateVector()
+    if initialize or not sol: u[:] = 0.0
+    r = rhs.CreateVector()
+    r.data = rhs - mat * u
+    u.data += solver * r
+    return u
+
+def CG(mat, rhs, pre=None, sol=None, tol=1e-12, maxsteps = 100, printrates = True, initialize = True, conjugate=False,
+       pipelined=False, sstep=1):
     """preconditioned conjugate gradient method
 
 
@@ -38,6 +51,14 @@ def CG(mat, rhs, pre=None, sol=None, tol=1e-12, maxsteps = 100, printrates = Tru
     conjugate : bool
       If set to True, then the complex inner product is used.
 
+    pipelined : bool
+      If set to True, the pipelined CG of the C++ library is used. Both inner products of an
+      iteration share one global reduction, which overlaps preconditioner and matrix-vector product.
+
+    sstep : int
+      If larger than 1, the s-step CG of the C++ library is used, with one global reduction per
+      sstep iterations.
+
 
     Returns
     -------
@@ -46,6 +67,14 @@ def CG(mat, rhs, pre=None, sol=None, tol=1e-12, maxsteps = 100, printrates = Tru
 
     """
 
+    if pipelined or sstep > 1:
+        if conjugate and _IsComplex(rhs):
+            raise Exception("CG: pipelined and s-step CG need a bilinear inner product")
+        solver = ngsolve.la.CGSolver(mat, pre if pre else ngsolve.IdentityMatrix(len(rhs), _IsComplex(rhs)),
+                                     printrates=printrates, precision=tol, maxsteps=maxsteps,
+                                     pipelined=pipelined, sstep=sstep)
+        return _SolveCorrection(solver, mat, rhs, sol, initialize)
+
     timer = Timer("CG-Solver")
     timer.Start()
     u = sol if sol else rhs.CreateVector()
@@ -487,7 +516,7 @@ def PreconditionedRichardson(a, rhs, pre=None, freedofs=None, maxit=100, tol=1e-
 
 
 def GMRes(A, b, pre=None, freedofs=None, x=None, maxsteps = 100, tol = 1e-7, innerproduct=None,
-          callback=None, restart=None, startiteration=0, printrates=True):
+          callback=None, restart=None, startiteration=0, printrates=True, sstep=1):
     """ Restarting preconditioned gmres solver for A*x=b. Minimizes the preconditioned
 residuum pre*(b-A*x)
 
@@ -534,8 +563,16 @@ startiteration : int = 0
 
 printrates : bool = True
   Print norm of preconditioned residual in each step.
+
+sstep : int = 1
+  If larger than 1, the s-step GMRES of the C++ library is used. The Krylov basis grows by
+  blocks of sstep vectors with two global reductions per block. Cannot be combined with
+  innerproduct, callback or restart.
 """
 
+    if sstep > 1 and (innerproduct or callback or restart):
+        raise Exception("GMRes: sstep cannot be combined with innerproduct, callback or restart")
+
     if not innerproduct:
         innerproduct = lambda x,y: y.InnerProduct(x, conjugate=True)
         norm = ngsolve.Norm
@@ -551,6 +588,19 @@ printrates : bool = True
         x = b.CreateVector()
         x[:] = 0
 
+    if sstep > 1:
+        # the C++ solver stops relative to the preconditioned start residual
+        tmp = b.CreateVector()
+        r = b.CreateVector()
+        tmp.data = b - A * x
+        r.data = pre * tmp
+        r_norm = norm(r)
+        if r_norm <= tol:
+            return x
+        solver = ngsolve.la.GMRESSolver(A, pre, printrates=printrates, precision=tol/r_norm,
+                                        maxsteps=maxsteps, sstep=sstep)
+        return _SolveCorrection(solver, A, b, x, False)
+
     if callback:
         xstart = x.CreateVector()
         xstart.data = x
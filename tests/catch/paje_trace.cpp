@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include <ngstd.hpp>
+
+using namespace ngstd;
+
+TEST_CASE ("JSONString", "[paje]")
+{
+  stringstream str;
+  JSONString (str, string("a\"b\\c\nd\x01"));
+  CHECK(str.str() == "\"a\\\"b\\\\c\\nd\\u0001\"");
+}
+
+TEST_CASE ("RingBuffer", "[paje]")
+{
+  PajeTrace::SetRingBuffer(true);
+  {
+    PajeTrace tr(1);
+    tr.max_num_events_per_thread = 4;
+
+    auto outer = tr.StartTask(0, 1);
+    for (int i = 0; i < 10; i++)
+      {
+        auto h = tr.StartTask(0, 100+i);
+        tr.StopTask(0, h);
+      }
+    // the buffer wrapped, and keeps the latest tasks
+    REQUIRE(tr.tasks[0].Size() == 4);
+    for (auto & task : tr.tasks[0])
+      CHECK(task.id >= 106);
+
+    // the slot of the outer task is reused, stopping it must not touch the new task
+    auto last = tr.StartTask(0, 200);
+    Array<PajeTrace::TTimePoint> stop_times;
+    for (auto & task : tr.tasks[0])
+      stop_times.Append (task.stop_time);
+    tr.StopTask(0, outer);
+    tr.SetTask(0, outer, 42);
+    for (size_t i = 0; i < stop_times.Size(); i++)
+      {
+        CHECK(tr.tasks[0][i].stop_time == stop_times[i]);
+        CHECK(tr.tasks[0][i].additional_value != 42);
+      }
+
+    tr.StopTask(0, last);
+    int found = 0;
+    for (auto & task : tr.tasks[0])
+      if (task.id == 200)
+        {
+          found++;
+          CHECK(task.stop_time >= task.start_time);
+        }
+    CHECK(found == 1);
+  }
+  PajeTrace::SetRingBuffer(false);
+}
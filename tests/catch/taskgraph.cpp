@@ -0,0 +1,85 @@
+#include "catch.hpp"
+#include <ngstd.hpp>
+
+using namespace ngstd;
+
+TEST_CASE ("TaskGraph order", "[taskgraph]")
+{
+  TaskManager::SetNumThreads(4);
+  RunWithTaskManager ([] ()
+  {
+    for (int run = 0; run < 20; run++)
+      {
+        atomic<int> counter(0);
+        int order[5];
+        auto record = [&] (int k) { return [&,k] () { order[k] = counter++; }; };
+
+        TaskGraph graph;
+        auto a = graph.Add (record(0));
+        auto b = graph.Add (record(1), { a });
+        auto c = graph.Add (record(2), { a });
+        auto d = graph.Add (record(3), { b, c });
+        d.Then (record(4));
+        graph.Run();
+
+        CHECK(counter == 5);
+        CHECK(order[0] < order[1]);
+        CHECK(order[0] < order[2]);
+        CHECK(order[1] < order[3]);
+        CHECK(order[2] < order[3]);
+        CHECK(order[3] < order[4]);
+      }
+  });
+}
+
+TEST_CASE ("TaskGraph nested ParallelFor", "[taskgraph]")
+{
+  TaskManager::SetNumThreads(4);
+  RunWithTaskManager ([] ()
+  {
+    size_t n = 10000;
+    Array<size_t> sums(8);
+    sums = 0;
+    size_t total = 0;
+
+    TaskGraph graph;
+    Array<TaskGraph::TaskHandle> parts;
+    for (int k = 0; k < 8; k++)
+      parts.Append (graph.Add ([&,k] ()
+        {
+          ParallelFor (n, [&] (size_t i) { AsAtomic(sums[k]) += i; });
+        }));
+    auto final = graph.Add ([&] () { for (auto s : sums) total += s; });
+    for (auto p : parts)
+      graph.AddDependency (p, final);
+    graph.Run();
+
+    for (auto s : sums)
+      CHECK(s == n*(n-1)/2);
+    CHECK(total == 8*n*(n-1)/2);
+  });
+}
+
+TEST_CASE ("TaskGraph exception", "[taskgraph]")
+{
+  TaskManager::SetNumThreads(4);
+  RunWithTaskManager ([] ()
+  {
+    atomic<int> done(0);
+    bool after = false;
+    TaskGraph graph;
+    for (int k = 0; k < 10; k++)
+      graph.Add ([&] () { done++; });
+    auto fail = graph.Add ([] () { throw Exception ("task failed"); });
+    fail.Then ([&] () { after = true; });
+
+    // returns instead of waiting for the successors forever
+    CHECK_THROWS_AS (graph.Run(), Exception);
+    CHECK(!after);
+
+    // the task manager is usable again
+    done = 0;
+    ParallelFor (100, [&] (size_t i) { done++; });
+    CHECK(done == 100);
+  });
+}
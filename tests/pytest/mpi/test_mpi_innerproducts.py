@@ -0,0 +1,68 @@
+# run with: mpirun -np 4 ngspy -m pytest test_mpi_innerproducts.py
+# also passes on a single rank, with non-parallel vectors
+
+import os
+from ngsolve import *
+from netgen.geom2d import unit_square
+import netgen.meshing as netgen
+
+comm = MPI_Init()
+
+
+def test_inner_products_repeated_vectors():
+    meshfile = "mpi_innerproducts.vol"
+    if comm.rank == 0:
+        unit_square.GenerateMesh(maxh=0.1).Save(meshfile)
+    comm.Barrier()
+    ngmesh = netgen.Mesh(dim=2)
+    ngmesh.Load(meshfile)
+    mesh = Mesh(ngmesh)
+
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    m = BilinearForm(fes)
+    m += SymbolicBFI(u*v)
+    m.Assemble()
+
+    gfa = GridFunction(fes)
+    gfa.Set(x*y+1)
+    gfb = GridFunction(fes)
+    gfb.Set(x-y*y)
+
+    # a, b cumulated, d distributed
+    a = gfa.vec.CreateVector()
+    b = gfa.vec.CreateVector()
+    d = gfa.vec.CreateVector()
+    def reset():
+        a.data = gfa.vec
+        b.data = gfb.vec
+        d.data = m.mat * gfb.vec
+
+    # vectors in several pairs, and on both sides of a pair
+    pairs = [(a, d), (d, a), (a, a), (d, d), (a, b), (b, a), (d, b), (b, b)]
+
+    ref = []
+    for xi, yi in pairs:
+        reset()
+        ref.append(InnerProduct(xi, yi))
+
+    reset()
+    ips = InnerProducts([p[0] for p in pairs], [p[1] for p in pairs])
+    for ip, r in zip(ips, ref):
+        assert abs(ip - r) < 1e-10 * (1 + abs(r))
+
+    # the values of the vectors are unchanged
+    reset()
+    ref_values = [InnerProduct(vec, vec) for vec in [a, b, d]]
+    reset()
+    InnerProducts([a, d, d], [d, a, d])
+    for vec, r in zip([a, b, d], ref_values):
+        assert abs(InnerProduct(vec, vec) - r) < 1e-10 * (1 + abs(r))
+
+    comm.Barrier()
+    if comm.rank == 0:
+        os.remove(meshfile)
+
+
+if __name__ == "__main__":
+    test_inner_products_repeated_vectors()
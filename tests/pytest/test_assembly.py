@@ -0,0 +1,75 @@
+from netgen.geom2d import unit_square
+from netgen.csg import unit_cube
+from ngsolve import *
+from ngsolve.meshes import MakeStructuredMesh
+
+
+def compare_assembly(fes, cf, base={}, **flags):
+    u,v = fes.TnT()
+    a = BilinearForm(fes, **base)
+    a += SymbolicBFI(cf(u,v))
+    a.Assemble()
+    a2 = BilinearForm(fes, **base, **flags)
+    a2 += SymbolicBFI(cf(u,v))
+    a2.Assemble()
+    diff = a.mat.AsVector().CreateVector()
+    diff.data = a.mat.AsVector() - a2.mat.AsVector()
+    assert Norm(diff) < 1e-12 * Norm(a.mat.AsVector())
+    assert a.batched_elements == 0
+    return a2
+
+
+def test_batchassembly():
+    mesh2 = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    mesh3 = Mesh(unit_cube.GenerateMesh(maxh=0.3))
+    for mesh in [mesh2, mesh3]:
+        for order in [1,2,3]:
+            fes = H1(mesh, order=order)
+            compare_assembly(fes, lambda u,v: (1+x*y)*grad(u)*grad(v)+u*v, batchassembly=True)
+        fes = HCurl(mesh, order=1)
+        compare_assembly(fes, lambda u,v: curl(u)*curl(v)+(1+x)*u*v, batchassembly=True)
+
+    # coefficients depending on the element are left to the element loop
+    fes = H1(mesh2, order=1)
+    gf = GridFunction(fes)
+    gf.Set(x*x)
+    compare_assembly(fes, lambda u,v: (1+gf)*grad(u)*grad(v), batchassembly=True)
+
+    # many elements with equal vertex ordering per colour, they go through the batches
+    mesh = MakeStructuredMesh(hexes=False, nx=6)
+    fes = H1(mesh, order=1)
+    a = compare_assembly(fes, lambda u,v: (1+x*y)*grad(u)*grad(v)+u*v, batchassembly=True)
+    assert a.batched_elements > 0
+
+
+def test_blockassembly():
+    mesh2 = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    mesh3 = Mesh(unit_cube.GenerateMesh(maxh=0.2))
+    for mesh in [mesh2, mesh3]:
+        fes = H1(mesh, order=2)
+        form = lambda u,v: (1+x*y)*grad(u)*grad(v)+u*v
+        compare_assembly(fes, form, blockassembly=True)
+        compare_assembly(fes, form, base={"symmetric" : True}, blockassembly=True)
+        fes = H1(mesh, order=3)
+        compare_assembly(fes, form, base={"condense" : True}, blockassembly=True)
+
+
+def test_heap_growth():
+    # element matrices larger than the default heap of 1 MB per thread
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=1))
+    fes = H1(mesh, order=12)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+    a.Assemble()
+    gfu = GridFunction(fes)
+    gfu.Set(1)
+    res = gfu.vec.CreateVector()
+    res.data = a.mat * gfu.vec
+    assert Norm(res) < 1e-8 * Norm(gfu.vec)
+
+
+if __name__ == "__main__":
+    test_batchassembly()
+    test_blockassembly()
+    test_heap_growth()
@@ -78,8 +78,34 @@ def test_code_generation_derivatives():
         vals -= vals_ref
         assert Norm(vals) < 1e-13
 
+def test_interpreted_tape():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3)
+    gfu = GridFunction(fes)
+    gfu.Set(x*x+y)
+    u,v = fes.TnT()
+
+    # common subexpressions, constant subtrees and arithmetic around other steps
+    c = CoefficientFunction(2)*CoefficientFunction(3)-1
+    cf = (x+y)*(x+y)/c + sin(x+y)*(x+y) + c*c + (x-y)/(1+y) + gfu*gfu
+    f = cf.Compile()
+    assert Integrate((cf-f)*(cf-f), mesh) < 1e-13
+
+    # derivatives through the tape
+    cf = (u+u*u)*(u+u*u)/(1+x*x) + exp(u)*(u-1)
+    aref = BilinearForm(fes, symmetric=False)
+    aref += SymbolicEnergy(cf)
+    aref.AssembleLinearization(gfu.vec)
+    a = BilinearForm(fes, symmetric=False)
+    a += SymbolicEnergy(cf.Compile())
+    a.AssembleLinearization(gfu.vec)
+    vals = a.mat.AsVector()
+    vals -= aref.mat.AsVector()
+    assert Norm(vals) < 1e-10
+
 if __name__ == "__main__":
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
     test_code_generation_volume_terms_complex()
     test_code_generation_boundary_terms()
+    test_interpreted_tape()
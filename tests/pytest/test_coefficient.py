@@ -66,6 +66,20 @@ def test_domainwise_cf():
     c_true = c.Compile(True, wait=True);
     error_true = Integrate((c-c_true)*(c-c_true), mesh)
     assert abs(error_true) < 1e-14
+    assert c_true.IsCompiled()
+
+def test_compile_nowait():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    c = sin(x)*y + x*x
+    c_compiled = c.Compile(True, wait=False)
+    # evaluated by the interpreted steps while the compiler runs
+    error = Integrate((c-c_compiled)*(c-c_compiled), mesh)
+    assert abs(error) < 1e-14
+    c_compiled.WaitCompiled()
+    assert c_compiled.IsCompiled()
+    error = Integrate((c-c_compiled)*(c-c_compiled), mesh)
+    assert abs(error) < 1e-14
+    assert not c.Compile().IsCompiled()
 
 def test_evaluate():
     from netgen.geom2d import unit_square
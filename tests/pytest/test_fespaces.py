@@ -32,3 +32,101 @@ def test_GetFE():
                 for el in space.Elements(vb):
                     assert space.GetFE(el).ndof == len(space.GetDofNrs(el)), [spacename,vb,order]
                     
+
+
+def test_reorder():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+
+    def solve(fes):
+        u,v = fes.TnT()
+        a = BilinearForm(fes, symmetric=True)
+        a += SymbolicBFI(grad(u)*grad(v))
+        a.Assemble()
+        f = LinearForm(fes)
+        f += SymbolicLFI(x*v)
+        f.Assemble()
+        gfu = GridFunction(fes)
+        gfu.Set(y, BND)
+        f.vec.data -= a.mat * gfu.vec
+        gfu.vec.data += a.mat.Inverse(fes.FreeDofs()) * f.vec
+        rows,cols,vals = a.mat.COO()
+        bandwidth = max(abs(r-c) for r,c in zip(rows,cols))
+        return gfu, bandwidth
+
+    fes = H1(mesh, order=3, dirichlet=[1,2])
+    gfu, bw = solve(fes)
+    for method in ["rcm", "sfc"]:
+        gfu2, bw2 = solve(Reorder(fes, method=method))
+        assert sqrt(Integrate((gfu-gfu2)**2, mesh)) < 1e-10
+        if method == "rcm":
+            assert bw2 < bw
+
+
+def test_shape_cache():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    p = x**3*y + z**2*x - y*z**3
+    dp = CoefficientFunction((3*x**2*y + z**2, x**3 - z**3, 2*z*x - 3*y*z**2))
+    for fes in [H1(mesh, order=4), L2(mesh, order=4)]:
+        u,v = fes.TnT()
+        gfu = GridFunction(fes)
+        # repeated runs use the shape tables of the first one
+        for i in range(2):
+            gfu.Set(p)
+            assert sqrt(Integrate((gfu-p)**2, mesh)) < 1e-10
+            assert sqrt(Integrate((grad(gfu)-dp)**2, mesh)) < 1e-10
+        a = BilinearForm(fes)
+        a += SymbolicBFI(grad(u)*grad(v))
+        a.Assemble()
+        energy = InnerProduct(gfu.vec, a.mat * gfu.vec)
+        assert abs(energy - Integrate(dp*dp, mesh, order=6)) < 1e-8
+
+
+def test_shape_cache_hcurl_hdiv():
+    from netgen.csg import unit_cube
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    e = CoefficientFunction((y**2*z, x*z**3, x**2*y))
+    curle = CoefficientFunction((x**2 - 3*x*z**2, y**2 - 2*x*y, z**3 - 2*y*z))
+    q = CoefficientFunction((x*y**2, y*z**2 + x**3, z*x**2))
+    divq = x**2 + y**2 + z**2
+    for fes, cf, Dcf, D in [(HCurl(mesh, order=4), e, curle, curl),
+                            (HDiv(mesh, order=4), q, divq, div)]:
+        u,v = fes.TnT()
+        gfu = GridFunction(fes)
+        # repeated runs use the shape tables of the first one
+        for i in range(2):
+            gfu.Set(cf)
+            assert sqrt(Integrate((gfu-cf)**2, mesh)) < 1e-10
+            assert sqrt(Integrate((D(gfu)-Dcf)**2, mesh)) < 1e-10
+        a = BilinearForm(fes)
+        a += SymbolicBFI(u*v + D(u)*D(v))
+        a.Assemble()
+        energy = InnerProduct(gfu.vec, a.mat * gfu.vec)
+        assert abs(energy - Integrate(cf*cf + Dcf*Dcf, mesh, order=8)) < 1e-8
+
+
+def test_shape_cache_control():
+    from netgen.csg import unit_cube
+    from ngsolve.fem import SetShapeCache, ClearShapeCache, ShapeCacheMemory
+    mesh = Mesh(unit_cube.GenerateMesh(maxh=0.4))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    def assemble():
+        a = BilinearForm(fes)
+        a += SymbolicBFI(grad(u)*grad(v))
+        a.Assemble()
+        return a.mat.AsVector()
+    ClearShapeCache()
+    assert ShapeCacheMemory() == 0
+    cached = assemble()
+    assert ShapeCacheMemory() > 0
+    try:
+        SetShapeCache(enable=False)
+        ClearShapeCache()
+        uncached = assemble()
+        assert ShapeCacheMemory() == 0
+    finally:
+        SetShapeCache()
+    diff = cached.CreateVector()
+    diff.data = cached - uncached
+    assert Norm(diff) < 1e-12 * Norm(cached)
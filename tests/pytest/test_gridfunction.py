@@ -0,0 +1,48 @@
+import pytest
+from netgen.geom2d import unit_square
+from ngsolve import *
+
+def reordered_mesh(ngmesh):
+    """same vertices, but elements in reverse order with rotated vertices,
+    such that edges and elements are numbered differently"""
+    from netgen.meshing import Mesh as NetgenMesh, MeshPoint, Element2D, FaceDescriptor, Pnt
+    newmesh = NetgenMesh(dim=2)
+    for p in ngmesh.Points():
+        newmesh.Add(MeshPoint(Pnt(p[0], p[1], p[2])))
+    newmesh.Add(FaceDescriptor(surfnr=1, domin=1, bc=1))
+    for el in reversed(list(ngmesh.Elements2D())):
+        v = el.vertices
+        newmesh.Add(Element2D(1, [v[1], v[2], v[0]]))
+    return Mesh(newmesh)
+
+def test_save_chunked(tmp_path):
+    ngmesh = unit_square.GenerateMesh(maxh=0.2)
+    mesh = Mesh(ngmesh)
+    fes = H1(mesh, order=3)
+    gf = GridFunction(fes)
+    gf.Set(sin(3*x)*y+x*x)
+    filename = str(tmp_path / "gf.chunked")
+    gf.Save(filename, chunked=True)
+
+    gf2 = GridFunction(fes)
+    gf2.Load(filename, chunked=True)
+    assert Norm(gf.vec-gf2.vec) == 0
+
+    mesh3 = reordered_mesh(ngmesh)
+    assert mesh3.nv == mesh.nv and mesh3.ne == mesh.ne
+    gf3 = GridFunction(H1(mesh3, order=3))
+    gf3.Load(filename, chunked=True)
+    for p in [(0.1,0.2), (0.5,0.5), (0.83,0.37)]:
+        assert abs(gf(mesh(*p)) - gf3(mesh3(*p))) < 1e-12
+
+def test_save_chunked_nodeless_dofs(tmp_path):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    gf = GridFunction(H1(mesh, order=2)*NumberSpace(mesh))
+    with pytest.raises(Exception):
+        gf.Save(str(tmp_path / "gf.chunked"), chunked=True)
+
+if __name__ == "__main__":
+    import pathlib, tempfile
+    with tempfile.TemporaryDirectory() as d:
+        test_save_chunked(pathlib.Path(d))
+        test_save_chunked_nodeless_dofs(pathlib.Path(d))
@@ -99,7 +99,234 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_sellmatrix():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    for symmetric in [False, True]:
+        a = BilinearForm(fes, symmetric=symmetric)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v + 0.1*grad(u)[0]*v)
+        a.Assemble()
+        sell = SELLMatrix(a.mat, sigma=32)
+        x = a.mat.CreateColVector()
+        for i in range(len(x)):
+            x[i] = i % 7 - 3
+        y1 = x.CreateVector()
+        y2 = x.CreateVector()
+        y1.data = a.mat * x
+        y2.data = sell * x
+        y2.data -= y1
+        assert Norm(y2) < 1e-12 * Norm(y1)
+
+def test_sparsematrixfloat():
+    mesh = Mesh("square.vol.gz")
+    fes = H1(mesh, order=2, dirichlet=[1])
+    u,v = fes.TnT()
+    for symmetric in [False, True]:
+        a = BilinearForm(fes, symmetric=symmetric)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v)
+        a.Assemble()
+        fmat = SparseMatrixFloat(a.mat)
+        x = a.mat.CreateColVector()
+        for i in range(len(x)):
+            x[i] = i % 7 - 3
+        y1 = x.CreateVector()
+        y2 = x.CreateVector()
+        y1.data = a.mat * x
+        y2.data = fmat * x
+        y2.data -= y1
+        assert Norm(y2) < 1e-6 * Norm(y1)
+
+        # float smoothers as preconditioners in a double precision solver
+        blocks = [ [d for d in el.dofs if fes.FreeDofs()[d]] for el in fes.Elements() ]
+        for pre in [fmat.CreateSmoother(fes.FreeDofs()), fmat.CreateBlockSmoother(blocks)]:
+            inv = CGSolver(a.mat, pre, printrates=False, precision=1e-10, maxsteps=500)
+            f = x.CreateVector()
+            f.data = a.mat * x
+            for i, free in enumerate(fes.FreeDofs()):
+                if not free:
+                    f[i] = 0
+            u1 = x.CreateVector()
+            u1.data = inv * f
+            u2 = x.CreateVector()
+            u2.data = a.mat.Inverse(fes.FreeDofs()) * f
+            u2.data -= u1
+            assert Norm(u2) < 1e-6 * Norm(u1)
+
+        # Gauss-Seidel sweeps agree with the double smoother
+        f = x.CreateVector()
+        f.data = a.mat * x
+        u1 = x.CreateVector()
+        u2 = x.CreateVector()
+        u1[:] = 0
+        u2[:] = 0
+        for pre, u in [(a.mat.CreateSmoother(fes.FreeDofs()), u1), (fmat.CreateSmoother(fes.FreeDofs()), u2)]:
+            pre.Smooth(u, f)
+            pre.SmoothBack(u, f)
+        u2.data -= u1
+        assert Norm(u2) < 1e-5 * Norm(u1)
+
+        # block Gauss-Seidel reduces the residual
+        pre = fmat.CreateBlockSmoother(blocks)
+        u1[:] = 0
+        r = x.CreateVector()
+        r.data = f - a.mat * u1
+        res0 = Norm(r)
+        for it in range(5):
+            pre.Smooth(u1, f)
+            pre.SmoothBack(u1, f)
+        r.data = f - a.mat * u1
+        for i, free in enumerate(fes.FreeDofs()):
+            if not free:
+                r[i] = 0
+        assert Norm(r) < 0.5 * res0
+
+def test_bsrmatrix():
+    mesh = Mesh("cube.vol.gz")
+    fes = VectorH1(mesh, order=2, dirichlet=[1])
+    u,v = fes.TnT()
+    for symmetric in [False, True]:
+        mats = []
+        for blocksparse in [False, True]:
+            a = BilinearForm(fes, symmetric=symmetric, blocksparse=blocksparse)
+            a += SymbolicBFI(InnerProduct(grad(u),grad(v)) + Trace(grad(u))*Trace(grad(v)) + u*v)
+            a.Assemble()
+            mats.append(a.mat)
+        assert isinstance(mats[1], BSRMatrix)
+        x = mats[0].CreateColVector()
+        for i in range(len(x)):
+            x[i] = i % 7 - 3
+        y1 = x.CreateVector()
+        y2 = x.CreateVector()
+        y1.data = mats[0] * x
+        y2.data = mats[1] * x
+        y2.data -= y1
+        assert Norm(y2) < 1e-12 * Norm(y1)
+
+        # point-block smoother, direct solver on the scalar copy
+        f = x.CreateVector()
+        f.data = mats[0] * x
+        for i, free in enumerate(fes.FreeDofs()):
+            if not free:
+                f[i] = 0
+        inv = CGSolver(mats[1], mats[1].CreateSmoother(fes.FreeDofs()), printrates=False, precision=1e-10, maxsteps=500)
+        u1 = x.CreateVector()
+        u1.data = inv * f
+        u2 = x.CreateVector()
+        u2.data = mats[1].Inverse(fes.FreeDofs()) * f
+        u2.data -= u1
+        assert Norm(u2) < 1e-6 * Norm(u1)
+
+def test_sparsecholesky_multifrontal():
+    mesh = Mesh("cube.vol.gz")
+    fes = H1(mesh, order=3, dirichlet=[1])
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    f = a.mat.CreateColVector()
+    for i in range(len(f)):
+        f[i] = i % 7 - 3 if fes.FreeDofs()[i] else 0
+    u1 = f.CreateVector()
+    u2 = f.CreateVector()
+    u1.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f
+    SetSparseCholeskyOptions(multifrontal=True)
+    try:
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+    finally:
+        SetSparseCholeskyOptions(multifrontal=False)
+    u2.data = inv * f
+    u2.data -= u1
+    assert Norm(u2) < 1e-10 * Norm(u1)
+
+    # refactorization keeps the mode
+    a.Assemble()
+    inv.Update()
+    u2.data = inv * f
+    u2.data -= u1
+    assert Norm(u2) < 1e-10 * Norm(u1)
+
+def test_sparsecholesky_nested_dissection():
+    mesh = Mesh("cube.vol.gz")
+    fes = H1(mesh, order=3, dirichlet=[1])
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    f = a.mat.CreateColVector()
+    for i in range(len(f)):
+        f[i] = i % 7 - 3 if fes.FreeDofs()[i] else 0
+    u1 = f.CreateVector()
+    u2 = f.CreateVector()
+    u1.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f
+    for mf in [False, True]:
+        SetSparseCholeskyOptions(nested_dissection=True, multifrontal=mf)
+        try:
+            inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+        finally:
+            SetSparseCholeskyOptions(nested_dissection=False, multifrontal=False)
+        u2.data = inv * f
+        u2.data -= u1
+        assert Norm(u2) < 1e-10 * Norm(u1)
+
+def test_multivector():
+    mesh = Mesh("cube.vol.gz")
+    fes = H1(mesh, order=3, dirichlet=[1])
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+
+    f = MultiVector(a.mat.CreateColVector(), 5)
+    u = MultiVector(a.mat.CreateColVector(), 5)
+    for k in range(len(f)):
+        for i in range(len(f[k])):
+            f[k][i] = (i*(k+1)) % 7 - 3
+    # block solve and default column by column product
+    for mat in [inv, a.mat]:
+        mat.Mult(f, u)
+        w = f[0].CreateVector()
+        for k in range(len(f)):
+            w.data = mat * f[k]
+            w.data -= u[k]
+            assert Norm(w) < 1e-10 * Norm(u[k])
+
+def test_sparsecholesky_reuse_symbolic():
+    mesh = Mesh("cube.vol.gz")
+    fes = H1(mesh, order=3, dirichlet=[1])
+    u,v = fes.TnT()
+    c = Parameter(1)
+    a = BilinearForm(fes, symmetric=True)
+    a += SymbolicBFI(grad(u)*grad(v)+c*u*v)
+    inv = None
+    for val in [1, 10, 100]:
+        c.Set(val)
+        a.Assemble()
+        f = a.mat.CreateColVector()
+        for i in range(len(f)):
+            f[i] = i % 7 - 3 if fes.FreeDofs()[i] else 0
+        u1 = f.CreateVector()
+        u2 = f.CreateVector()
+        # second and third factorization reuse the ordering of the previous inverse
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+        u1.data = inv * f
+        SetSparseCholeskyOptions(reuse_symbolic=False)
+        try:
+            u2.data = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky") * f
+        finally:
+            SetSparseCholeskyOptions(reuse_symbolic=True)
+        u2.data -= u1
+        assert Norm(u2) < 1e-10 * Norm(u1)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_sellmatrix()
+    test_sparsematrixfloat()
+    test_bsrmatrix()
+    test_sparsecholesky_multifrontal()
+    test_sparsecholesky_nested_dissection()
+    test_multivector()
+    test_sparsecholesky_reuse_symbolic()
@@ -0,0 +1,81 @@
+from netgen.geom2d import unit_square
+from ngsolve import *
+from ngsolve.meshes import MakeStructuredMesh
+
+
+def compare_matrixfree(mesh, fes, cf):
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(cf(u,v))
+    a.Assemble()
+    amf = BilinearForm(fes, nonassemble=True, matrixfree=True)
+    amf += SymbolicBFI(cf(u,v))
+    amf.Assemble()
+    # the quads and hexes go through the sum-factorized kernel
+    assert amf.matrixfree_elements > 0
+    assert a.matrixfree_elements == 0
+
+    x = a.mat.CreateColVector()
+    for i in range(len(x)):
+        x[i] = (i % 13) / 13 - 0.5
+    y = x.CreateVector()
+    ymf = x.CreateVector()
+    y.data = a.mat * x
+    ymf.data = amf.mat * x
+    ymf.data -= y
+    assert Norm(ymf) < 1e-10 * Norm(y)
+    return amf
+
+
+def test_matrixfree_quad():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2, quad_dominated=True))
+    for order in [1,4]:
+        for space in [H1, L2]:
+            fes = space(mesh, order=order)
+            compare_matrixfree(mesh, fes, lambda u,v: (1+x*x)*grad(u)*grad(v)+u*v)
+
+
+def test_matrixfree_hex():
+    mesh = MakeStructuredMesh(hexes=True, nx=3, ny=3, nz=3,
+                              mapping = lambda x,y,z : (x+0.1*y*z, y, z+0.1*x*x))
+    for order in [2,3]:
+        fes = H1(mesh, order=order)
+        amf = compare_matrixfree(mesh, fes, lambda u,v: grad(u)*grad(v)+(1+y)*u*v)
+        assert amf.matrixfree_elements == mesh.ne
+        fes = L2(mesh, order=order)
+        amf = compare_matrixfree(mesh, fes, lambda u,v: u*v)
+        assert amf.matrixfree_elements == mesh.ne
+
+
+def test_matrixfree_geometry_cache():
+    mesh = MakeStructuredMesh(hexes=True, nx=3, ny=3, nz=3,
+                              mapping = lambda x,y,z : (x+0.1*y*z, y, z+0.1*x*x))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    amf = BilinearForm(fes, nonassemble=True, matrixfree=True)
+    amf += SymbolicBFI(grad(u)*grad(v)+(1+y)*u*v)
+    amf.Assemble()
+
+    x = amf.mat.CreateColVector()
+    for i in range(len(x)):
+        x[i] = (i % 13) / 13 - 0.5
+    yref = x.CreateVector()
+    yref.data = amf.mat * x
+
+    mesh.SetGeometryCache(memory=16)
+    y = x.CreateVector()
+    for i in range(2):
+        y.data = amf.mat * x
+        y.data -= yref
+        assert Norm(y) < 1e-12 * Norm(yref)
+    stats = mesh.GetGeometryCacheStatistics()
+    assert stats["hits"] > 0 and stats["memory"] <= stats["budget"]
+
+    mesh.SetGeometryCache(memory=0)
+    assert mesh.GetGeometryCacheStatistics() == {}
+
+
+if __name__ == "__main__":
+    test_matrixfree_quad()
+    test_matrixfree_hex()
+    test_matrixfree_geometry_cache()
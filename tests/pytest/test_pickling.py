@@ -183,6 +183,69 @@ def test_pickle_periodic():
     assert sqrt(Integrate((u-u2)*(u-u2),mesh)) < 1e-14
 
 
+def test_checkpoint_gridfunction(tmpdir):
+    from ngsolve.ngstd import CheckpointArchive
+    from ngsolve.comp import DoArchive
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=4)
+    u = GridFunction(fes)
+    u.Set(x*x*y)
+    for compress in [False, True]:
+        filename = str(tmpdir.join("u.ckpt"))
+        ar = CheckpointArchive(filename, write=True, compress=compress)
+        DoArchive(ar, u)
+        ar.Close()
+
+        u2 = GridFunction(fes)
+        DoArchive(CheckpointArchive(filename, write=False), u2)
+        assert max(abs(u.vec.FV().NumPy() - u2.vec.FV().NumPy())) == 0
+
+
+def test_checkpoint_mesh_matrix(tmpdir):
+    from ngsolve.ngstd import CheckpointArchive
+    from ngsolve.comp import DoArchive
+    import ngsolve.la
+    import netgen.meshing
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    filename = str(tmpdir.join("mesh.ckpt"))
+    ar = CheckpointArchive(filename, write=True)
+    DoArchive(ar, mesh)
+    ngsolve.la.DoArchive(ar, a.mat)
+    ar.Close()
+
+    ar = CheckpointArchive(filename, write=False)
+    mesh2 = Mesh(netgen.meshing.Mesh())
+    DoArchive(ar, mesh2)
+    assert mesh2.ne == mesh.ne and mesh2.nv == mesh.nv
+    assert abs(Integrate(x*y*y, mesh2) - Integrate(x*y*y, mesh)) < 1e-14
+    # same graph, other values
+    a2 = BilinearForm(fes)
+    a2 += SymbolicBFI(2*u*v)
+    a2.Assemble()
+    ngsolve.la.DoArchive(ar, a2.mat)
+    diff = a.mat.AsVector().CreateVector()
+    diff.data = a.mat.AsVector() - a2.mat.AsVector()
+    assert Norm(diff) == 0
+
+
+def test_save_chunked_gridfunction(tmpdir):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    for fes in [H1(mesh, order=3, dim=2), HCurl(mesh, order=2, complex=True)]:
+        u = GridFunction(fes)
+        u.vec.FV().NumPy()[:] = range(len(u.vec.FV()))
+        filename = str(tmpdir.join("u.gf"))
+        with TaskManager():
+            u.Save(filename, chunked=True)
+            u2 = GridFunction(fes)
+            u2.Load(filename, chunked=True)
+        assert max(abs(u.vec.FV().NumPy() - u2.vec.FV().NumPy())) == 0
+
+
 if __name__ == "__main__":
     test_pickle_volume_fespaces()
     test_pickle_surface_fespaces()
@@ -0,0 +1,85 @@
+import json
+from ngsolve import *
+from ngsolve.ngstd import Timer, EnableHierarchicalProfiler, HierarchicalTimers, WriteProfile
+from netgen.geom2d import unit_square
+
+
+def find(timer, name):
+    if timer["name"] == name:
+        return timer
+    for child in timer["children"]:
+        res = find(child, name)
+        if res:
+            return res
+
+
+def test_hierarchical_profiler(tmpdir):
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+
+    EnableHierarchicalProfiler(trace=True)
+    outer = Timer("test - outer")
+    outer.Start()
+    with TaskManager():
+        a = BilinearForm(fes)
+        a += SymbolicBFI(grad(u)*grad(v))
+        a.Assemble()
+    outer.Stop()
+    EnableHierarchicalProfiler(False)
+
+    tree = HierarchicalTimers()
+    tout = find(tree, "test - outer")
+    assert tout and tout["calls"] == 1
+    # assembly timers are nested below the outer timer
+    assert len(tout["children"]) > 0
+    for child in tout["children"]:
+        assert child["max"] >= child["mean"] >= child["min"]
+        assert child["time"] <= tout["time"] * 1.01
+
+    WriteProfile(str(tmpdir.join("prof.json")))
+    assert find(json.load(open(str(tmpdir.join("prof.json")))), "test - outer")
+    WriteProfile(str(tmpdir.join("trace.json")), format="chrome")
+    events = json.load(open(str(tmpdir.join("trace.json"))))["traceEvents"]
+    assert any(ev["name"] == "test - outer" for ev in events)
+
+
+def test_chrome_trace(tmpdir):
+    from ngsolve.ngstd import Tracer
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v))
+
+    # names have to be escaped in the json output
+    name = 'test "chrome" \\ trace'
+    timer = Timer(name)
+    with tmpdir.as_cwd():
+        Tracer.SetTraceFormat("chrome")
+        try:
+            with TaskManager(pajetrace=10**7):
+                timer.Start()
+                a.Assemble()
+                timer.Stop()
+                # the events after a flush continue the same file
+                Tracer.Flush()
+                a.Assemble()
+        finally:
+            Tracer.SetTraceFormat("paje")
+
+        files = tmpdir.listdir(fil="ng*.trace.json")
+        assert len(files) == 1
+        events = json.load(open(str(files[0])))["traceEvents"]
+        assert any(ev["name"] == name for ev in events)
+        assert any(ev["ph"] == "X" and ev["cat"] == "task" for ev in events)
+
+        Tracer.MergeChromeTraces([str(files[0]), str(files[0])], "merged.json")
+        merged = json.load(open("merged.json"))["traceEvents"]
+        assert len(merged) == 2 * len(events)
+
+
+if __name__ == "__main__":
+    import py
+    test_hierarchical_profiler(py.path.local.mkdtemp())
+    test_chrome_trace(py.path.local.mkdtemp())
@@ -43,6 +43,38 @@ def test_arnoldi():
     Draw(laplace(evec),mesh,"laplace")
 
 
+def test_communication_avoiding_krylov():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet="top|bottom|left|right")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += SymbolicBFI(grad(u)*grad(v)+u*v)
+    a.Assemble()
+    f = LinearForm(fes)
+    f += SymbolicLFI(x*v)
+    f.Assemble()
+    pre = a.mat.CreateSmoother(fes.FreeDofs())
+
+    ref = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    gfu = GridFunction(fes)
+    diff = gfu.vec.CreateVector()
+    for inv in [CGSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=1000, pipelined=True),
+                CGSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=1000, sstep=3),
+                GMRESSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=1000, sstep=4)]:
+        gfu.vec.data = inv * f.vec
+        diff.data = gfu.vec - ref
+        assert Norm(diff) < 1e-8 * Norm(gfu.vec)
+
+    # the same variants through the Python solvers
+    from ngsolve import solvers
+    for sol in [solvers.CG(a.mat, f.vec, pre, printrates=False, tol=1e-12, maxsteps=1000, pipelined=True),
+                solvers.CG(a.mat, f.vec, pre, printrates=False, tol=1e-12, maxsteps=1000, sstep=3),
+                solvers.GMRes(a.mat, f.vec, pre, printrates=False, tol=1e-14, maxsteps=1000, sstep=4)]:
+        diff.data = sol - ref
+        assert Norm(diff) < 1e-8 * Norm(sol)
+
+
 
 if __name__ == "__main__":
     test_arnoldi()
+    test_communication_avoiding_krylov()
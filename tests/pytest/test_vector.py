@@ -40,3 +40,42 @@ def test_vector_numpy():
     assert d[0] == c[0]
     d[1] = 1+3j
     assert d[1] == c[1]
+
+def fill_basevector(v, k, iscomplex):
+    for i in range(len(v)):
+        v[i] = ((i*k) % 17 - 8) / 8 + (1j*((i+k) % 5) if iscomplex else 0)
+
+def test_linear_combination():
+    # sizes beyond the kernel's block buffer, not a multiple of it
+    n = 1000
+    for iscomplex, coefs in [(False, [2, -0.5, 0.25]), (True, [2, -0.5j, 0.25+1j])]:
+        a = BaseVector(n, iscomplex)
+        b = BaseVector(n, iscomplex)
+        s = BaseVector(n, iscomplex)
+        for k, v in enumerate([a, b, s]):
+            fill_basevector(v, k+1, iscomplex)
+        ref = [coefs[0]*a[i] + coefs[1]*b[i] + coefs[2]*s[i] for i in range(n)]
+
+        # s appears among the terms: s = c0*a + c1*b + c2*s
+        s.SetLinearCombination(coefs, [a, b, s])
+        assert max(abs(s[i]-ref[i]) for i in range(n)) < 1e-14
+
+        # s += c0*a + c1*s
+        ref = [ref[i] + coefs[0]*a[i] + coefs[1]*ref[i] for i in range(n)]
+        s.SetLinearCombination(coefs[:2], [a, s], add=True)
+        assert max(abs(s[i]-ref[i]) for i in range(n)) < 1e-13
+
+def test_inner_products():
+    n = 1000
+    for iscomplex in [False, True]:
+        vecs = [BaseVector(n, iscomplex) for k in range(4)]
+        for k, v in enumerate(vecs):
+            fill_basevector(v, k+1, iscomplex)
+        x = [vecs[0], vecs[1], vecs[2], vecs[0]]
+        y = [vecs[3], vecs[2], vecs[2], vecs[0]]
+        for conjugate in [True, False]:
+            ips = InnerProducts(x, y, conjugate=conjugate)
+            assert len(ips) == len(x)
+            for xi, yi, ip in zip(x, y, ips):
+                ref = xi.InnerProduct(yi, conjugate=conjugate)
+                assert abs(ip - ref) < 1e-12 * (1 + abs(ref))
@@ -4,6 +4,7 @@ import socket
 import multiprocessing
 from ngsolve import *
 import json
+import itertools
 import os
 ngsglobals.msg_level=0
 
@@ -81,6 +82,36 @@ for mesh in meshes:
                     timings["FESpace"].append(tim)
 
 
+# sparse matrix-vector product, CSR vs SELL-C-sigma and single precision storage,
+# with mesh node ordering of dofs and with renumbered dofs
+timings.setdefault("SpMV", [])
+for mesh in meshes:
+    for order, dofs in itertools.product([1,2,4], ["mesh", "rcm", "sfc"]):
+        fes = H1(mesh, order=order)
+        if dofs != "mesh":
+            fes = Reorder(fes, method=dofs)
+        u,v = fes.TnT()
+        a = BilinearForm(fes)
+        a += SymbolicBFI(grad(u)*grad(v)+u*v)
+        a.Assemble()
+        for mat in [SELLMatrix(a.mat), SparseMatrixFloat(a.mat)]:
+            timing = Timing(name="spmv", obj=mat, parallel=args.parallel, serial=args.sequential)
+            for par, tims in [(0, timing.timings), (1, timing.timings_par)]:
+                if tims is None:
+                    continue
+                for t in tims:
+                    tim = {}
+                    tim['dimension'] = mesh.dim
+                    tim['order'] = order
+                    tim['ndof'] = fes.ndof
+                    tim['dofs'] = dofs
+                    tim['name'] = t[0]
+                    tim['time'] = t[1]
+                    tim['taskmanager'] = par
+                    tim['nthreads'] = ngsglobals.numthreads if par else 1
+                    timings["SpMV"].append(tim)
+
+
 orders = [1,2,4,8]
 mesh2 = Mesh(unit_square.GenerateMesh(maxh=3))
 mesh3 = Mesh(unit_cube.GenerateMesh(maxh=1))